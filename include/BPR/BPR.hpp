@@ -27,4 +27,31 @@
 #include "./csprng.hpp"
 #include "./prng.hpp"
 
+#include "./arrivals.hpp"
+#include "./bigint.hpp"
+#include "./bootstrap.hpp"
+#include "./brownian.hpp"
+#include "./ct.hpp"
+#include "./datagen.hpp"
+#include "./distributions.hpp"
+#include "./entropy.hpp"
+#include "./fill_file.hpp"
+#include "./graph.hpp"
+#include "./init.hpp"
+#include "./multilane.hpp"
+#include "./noise.hpp"
+#include "./parallel.hpp"
+#include "./permutation.hpp"
+#include "./projection.hpp"
+#include "./reproducible.hpp"
+#include "./resampling.hpp"
+#include "./rounding.hpp"
+#include "./sampling.hpp"
+#include "./sequence.hpp"
+#include "./simd.hpp"
+#include "./ssa.hpp"
+#include "./tabulation.hpp"
+#include "./views.hpp"
+#include "./walk.hpp"
+
 #endif // BPR_HPP
@@ -0,0 +1,314 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event 
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial 
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you 
+ *   wrote the original software. If you use this software in a product, an acknowledgment 
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_AESCTR_HPP
+#define BPR_AESCTR_HPP
+
+#include "engine.hpp"
+#include "utils.hpp"
+
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <array>
+
+namespace bpr { namespace csprng {
+
+/**
+ * @brief AES-CTR Cryptographically Secure Pseudo-Random Number Generator
+ * 
+ * @details
+ * A software-based CSPRNG implementation using AES in Counter Mode.
+ * Recommended for:
+ * - Applications requiring a widely standardized algorithm
+ * - Environments where AES is a compliance requirement
+ * 
+ * Key features:
+ * - 128-bit security strength
+ * - Based on the widely-studied AES block cipher
+ * - NIST standardized algorithm
+ * - Traditional S-box based design
+ * 
+ * Performance characteristics:
+ * - State size: 192 bytes (includes expanded key)
+ * - Initialization: Moderate (requires key schedule computation)
+ * - Code size: Larger (includes S-box and key expansion)
+ * - Generation speed: Good for a software AES implementation
+ * 
+ * @note Implementation characteristics:
+ * - Pure software implementation using traditional AES operations
+ * - Requires storing expanded key schedule
+ * - Uses lookup tables (S-box)
+ * 
+ * @example
+ * ```cpp
+ * std::random_device rd;
+ * AESCTR rng(rd);
+ * uint64_t random_number = rng.next();          // Generate a 64-bit random number
+ * auto block = rng.next128();                   // Generate 128 bits of random data
+ * ```
+ * 
+ * @see NIST SP 800-90A: Recommendation for Random Number Generation
+ */
+class AESCTR : public IEngine<uint8_t, 16>
+{
+public:
+    /**
+     * @brief Draws the counter and the key from `rd()`, e.g. a `std::random_device`.
+     */
+    template <typename SeedSource, std::enable_if_t<is_seed_source_v<SeedSource>, int> = 0>
+    explicit AESCTR(SeedSource& rd)
+        : IEngine({})
+    {
+        // Here we use 'm_state' as counter
+        // Initialize the counter with a random nonce
+        for (size_t i = 0; i < m_state.size(); i += sizeof(uint32_t)) {
+            uint32_t random = static_cast<uint32_t>(rd());
+            memcpy(&m_state[i], &random, sizeof(uint32_t));
+        }
+
+        // Generating a random key and expanding the key
+        key_expansion(generate_key(rd));
+    }
+
+    AESCTR(const std::array<uint8_t, 16>& key, const std::array<uint8_t, 16>& nonce) noexcept
+        : IEngine({})
+    {
+        // Here we use 'm_state' as counter
+        // Initializes the counter with a user-supplied nonce
+        std::memcpy(m_state.data(), nonce.data(), nonce.size());
+
+        // User-supplied key expansion
+        key_expansion(key);
+    }
+
+    uint64_t next() noexcept override {
+        // Calling the process_block function to fill the buffer with 16 bytes of data
+        std::array<uint8_t, 16> buffer;
+        process_block(buffer);
+        // Combines the 16 bytes of the buffer into two uint64_t (high and low)
+        uint64_t high = 0, low = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            // Assemble the first 8 bytes into a uint64_t for the 'high' part
+            high |= static_cast<uint64_t>(buffer[i]) << (i * 8);
+            // Assemble the next 8 bytes into a uint64_t for the 'low' part
+            low |= static_cast<uint64_t>(buffer[i + 8]) << (i * 8);
+        }
+        // XOR both uint64_t (high and low) to get a 64-bit random number
+        return high ^ low;
+    }
+
+    std::array<uint64_t, 2> next128() noexcept {
+        // Calling the process_block function to fill the buffer with 16 bytes of data
+        std::array<uint8_t, 16> buffer;
+        process_block(buffer);
+        // Copy the 16 bytes of the buffer into the two uint64_t of 'result'
+        std::array<uint64_t, 2> result;
+        memcpy(result.data(), buffer.data(), 2 * sizeof(uint64_t));
+        // Returns the array containing the two uint64_t
+        return result;
+    }
+
+    /**
+     * @brief Mixes fresh entropy into the key and recomputes the key schedule.
+     * 
+     * The 256 bits of entropy are folded to 128 bits and XORed into the current key.
+     * 
+     * @param entropy The entropy to mix, e.g. from `HardwareEntropy`.
+     */
+    void reseed(const std::array<uint64_t, 4>& entropy) noexcept {
+        std::array<uint8_t, 16> key;
+        std::memcpy(key.data(), m_expanded_key.data(), key.size());
+        for (size_t i = 0; i < 16; ++i) {
+            const uint64_t word = entropy[i / 8] ^ entropy[2 + i / 8];
+            key[i] ^= static_cast<uint8_t>(word >> (8 * (i % 8)));
+        }
+        key_expansion(key);
+        secure_zero(key.data(), key.size());
+    }
+
+private:
+    static constexpr size_t Nb = 4;  // Nombre de colonnes (32-bit words) dans l'état
+    static constexpr size_t Nk = 4;  // Nombre de mots de 32 bits dans la clé
+    static constexpr size_t Nr = 10; // Nombre de rounds
+
+    std::array<uint8_t, 176> m_expanded_key;
+
+    static constexpr uint8_t SBOX[256] =
+    {
+        0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+        0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+        0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+        0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+        0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+        0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+        0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+        0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+        0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+        0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+        0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+        0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+        0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+        0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+        0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+        0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+    };
+
+    template <typename SeedSource>
+    static std::array<uint8_t, 16> generate_key(SeedSource& rd) {
+        uint32_t words[4];
+        for (auto& word : words) {
+            word = static_cast<uint32_t>(rd());
+        }
+        std::array<uint8_t, 16> key;
+        for (int i = 0; i < 4; ++i) {
+            key[i * 4 + 0] = (words[i] >> 24) & 0xFF;
+            key[i * 4 + 1] = (words[i] >> 16) & 0xFF;
+            key[i * 4 + 2] = (words[i] >> 8)  & 0xFF;
+            key[i * 4 + 3] =  words[i]        & 0xFF;
+        }
+        return key;
+    }
+
+    void key_expansion(const std::array<uint8_t, 16>& key) noexcept {
+        // Copy of initial key
+        std::memcpy(m_expanded_key.data(), key.data(), key.size());
+        // Key expansion
+        for (size_t i = Nk; i < Nb * (Nr + 1); ++i) {
+            uint32_t temp = *reinterpret_cast<uint32_t*>(&m_expanded_key[4 * (i - 1)]);
+            if (i % Nk == 0) {
+                // Rotation and substitution
+                temp = ((temp << 8) | (temp >> 24));
+                uint8_t* temp_bytes = reinterpret_cast<uint8_t*>(&temp);
+                for (int j = 0; j < 4; ++j) {
+                    temp_bytes[j] = SBOX[temp_bytes[j]];
+                }
+                // XOR with the round constant
+                temp ^= (0x01 << ((i / Nk - 1) * 8));
+            }
+            *reinterpret_cast<uint32_t*>(&m_expanded_key[4 * i]) = 
+                *reinterpret_cast<uint32_t*>(&m_expanded_key[4 * (i - Nk)]) ^ temp;
+        }
+    }
+
+    /**
+     * @brief Increments the 128-bit counter used in the AES CTR mode.
+     * 
+     * This function is responsible for incrementing the counter that is part of the state used 
+     * in the AES Counter (CTR) mode. The counter is a 128-bit value (divided into four 32-bit 
+     * words), and it is incremented in a manner that mimics a carry operation, ensuring that 
+     * each counter value is unique and increasing monotonically.
+     * 
+     * The counter is incremented as follows:
+     * - The least significant 32-bit word (`counter[3]`) is incremented first.
+     * - If this word overflows (i.e., it reaches 0), the next word (`counter[2]`) is incremented.
+     * - The overflow propagation continues up to the most significant word (`counter[0]`).
+     * 
+     * This ensures that the counter rolls over properly, with the least significant part of the
+     * counter being incremented first, and the overflow propagating through the higher words if necessary.
+     * 
+     * The counter plays a critical role in ensuring that each AES block processed in CTR mode is unique, 
+     * which is crucial for generating non-repeating pseudo-random numbers.
+     * 
+     * @note This function modifies the `m_state` array, which is assumed to hold the current 128-bit counter 
+     *       value. It assumes that the state array is correctly initialized before calling this function.
+     * 
+     * @see process_block() for how the counter is used in generating pseudo-random numbers.
+     */
+    void increment_counter() noexcept {
+        // Interpret m_state as an array of 32-bit words to manipulate the counter parts
+        uint32_t* counter = reinterpret_cast<uint32_t*>(m_state.data());
+        
+        // Increment the least significant 32-bit word (counter[3])
+        if (++counter[3] == 0) {
+            // If counter[3] overflows, increment counter[2]
+            if (++counter[2] == 0) {
+                // If counter[2] overflows, increment counter[1]
+                if (++counter[1] == 0) {
+                    // If counter[1] overflows, increment counter[0]
+                    ++counter[0];
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Processes a 128-bit block using AES operations to generate a pseudo-random value.
+     * 
+     * This method applies AES transformations on a 128-bit block of state data in the context of 
+     * a Counter (CTR) mode generator. The state is XORed with an expanded AES key, and the 
+     * byte-wise transformations (`SubBytes` and `ShiftRows`) are applied. Notably, the `MixColumns` 
+     * step is omitted here because it is not required in the Counter mode for a random number generator.
+     * 
+     * The AES transformations are performed in the following order:
+     * - **AddRoundKey**: XOR the state with the expanded key.
+     * - **SubBytes**: Each byte in the state is substituted using the AES S-Box.
+     * - **ShiftRows**: The rows of the state matrix are shifted cyclically (AES-specific).
+     * - **AddRoundKey**: Another XOR operation with the expanded key.
+     * 
+     * After these operations, the counter is incremented to ensure the next block is unique.
+     * The `MixColumns` step is intentionally skipped in this function because it is not needed 
+     * for the CTR mode where we are simply generating pseudo-random numbers.
+     * 
+     * @param state The 128-bit block of state data to be processed. This data will be transformed 
+     *              in-place, with the processed result stored in the same array.
+     * 
+     * @note This method is designed specifically for Counter mode and should not be used for 
+     *       traditional AES encryption, where `MixColumns` is an essential part of the process.
+     */
+    void process_block(std::array<uint8_t, 16>& state) noexcept {
+        // Initial AddRoundKey: XOR the state with the first part of the expanded key
+        for (size_t i = 0; i < 16; ++i) {
+            state[i] ^= m_expanded_key[i];
+        }
+
+        // SubBytes: Permute each byte using the AES S-box
+        for (auto& byte : state) {
+            byte = SBOX[byte];
+        }
+
+        // ShiftRows: Perform the row shifts as defined in AES
+        std::array<uint8_t, 16> temp = state;
+        state[1] = temp[5];
+        state[5] = temp[9];
+        state[9] = temp[13];
+        state[13] = temp[1];
+        state[2] = temp[10];
+        state[6] = temp[14];
+        state[10] = temp[2];
+        state[14] = temp[6];
+        state[3] = temp[15];
+        state[7] = temp[3];
+        state[11] = temp[7];
+        state[15] = temp[11];
+
+        // AddRoundKey: XOR the state with the second part of the expanded key
+        for (size_t i = 0; i < 16; ++i) {
+            state[i] ^= m_expanded_key[16 + i];
+        }
+
+        // Increment the counter to ensure the next block is unique
+        increment_counter();
+    }
+};
+
+}} // namespace bpr::csprng
+
+#endif // BPR_AESCTR_HPP
@@ -0,0 +1,326 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_ARRIVALS_HPP
+#define BPR_ARRIVALS_HPP
+
+#include "distributions.hpp"
+#include "generator.hpp"
+#include "engine.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <cmath>
+
+namespace bpr {
+
+namespace detail {
+
+/**
+ * @brief Pending timestamps produced by one tile of a process and not yet delivered.
+ *
+ * Processes generate their candidates one tile at a time. The accepted timestamps are staged
+ * here, so that `fill()` can deliver any number of values per call while the generation itself
+ * always works on full tiles.
+ */
+class ArrivalBuffer
+{
+public:
+    static constexpr size_t TILE = DISTRIBUTION_TILE_WORDS;
+
+protected:
+    /**
+     * @brief Moves up to `capacity` pending timestamps to `out`, calling `refill()` as needed.
+     */
+    template <typename Refill>
+    size_t drain(double* out, size_t capacity, Refill&& refill) {
+        size_t written = 0;
+        while (written < capacity) {
+            if (m_begin == m_end) {
+                if (m_finished) break;
+                m_begin = m_end = 0;
+                refill();
+                continue;
+            }
+            const size_t n = std::min(capacity - written, m_end - m_begin);
+            std::copy(m_pending + m_begin, m_pending + m_begin + n, out + written);
+            m_begin += n;
+            written += n;
+        }
+        return written;
+    }
+
+    bool finished() const noexcept {
+        return m_finished && m_begin == m_end;
+    }
+
+protected:
+    double m_pending[TILE];
+    size_t m_begin = 0;
+    size_t m_end = 0;
+    bool m_finished = false;
+};
+
+} // namespace detail
+
+/**
+ * @class PoissonProcess
+ * @brief Arrival times of a homogeneous Poisson process of constant rate on [start, horizon).
+ *
+ * Gaps are generated one tile at a time with `fill_exponential()` and turned into timestamps by a
+ * running sum, so the cost per event is a logarithm and an addition, with no per-event engine call.
+ * Timestamps are streamed into caller buffers with `fill()`, which can be called repeatedly until
+ * it returns zero.
+ *
+ * @example
+ * ```cpp
+ * bpr::PoissonProcess<bpr::prng::Xoshiro256ss> arrivals(engine, 1e6, 60.0);    // 1M events/s for 60 s
+ * double batch[4096];
+ * while (size_t n = arrivals.fill(batch, 4096)) {
+ *     schedule(batch, n);
+ * }
+ * ```
+ */
+template <typename Engine>
+class PoissonProcess : public detail::ArrivalBuffer
+{
+public:
+    PoissonProcess(Engine& e, double rate, double horizon, double start = 0.0) noexcept
+        : m_engine(e), m_rate(rate), m_horizon(horizon), m_time(start)
+    {
+        m_finished = !(rate > 0.0) || start >= horizon;
+    }
+
+    /**
+     * @brief Writes up to `capacity` arrival times to `out` and returns how many were written.
+     *
+     * A return value smaller than `capacity` means that the horizon has been reached.
+     */
+    size_t fill(double* out, size_t capacity) {
+        return drain(out, capacity, [this] { refill(); });
+    }
+
+    bool done() const noexcept {
+        return finished();
+    }
+
+private:
+    void refill() {
+        fill_exponential(m_engine, m_pending, TILE, m_rate);
+        double t = m_time;
+        for (size_t i = 0; i < TILE; ++i) {
+            t += m_pending[i];
+            m_pending[i] = t;
+        }
+        // Keep the events before the horizon
+        m_end = static_cast<size_t>(std::lower_bound(m_pending, m_pending + TILE, m_horizon) - m_pending);
+        m_finished = m_end < TILE;
+        m_time = t;
+    }
+
+private:
+    Engine& m_engine;
+    double m_rate;
+    double m_horizon;
+    double m_time;
+};
+
+/**
+ * @class ThinnedPoissonProcess
+ * @brief Arrival times of a non-homogeneous Poisson process with a time-varying rate (Lewis-Shedler thinning).
+ *
+ * Candidates are drawn from a homogeneous process of rate `rate_max`, which must bound `rate_fn`
+ * on the whole interval, and each candidate at time t is kept with probability
+ * `rate_fn(t) / rate_max`. Both the candidate gaps and the acceptance uniforms are generated one
+ * tile at a time, the rate function is then evaluated and the accepted candidates compacted in a
+ * single loop without data-dependent branches.
+ *
+ * @tparam Engine The type of the random engine used to generate random values.
+ * @tparam RateFn Callable type invocable as `double rate_fn(double t)`.
+ */
+template <typename Engine, typename RateFn>
+class ThinnedPoissonProcess : public detail::ArrivalBuffer
+{
+public:
+    ThinnedPoissonProcess(Engine& e, RateFn rate_fn, double rate_max, double horizon, double start = 0.0)
+        : m_engine(e), m_rate_fn(std::move(rate_fn)), m_rate_max(rate_max), m_horizon(horizon), m_time(start)
+    {
+        m_finished = !(rate_max > 0.0) || start >= horizon;
+    }
+
+    size_t fill(double* out, size_t capacity) {
+        return drain(out, capacity, [this] { refill(); });
+    }
+
+    bool done() const noexcept {
+        return finished();
+    }
+
+private:
+    void refill() {
+        double candidates[TILE];
+        uint64_t accept[TILE];
+        fill_exponential(m_engine, candidates, TILE, m_rate_max);
+        ::bpr::fill(m_engine, accept, TILE);
+
+        double t = m_time;
+        for (size_t i = 0; i < TILE; ++i) {
+            t += candidates[i];
+            candidates[i] = t;
+        }
+        const size_t count = static_cast<size_t>(std::lower_bound(candidates, candidates + TILE, m_horizon) - candidates);
+
+        // Branchless compaction: always write, advance only when accepted
+        const double inv_max = 1.0 / m_rate_max;
+        size_t kept = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const double u = detail::unit_closed_open<double>(accept[i]);
+            m_pending[kept] = candidates[i];
+            kept += u < m_rate_fn(candidates[i]) * inv_max;
+        }
+
+        m_end = kept;
+        m_finished = count < TILE;
+        m_time = t;
+    }
+
+private:
+    Engine& m_engine;
+    RateFn m_rate_fn;
+    double m_rate_max;
+    double m_horizon;
+    double m_time;
+};
+
+/**
+ * @class HawkesProcess
+ * @brief Arrival times of a self-exciting Hawkes process with exponential kernel (Ogata thinning).
+ *
+ * The intensity is `mu + sum(alpha * exp(-beta * (t - t_i)))` over past events `t_i`: each event
+ * raises the intensity by `alpha`, which then decays at rate `beta`, producing bursts. The process
+ * is stationary when `alpha / beta < 1`, with a mean rate of `mu / (1 - alpha / beta)`.
+ *
+ * The excitation is updated recursively, so each candidate costs O(1). Candidates are inherently
+ * sequential, but their random inputs (one exponential and one uniform) are generated in tiles.
+ */
+template <typename Engine>
+class HawkesProcess : public detail::ArrivalBuffer
+{
+public:
+    HawkesProcess(Engine& e, double mu, double alpha, double beta, double horizon, double start = 0.0) noexcept
+        : m_engine(e), m_mu(mu), m_alpha(alpha), m_beta(beta), m_horizon(horizon), m_time(start)
+    {
+        m_finished = !(mu > 0.0) || start >= horizon;
+    }
+
+    size_t fill(double* out, size_t capacity) {
+        return drain(out, capacity, [this] { refill(); });
+    }
+
+    bool done() const noexcept {
+        return finished();
+    }
+
+private:
+    void refill() {
+        double gaps[TILE];
+        uint64_t accept[TILE];
+        fill_exponential(m_engine, gaps, TILE, 1.0);
+        ::bpr::fill(m_engine, accept, TILE);
+
+        size_t kept = 0;
+        for (size_t i = 0; i < TILE; ++i) {
+            // The intensity only decays until the next event, so its current value bounds it
+            const double bound = m_mu + m_excitation;
+            const double w = gaps[i] / bound;
+            m_time += w;
+            if (m_time >= m_horizon) {
+                m_finished = true;
+                break;
+            }
+            m_excitation *= std::exp(-m_beta * w);
+            if (detail::unit_closed_open<double>(accept[i]) * bound < m_mu + m_excitation) {
+                m_excitation += m_alpha;
+                m_pending[kept++] = m_time;
+            }
+        }
+        m_end = kept;
+    }
+
+private:
+    Engine& m_engine;
+    double m_mu;
+    double m_alpha;
+    double m_beta;
+    double m_horizon;
+    double m_time;
+    double m_excitation = 0.0;
+};
+
+namespace detail {
+
+/**
+ * @brief Appends every remaining arrival time of a process to `out`, one tile at a time.
+ */
+template <typename Process>
+size_t drain_into(Process& process, std::vector<double>& out)
+{
+    const size_t first = out.size();
+    for (;;) {
+        const size_t size = out.size();
+        out.resize(size + ArrivalBuffer::TILE);
+        const size_t n = process.fill(out.data() + size, ArrivalBuffer::TILE);
+        out.resize(size + n);
+        if (n < ArrivalBuffer::TILE) break;
+    }
+    return out.size() - first;
+}
+
+} // namespace detail
+
+/**
+ * @brief Appends the arrival times of a homogeneous Poisson process of rate `rate` on [0, horizon) to `out`.
+ *
+ * @return The number of arrival times appended.
+ */
+template <typename Engine>
+size_t arrival_times(Engine& e, double rate, double horizon, std::vector<double>& out)
+{
+    PoissonProcess<Engine> process(e, rate, horizon);
+    return detail::drain_into(process, out);
+}
+
+/**
+ * @brief Appends the arrival times of a Poisson process of intensity `rate_fn(t) <= rate_max` on [0, horizon) to `out`.
+ *
+ * @return The number of arrival times appended.
+ */
+template <typename Engine, typename RateFn>
+size_t arrival_times(Engine& e, RateFn rate_fn, double rate_max, double horizon, std::vector<double>& out)
+{
+    ThinnedPoissonProcess<Engine, RateFn> process(e, std::move(rate_fn), rate_max, horizon);
+    return detail::drain_into(process, out);
+}
+
+} // namespace bpr
+
+#endif // BPR_ARRIVALS_HPP
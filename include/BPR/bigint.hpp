@@ -0,0 +1,610 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_BIGINT_HPP
+#define BPR_BIGINT_HPP
+
+#include "generator.hpp"
+#include "engine.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#if defined(__SIZEOF_INT128__)
+
+namespace bpr {
+
+/**
+ * Random integers of arbitrary width, for key generation and number-theoretic code.
+ *
+ * Big integers are arrays of 64-bit limbs, least significant limb first. Their arithmetic
+ * (long division and Montgomery multiplication) relies on the 128-bit integers of the compiler,
+ * so this header is only available where `__SIZEOF_INT128__` is defined (GCC, Clang).
+ *
+ * The randomness of keys is that of the engine: use a CSPRNG (`bpr::csprng::ChaCha20`,
+ * `bpr::csprng::AESCTR`) for anything secret.
+ */
+
+namespace detail {
+
+using u128 = __uint128_t;
+
+inline size_t limbs_for_bits(size_t bits) noexcept
+{
+    return (bits + 63) / 64;
+}
+
+/**
+ * @brief Number of limbs of `x` once its leading zero limbs are dropped.
+ */
+inline size_t significant_limbs(const uint64_t* x, size_t n) noexcept
+{
+    while (n > 0 && x[n - 1] == 0) --n;
+    return n;
+}
+
+inline size_t bit_length(const uint64_t* x, size_t n) noexcept
+{
+    n = significant_limbs(x, n);
+    return n == 0 ? 0 : 64 * n - static_cast<size_t>(__builtin_clzll(x[n - 1]));
+}
+
+/**
+ * @brief Compares two numbers of `n` limbs, returning -1, 0 or 1.
+ */
+inline int compare_limbs(const uint64_t* a, const uint64_t* b, size_t n) noexcept
+{
+    for (size_t i = n; i-- > 0;) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief `x -= y` on `n` limbs, returning the borrow.
+ */
+inline uint64_t sub_limbs(uint64_t* x, const uint64_t* y, size_t n) noexcept
+{
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const u128 diff = static_cast<u128>(x[i]) - y[i] - borrow;
+        x[i] = static_cast<uint64_t>(diff);
+        borrow = static_cast<uint64_t>(diff >> 64) & 1;
+    }
+    return borrow;
+}
+
+/**
+ * @brief Remainder of a number of `m` limbs by a number of `n` limbs whose top limb is not zero.
+ *
+ * Knuth's algorithm D with 64-bit digits: each quotient digit is estimated from the top two
+ * limbs of the remainder and corrected at most twice. `scratch` holds `m + n + 1` limbs.
+ */
+inline void mod_limbs(const uint64_t* u, size_t m, const uint64_t* v, size_t n, uint64_t* r, uint64_t* scratch) noexcept
+{
+    if (m < n) {
+        std::copy(u, u + m, r);
+        std::fill(r + m, r + n, 0);
+        return;
+    }
+
+    if (n == 1) {
+        u128 rem = 0;
+        for (size_t i = m; i-- > 0;) {
+            rem = ((rem << 64) | u[i]) % v[0];
+        }
+        r[0] = static_cast<uint64_t>(rem);
+        return;
+    }
+
+    // Normalize so that the top limb of the divisor has its high bit set
+    const int shift = __builtin_clzll(v[n - 1]);
+    uint64_t* vn = scratch;
+    uint64_t* un = scratch + n;
+    for (size_t i = n - 1; i > 0; --i) {
+        vn[i] = shift ? (v[i] << shift) | (v[i - 1] >> (64 - shift)) : v[i];
+    }
+    vn[0] = v[0] << shift;
+    un[m] = shift ? u[m - 1] >> (64 - shift) : 0;
+    for (size_t i = m - 1; i > 0; --i) {
+        un[i] = shift ? (u[i] << shift) | (u[i - 1] >> (64 - shift)) : u[i];
+    }
+    un[0] = u[0] << shift;
+
+    constexpr u128 BASE = static_cast<u128>(1) << 64;
+    for (size_t j = m - n + 1; j-- > 0;) {
+        const u128 top = (static_cast<u128>(un[j + n]) << 64) | un[j + n - 1];
+        u128 qhat = top / vn[n - 1];
+        u128 rhat = top % vn[n - 1];
+        while (qhat >= BASE || qhat * vn[n - 2] > ((rhat << 64) | un[j + n - 2])) {
+            --qhat;
+            rhat += vn[n - 1];
+            if (rhat >= BASE) break;
+        }
+
+        // Multiply and subtract
+        uint64_t carry = 0, borrow = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const u128 product = qhat * vn[i] + carry;
+            carry = static_cast<uint64_t>(product >> 64);
+            const u128 diff = static_cast<u128>(un[i + j]) - static_cast<uint64_t>(product) - borrow;
+            un[i + j] = static_cast<uint64_t>(diff);
+            borrow = static_cast<uint64_t>(diff >> 64) & 1;
+        }
+        const u128 diff = static_cast<u128>(un[j + n]) - carry - borrow;
+        un[j + n] = static_cast<uint64_t>(diff);
+
+        // The estimate was one too large: add the divisor back
+        if (diff >> 64) {
+            uint64_t c = 0;
+            for (size_t i = 0; i < n; ++i) {
+                const u128 sum = static_cast<u128>(un[i + j]) + vn[i] + c;
+                un[i + j] = static_cast<uint64_t>(sum);
+                c = static_cast<uint64_t>(sum >> 64);
+            }
+            un[j + n] += c;
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        r[i] = shift ? (un[i] >> shift) | (un[i + 1] << (64 - shift)) : un[i];
+    }
+}
+
+/**
+ * @brief Scratch limbs on the stack for numbers up to 4096 bits, on the heap beyond.
+ */
+class LimbBuffer
+{
+public:
+    explicit LimbBuffer(size_t count)
+    {
+        if (count > STACK) m_heap.resize(count);
+        m_data = count > STACK ? m_heap.data() : m_stack;
+    }
+
+    uint64_t* data() noexcept {
+        return m_data;
+    }
+
+private:
+    static constexpr size_t STACK = 160;
+    uint64_t m_stack[STACK];
+    std::vector<uint64_t> m_heap;
+    uint64_t* m_data;
+};
+
+/**
+ * @brief Odd primes below 2^15, used to sieve the candidates of `random_prime()`.
+ */
+inline const std::vector<uint32_t>& sieve_primes()
+{
+    static const std::vector<uint32_t> primes = [] {
+        constexpr uint32_t LIMIT = 1u << 15;
+        std::vector<bool> composite(LIMIT, false);
+        std::vector<uint32_t> result;
+        for (uint32_t p = 3; p < LIMIT; p += 2) {
+            if (composite[p]) continue;
+            result.push_back(p);
+            for (uint32_t k = p * p; k < LIMIT; k += 2 * p) composite[k] = true;
+        }
+        return result;
+    }();
+    return primes;
+}
+
+/**
+ * @brief Remainder of a number of `n` limbs by a small divisor, 32 bits at a time.
+ */
+inline uint32_t mod_small(const uint64_t* x, size_t n, uint32_t p) noexcept
+{
+    uint64_t r = 0;
+    for (size_t i = n; i-- > 0;) {
+        r = ((r << 32) | (x[i] >> 32)) % p;
+        r = ((r << 32) | (x[i] & 0xFFFFFFFF)) % p;
+    }
+    return static_cast<uint32_t>(r);
+}
+
+/**
+ * @brief Montgomery arithmetic modulo an odd number of `n` limbs (CIOS multiplication).
+ *
+ * Numbers in Montgomery form are `x * R mod m` with `R = 2^(64n)`, so a product needs no
+ * division: `mul()` returns `a * b / R mod m`.
+ */
+class Montgomery
+{
+public:
+    Montgomery(const uint64_t* modulus, size_t n)
+        : m_n(n), m_modulus(modulus, modulus + n), m_one(n), m_r2(n), m_t(n + 1)
+    {
+        // -m^-1 mod 2^64 by Newton's iteration, each step doubles the number of correct bits
+        uint64_t inv = modulus[0];
+        for (int i = 0; i < 5; ++i) inv *= 2 - modulus[0] * inv;
+        m_inv = 0 - inv;
+
+        // R mod m and R^2 mod m by long division of 2^(64n) and 2^(128n)
+        std::vector<uint64_t> power(2 * n + 1, 0), scratch(4 * n + 2);
+        power[n] = 1;
+        mod_limbs(power.data(), n + 1, modulus, n, m_one.data(), scratch.data());
+        power[n] = 0;
+        power[2 * n] = 1;
+        mod_limbs(power.data(), 2 * n + 1, modulus, n, m_r2.data(), scratch.data());
+    }
+
+    size_t size() const noexcept {
+        return m_n;
+    }
+
+    /**
+     * @brief `out = a * b / R mod m`; `out` may alias `a` or `b`.
+     */
+    void mul(const uint64_t* a, const uint64_t* b, uint64_t* out) noexcept {
+        uint64_t* t = m_t.data();
+        multiply(a, b, m_modulus.data(), t, m_n, m_inv);
+        std::copy(t, t + m_n, out);
+    }
+
+    /**
+     * @brief Converts `x < m` to Montgomery form.
+     */
+    void to_montgomery(const uint64_t* x, uint64_t* out) noexcept {
+        mul(x, m_r2.data(), out);
+    }
+
+    /**
+     * @brief 1 in Montgomery form.
+     */
+    const uint64_t* one() const noexcept {
+        return m_one.data();
+    }
+
+    /**
+     * @brief `out = base^e` with `e` the bits [low_bit, high_bit) of `exponent`, in Montgomery form.
+     *
+     * Fixed windows of 4 bits: one multiplication by a precomputed power every 4 squarings.
+     */
+    void pow(const uint64_t* base, const uint64_t* exponent, size_t low_bit, size_t high_bit, uint64_t* out) {
+        constexpr size_t WINDOW = 4;
+        const size_t n = m_n;
+        m_table.resize(n << WINDOW);
+        std::copy(m_one.begin(), m_one.end(), m_table.begin());
+        for (size_t k = 1; k < (size_t(1) << WINDOW); ++k) {
+            mul(&m_table[(k - 1) * n], base, &m_table[k * n]);
+        }
+
+        std::copy(m_one.begin(), m_one.end(), out);
+        const size_t bits = high_bit - low_bit;
+        size_t position = (bits + WINDOW - 1) / WINDOW * WINDOW;
+        while (position > 0) {
+            position -= WINDOW;
+            uint32_t digit = 0;
+            for (size_t b = WINDOW; b-- > 0;) {
+                const size_t bit = position + b;
+                digit <<= 1;
+                if (bit < bits) {
+                    const size_t index = low_bit + bit;
+                    digit |= (exponent[index / 64] >> (index % 64)) & 1;
+                }
+            }
+            for (size_t s = 0; s < WINDOW; ++s) mul(out, out, out);
+            if (digit) mul(out, &m_table[digit * n], out);
+        }
+    }
+
+private:
+    /**
+     * @brief `t = a * b / R mod m` in the `n + 1` limbs of `t`, which aliases none of the inputs.
+     */
+    static void multiply(const uint64_t* __restrict a, const uint64_t* __restrict b, const uint64_t* __restrict m,
+                         uint64_t* __restrict t, size_t n, uint64_t inv) noexcept
+    {
+        std::fill(t, t + n + 1, 0);
+
+        for (size_t i = 0; i < n; ++i) {
+            // t = (t + a * b[i] + q * m) / 2^64, with q chosen to clear the low limb
+            const uint64_t bi = b[i];
+            u128 product = static_cast<u128>(a[0]) * bi + t[0];
+            uint64_t carry = static_cast<uint64_t>(product >> 64);
+            const uint64_t low = static_cast<uint64_t>(product);
+            const uint64_t q = low * inv;
+            u128 reduced = static_cast<u128>(q) * m[0] + low;
+            uint64_t reduce_carry = static_cast<uint64_t>(reduced >> 64);
+
+            for (size_t j = 1; j < n; ++j) {
+                product = static_cast<u128>(a[j]) * bi + t[j] + carry;
+                carry = static_cast<uint64_t>(product >> 64);
+                reduced = static_cast<u128>(q) * m[j] + static_cast<uint64_t>(product) + reduce_carry;
+                reduce_carry = static_cast<uint64_t>(reduced >> 64);
+                t[j - 1] = static_cast<uint64_t>(reduced);
+            }
+
+            const u128 top = static_cast<u128>(t[n]) + carry + reduce_carry;
+            t[n - 1] = static_cast<uint64_t>(top);
+            t[n] = static_cast<uint64_t>(top >> 64);
+        }
+
+        if (t[n] != 0 || compare_limbs(t, m, n) >= 0) {
+            sub_limbs(t, m, n);
+        }
+    }
+
+    size_t m_n;
+    uint64_t m_inv;
+    std::vector<uint64_t> m_modulus;
+    std::vector<uint64_t> m_one;
+    std::vector<uint64_t> m_r2;
+    std::vector<uint64_t> m_t;
+    std::vector<uint64_t> m_table;
+};
+
+/**
+ * @brief Miller-Rabin rounds giving an error probability below 2^-80 for a random candidate of `bits` bits.
+ *
+ * These are the bounds of Damgard, Landrock and Pomerance for numbers drawn at random, as used by
+ * OpenSSL; they do not hold for numbers chosen by an adversary.
+ */
+inline int miller_rabin_rounds(size_t bits) noexcept
+{
+    return bits >= 3747 ? 3 : bits >= 1345 ? 4 : bits >= 476 ? 5 : bits >= 400 ? 6 :
+           bits >= 347 ? 7 : bits >= 308 ? 8 : bits >= 55 ? 27 : 34;
+}
+
+/**
+ * @brief Miller-Rabin test of the odd number `x` of `n` significant limbs, larger than 2^15.
+ *
+ * The first witness is drawn alone, since most composites fail it; the witnesses of the other
+ * rounds are drawn together, with one bulk fill of the engine.
+ */
+template <typename Engine>
+bool miller_rabin(Engine& e, const uint64_t* x, size_t n, int rounds)
+{
+    Montgomery mont(x, n);
+    const size_t bits = bit_length(x, n);
+
+    // x - 1 = d * 2^s, with d odd: the exponent d is the bits [s, bits) of x - 1
+    std::vector<uint64_t> x_minus_1(x, x + n);
+    x_minus_1[0] -= 1;
+    size_t s = 0;
+    while (((x_minus_1[s / 64] >> (s % 64)) & 1) == 0) ++s;
+
+    // -1 in Montgomery form is m - R mod m
+    std::vector<uint64_t> minus_one(x, x + n);
+    sub_limbs(minus_one.data(), mont.one(), n);
+
+    std::vector<uint64_t> witnesses(n * static_cast<size_t>(rounds)), a(n), y(n);
+    for (int round = 0; round < rounds; ++round) {
+        uint64_t* w = &witnesses[n * static_cast<size_t>(round)];
+        if (round == 0) fill(e, w, n);
+        else if (round == 1) fill(e, w, n * static_cast<size_t>(rounds - 1));
+
+        // A witness in [2, x - 1): bits - 1 random bits, avoiding 0 and 1
+        const size_t top = (bits - 1) % 64;
+        const size_t limbs = limbs_for_bits(bits - 1);
+        std::fill(w + limbs, w + n, 0);
+        if (top) w[limbs - 1] &= (uint64_t(1) << top) - 1;
+        if (significant_limbs(w, n) <= 1 && w[0] < 2) w[0] = 2;
+
+        mont.to_montgomery(w, a.data());
+        mont.pow(a.data(), x_minus_1.data(), s, bits, y.data());
+        if (compare_limbs(y.data(), mont.one(), n) == 0 || compare_limbs(y.data(), minus_one.data(), n) == 0) {
+            continue;
+        }
+
+        bool witness_of_compositeness = true;
+        for (size_t k = 1; k < s; ++k) {
+            mont.mul(y.data(), y.data(), y.data());
+            if (compare_limbs(y.data(), minus_one.data(), n) == 0) {
+                witness_of_compositeness = false;
+                break;
+            }
+            if (compare_limbs(y.data(), mont.one(), n) == 0) break;
+        }
+        if (witness_of_compositeness) return false;
+    }
+    return true;
+}
+
+} // namespace detail
+
+/**
+ * @brief Fills `limbs` with `bits` random bits: `ceil(bits / 64)` limbs whose bits above `bits` are zero.
+ *
+ * The limbs are generated in one call to the bulk path of the engine.
+ *
+ * @param e The random engine.
+ * @param bits The number of random bits.
+ * @param limbs Receives the random number, least significant limb first.
+ */
+template <typename Engine>
+void random_bits(Engine& e, size_t bits, uint64_t* limbs) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+    const size_t n = detail::limbs_for_bits(bits);
+    if (n == 0) return;
+    fill(e, limbs, n);
+    if (bits % 64) {
+        limbs[n - 1] &= (uint64_t(1) << (bits % 64)) - 1;
+    }
+}
+
+/**
+ * @brief Generates an integer in [0, p) by reducing 128 random bits modulo p (wide reduction).
+ *
+ * The bias is below `p / 2^128`, far beyond what any test can detect, and unlike `bounded()` the
+ * function never loops, so its running time does not depend on the random values.
+ *
+ * @param e The random engine.
+ * @param p The modulus. Must be greater than zero.
+ */
+template <typename Engine>
+uint64_t uniform_mod(Engine& e, uint64_t p) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+    return static_cast<uint64_t>(rand<__uint128_t>(e) % p);
+}
+
+/**
+ * @brief Generates an integer in [0, p) for a modulus `p` of `n` limbs, by wide reduction.
+ *
+ * `n + 2` random limbs (at least 128 more bits than p) are reduced modulo p with one long
+ * division, so the bias is below 2^-128 and no candidate is ever rejected.
+ *
+ * @param e The random engine.
+ * @param p The modulus, least significant limb first. Must be greater than zero.
+ * @param n The number of limbs of p.
+ * @param out Receives the `n` limbs of the result.
+ */
+template <typename Engine>
+void uniform_mod(Engine& e, const uint64_t* p, size_t n, uint64_t* out)
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+    const size_t significant = detail::significant_limbs(p, n);
+    const size_t wide = significant + 2;
+    detail::LimbBuffer buffer(wide + (wide + significant + 1));
+    uint64_t* x = buffer.data();
+
+    fill(e, x, wide);
+    std::fill(out, out + n, 0);
+    detail::mod_limbs(x, wide, p, significant, out, x + wide);
+}
+
+/**
+ * @brief Tests whether the odd number `x` of `n` limbs is prime with the Miller-Rabin test.
+ *
+ * Numbers below 2^15 are tested exactly by trial division; the others are first divided by the
+ * small primes, then tested with `rounds` random witnesses. The default number of rounds gives an
+ * error probability below 2^-80 for numbers drawn at random; for numbers of unknown origin,
+ * which could be chosen to fool the test, use 64 rounds.
+ *
+ * @param e The random engine that draws the witnesses.
+ * @param x The number to test, least significant limb first.
+ * @param n The number of limbs of x.
+ * @param rounds The number of Miller-Rabin rounds, 0 to choose it from the size of x.
+ */
+template <typename Engine>
+bool is_probable_prime(Engine& e, const uint64_t* x, size_t n, int rounds = 0)
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+    n = detail::significant_limbs(x, n);
+    if (n == 0) return false;
+    if (n == 1 && x[0] < 4) return x[0] >= 2;
+    if ((x[0] & 1) == 0) return false;
+
+    const bool small = n == 1 && x[0] < (uint64_t(1) << 15);
+    for (uint32_t p : detail::sieve_primes()) {
+        if (small && uint64_t(p) * p > x[0]) return true;
+        if (detail::mod_small(x, n, p) == 0) return small && x[0] == p;
+    }
+
+    const size_t bits = detail::bit_length(x, n);
+    return detail::miller_rabin(e, x, n, rounds > 0 ? rounds : detail::miller_rabin_rounds(bits));
+}
+
+/**
+ * @brief Generates a random prime of exactly `bits` bits.
+ *
+ * A random odd base with its two top bits set is drawn (so the product of two such primes has
+ * exactly `2 * bits` bits), and the candidates `base + 2k` of a window are sieved at once by the
+ * odd primes below 2^15: each prime marks its multiples in the window from a single remainder of
+ * the base, which removes about 90% of the candidates without any big-number arithmetic. The
+ * survivors are tested in order with the Miller-Rabin test of `is_probable_prime()`.
+ *
+ * @param e The random engine; use a CSPRNG for keys.
+ * @param bits The size of the prime, at least 2.
+ * @param rounds The number of Miller-Rabin rounds, 0 to choose it from `bits`.
+ *
+ * @return The prime, least significant limb first, in `ceil(bits / 64)` limbs.
+ */
+template <typename Engine>
+std::vector<uint64_t> random_prime(Engine& e, size_t bits, int rounds = 0)
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+    const size_t n = detail::limbs_for_bits(bits);
+    std::vector<uint64_t> candidate(n);
+
+    // Small primes are found by trial division among the numbers of `bits` bits
+    if (bits < 16) {
+        for (;;) {
+            random_bits(e, bits, candidate.data());
+            candidate[0] |= uint64_t(1) << (bits - 1);
+            if (is_probable_prime(e, candidate.data(), n)) return candidate;
+        }
+    }
+
+    if (rounds <= 0) rounds = detail::miller_rabin_rounds(bits);
+
+    constexpr size_t WINDOW = 4096;
+    const std::vector<uint32_t>& primes = detail::sieve_primes();
+    std::vector<uint64_t> base(n);
+    std::vector<uint8_t> composite(WINDOW);
+
+    for (;;) {
+        random_bits(e, bits, base.data());
+        base[(bits - 1) / 64] |= uint64_t(1) << ((bits - 1) % 64);
+        base[(bits - 2) / 64] |= uint64_t(1) << ((bits - 2) % 64);
+        base[0] |= 1;
+
+        // base + 2k is divisible by p when k = -base / 2 mod p
+        std::fill(composite.begin(), composite.end(), 0);
+        for (uint32_t p : primes) {
+            const uint32_t r = detail::mod_small(base.data(), n, p);
+            const uint64_t half = (p + 1) / 2;
+            for (size_t k = static_cast<size_t>((p - r) % p * half % p); k < WINDOW; k += p) {
+                composite[k] = 1;
+            }
+        }
+
+        for (size_t k = 0; k < WINDOW; ++k) {
+            if (composite[k]) continue;
+
+            // candidate = base + 2k, which must keep `bits` bits
+            candidate = base;
+            uint64_t carry = 2 * k;
+            for (size_t i = 0; i < n && carry; ++i) {
+                candidate[i] += carry;
+                carry = candidate[i] < carry ? 1 : 0;
+            }
+            if (carry || detail::bit_length(candidate.data(), n) != bits) break;
+
+            if (detail::miller_rabin(e, candidate.data(), n, rounds)) {
+                return candidate;
+            }
+        }
+    }
+}
+
+} // namespace bpr
+
+#endif // defined(__SIZEOF_INT128__)
+
+#endif // BPR_BIGINT_HPP
@@ -0,0 +1,194 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_BOOTSTRAP_HPP
+#define BPR_BOOTSTRAP_HPP
+
+#include "generator.hpp"
+#include "parallel.hpp"
+#include "engine.hpp"
+#include "utils.hpp"
+#include "prng.hpp"
+
+#include <type_traits>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <array>
+
+namespace bpr {
+
+/**
+ * @brief Resampling scheme used by `bootstrap()` to produce the weights of each replicate.
+ */
+enum class BootstrapMethod
+{
+    Poisson,        ///< Independent Poisson(1) weight per row (the "Poisson bootstrap")
+    Multinomial     ///< Exact multinomial counts, i.e. the classic resampling of n rows with replacement
+};
+
+namespace detail {
+
+/**
+ * @brief Thresholds of the Poisson(1) cumulative distribution scaled to 32-bit integers.
+ *
+ * `POISSON1_CDF32[k]` is `floor(P(X <= k) * 2^32)`. The weight drawn from a uniform 32-bit value `u`
+ * is the number of thresholds that `u` reaches, which is computed without any branch. Values above
+ * 12 (probability below 1e-9) are truncated to 12.
+ */
+inline constexpr std::array<uint32_t, 12> POISSON1_CDF32
+{
+    0x5e2d58d8, 0xbc5ab1b1, 0xeb715e1d, 0xfb239797,
+    0xff1025f5, 0xffd90f3b, 0xfffa8b71, 0xffff540c,
+    0xffffed1f, 0xfffffe21, 0xffffffd4, 0xfffffffc
+};
+
+/**
+ * @brief Maps a uniform 32-bit value to a Poisson(1) distributed weight.
+ */
+constexpr uint32_t poisson1_from_bits(uint32_t u) noexcept
+{
+    uint32_t k = 0;
+    for (uint32_t threshold : POISSON1_CDF32) {
+        k += (u >= threshold);
+    }
+    return k;
+}
+
+/**
+ * @brief Fills `weights` with independent Poisson(1) weights.
+ *
+ * Random words are generated in tiles through the bulk path of the engine and each 64-bit
+ * word provides the weights of two rows.
+ */
+template <typename Engine>
+void poisson1_weights(Engine& e, uint32_t* weights, size_t n_rows) noexcept
+{
+    constexpr size_t TILE_WORDS = 512;
+    uint64_t tile[TILE_WORDS];
+
+    size_t row = 0;
+    while (row < n_rows) {
+        const size_t rows = std::min(n_rows - row, 2 * TILE_WORDS);
+        const size_t words = (rows + 1) / 2;
+        fill(e, tile, words);
+        // Low and high halves of each word give the weights of two consecutive rows
+        for (size_t i = 0; i < rows / 2; ++i) {
+            weights[row + 2 * i + 0] = poisson1_from_bits(static_cast<uint32_t>(tile[i]));
+            weights[row + 2 * i + 1] = poisson1_from_bits(static_cast<uint32_t>(tile[i] >> 32));
+        }
+        if (rows & 1) {
+            weights[row + rows - 1] = poisson1_from_bits(static_cast<uint32_t>(tile[words - 1]));
+        }
+        row += rows;
+    }
+}
+
+/**
+ * @brief Fills `counts` with the multinomial counts of `n_rows` draws with replacement among `n_rows` rows.
+ *
+ * Each draw uses the division-free `bounded()` reduction, then increments the count of the drawn row.
+ */
+template <typename Engine>
+void multinomial_weights(Engine& e, uint32_t* counts, size_t n_rows) noexcept
+{
+    std::fill(counts, counts + n_rows, 0u);
+    for (size_t i = 0; i < n_rows; ++i) {
+        ++counts[bounded(e, n_rows)];
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Runs a parallel, deterministic bootstrap over a dataset of `n_rows` rows.
+ *
+ * Instead of materializing resampled index vectors and gathering the data, each replicate is
+ * described by a vector of integer weights (how many times each row is present in the resample),
+ * and the statistic is evaluated as a weighted pass over the original data:
+ *
+ * - `BootstrapMethod::Poisson` draws an independent Poisson(1) weight per row. Two weights are
+ *   extracted from each 64-bit word with a branchless table lookup, which is far cheaper than one
+ *   bounded draw per row. The size of each resample is random (with mean `n_rows`), which is the
+ *   usual trade-off of the Poisson bootstrap.
+ * - `BootstrapMethod::Multinomial` produces the exact counts of the classic bootstrap.
+ *
+ * Replicate `r` always uses an engine seeded with `stream_seed(seed, r)`, so the results only
+ * depend on `seed`, never on the number of threads or the scheduling of the replicates.
+ * Each thread owns one weight buffer of `n_rows` entries which is reused between replicates.
+ *
+ * @tparam Engine The type of the random engine used for each replicate. It must be constructible from a 64-bit seed.
+ * @tparam Stat Callable type invocable as `stat(const uint32_t* weights, size_t n_rows)`.
+ *
+ * @param seed The master seed of the bootstrap.
+ * @param n_rows The number of rows of the dataset.
+ * @param n_reps The number of bootstrap replicates.
+ * @param stat The statistic to evaluate given the weights of one replicate. It is called concurrently from several threads.
+ * @param method The resampling scheme used to produce the weights.
+ * @param thread_count The number of threads to use, or zero to use every hardware thread.
+ *
+ * @return A vector containing the value of the statistic for each replicate, in replicate order.
+ *
+ * @example
+ * ```cpp
+ * std::vector<double> data = load();
+ * auto means = bpr::bootstrap(42, data.size(), 10000, [&](const uint32_t* w, size_t n) {
+ *     double sum = 0, total = 0;
+ *     for (size_t i = 0; i < n; ++i) { sum += w[i] * data[i]; total += w[i]; }
+ *     return sum / total;
+ * });
+ * ```
+ */
+template <typename Engine = prng::Xoshiro256ss, typename Stat>
+auto bootstrap(uint64_t seed, size_t n_rows, size_t n_reps, Stat&& stat,
+               BootstrapMethod method = BootstrapMethod::Poisson, unsigned thread_count = 0)
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+    using Result = std::decay_t<std::invoke_result_t<Stat&, const uint32_t*, size_t>>;
+
+    std::vector<Result> results(n_reps);
+    thread_count = thread_count_for(n_reps, thread_count);
+
+    // One weight buffer per thread, reused between the replicates handled by that thread
+    std::vector<std::vector<uint32_t>> weights(thread_count);
+
+    parallel_for(n_reps, [&](size_t rep, unsigned thread) {
+        std::vector<uint32_t>& w = weights[thread];
+        w.resize(n_rows);
+
+        // The stream of a replicate only depends on its index
+        Engine e(stream_seed(seed, rep));
+        if (method == BootstrapMethod::Poisson) {
+            detail::poisson1_weights(e, w.data(), n_rows);
+        } else {
+            detail::multinomial_weights(e, w.data(), n_rows);
+        }
+
+        results[rep] = stat(static_cast<const uint32_t*>(w.data()), n_rows);
+    }, thread_count);
+
+    return results;
+}
+
+} // namespace bpr
+
+#endif // BPR_BOOTSTRAP_HPP
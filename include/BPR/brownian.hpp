@@ -0,0 +1,305 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_BROWNIAN_HPP
+#define BPR_BROWNIAN_HPP
+
+#include "distributions.hpp"
+#include "engine.hpp"
+
+#include <type_traits>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include <cmath>
+
+namespace bpr {
+
+/**
+ * @brief Memory layout of a batch of paths written as a structure of arrays.
+ */
+enum class PathLayout
+{
+    PathMajor,  ///< `out[path * n_steps + step]`: the points of one path are contiguous
+    TimeMajor   ///< `out[step * n_paths + path]`: the points of one time step are contiguous
+};
+
+namespace detail {
+
+/**
+ * @brief Target size in bytes of the normal tiles used by the path generators (half of a typical L2).
+ */
+inline constexpr size_t PATH_TILE_BYTES = 128 * 1024;
+
+} // namespace detail
+
+/**
+ * @brief Generates `n_paths` standard Brownian motion paths of `n_steps` steps of length `dt`.
+ *
+ * For each path, the values `W(dt), W(2 dt), ..., W(n_steps dt)` are written (the starting point
+ * `W(0) = 0` is implicit). Increments are normal with variance `dt` and are produced with the bulk
+ * `fill_normal()` kernel in cache-sized tiles covering a block of paths, then accumulated.
+ *
+ * Path `p` always consumes the normals `[p * n_steps, (p + 1) * n_steps)` of the engine stream,
+ * so both layouts contain exactly the same paths for the same engine state.
+ *
+ * @tparam T The floating-point type of the path values.
+ * @tparam Engine The type of the random engine used to generate random values. It must be a class that implements a `next()` method.
+ *
+ * @param e The random engine used to generate random values.
+ * @param n_paths The number of paths to generate.
+ * @param n_steps The number of time steps of each path.
+ * @param dt The length of a time step.
+ * @param out Pointer to a buffer of `n_paths * n_steps` values that receives the paths.
+ * @param layout The memory layout of `out`.
+ */
+template <typename T, typename Engine>
+void brownian_paths(Engine& e, size_t n_paths, size_t n_steps, T dt, T* out,
+                    PathLayout layout = PathLayout::PathMajor)
+{
+    static_assert(std::is_floating_point_v<T>, "T must be a floating point");
+
+    if (n_paths == 0 || n_steps == 0) return;
+    const T sqrt_dt = std::sqrt(dt);
+
+    // Path-major output is written in stream order, the output itself is the tile
+    if (layout == PathLayout::PathMajor) {
+        for (size_t p = 0; p < n_paths; ++p) {
+            T* path = out + p * n_steps;
+            fill_normal(e, path, n_steps, T(0), sqrt_dt);
+            for (size_t s = 1; s < n_steps; ++s) {
+                path[s] += path[s - 1];
+            }
+        }
+        return;
+    }
+
+    // Time-major output: generate the increments of a block of paths into a tile,
+    // then write one contiguous run of the block per time step
+    const size_t block = std::clamp<size_t>(detail::PATH_TILE_BYTES / (n_steps * sizeof(T)), 1, n_paths);
+    std::vector<T> tile(block * n_steps);
+
+    for (size_t first = 0; first < n_paths; first += block) {
+        const size_t count = std::min(block, n_paths - first);
+        for (size_t p = 0; p < count; ++p) {
+            fill_normal(e, tile.data() + p * n_steps, n_steps, T(0), sqrt_dt);
+        }
+
+        T* row = out + first;
+        for (size_t p = 0; p < count; ++p) {
+            row[p] = tile[p * n_steps];
+        }
+        for (size_t s = 1; s < n_steps; ++s) {
+            const T* prev = row;
+            row += n_paths;
+            for (size_t p = 0; p < count; ++p) {
+                row[p] = prev[p] + tile[p * n_steps + s];
+            }
+        }
+    }
+}
+
+/**
+ * @class BrownianBridge
+ * @brief Builds Brownian motion paths from normals in Brownian bridge order.
+ *
+ * The first normal determines the terminal value of the path, the second one the midpoint
+ * conditioned on both ends, and so on by recursive bisection. This concentrates most of the path
+ * variance in the first few dimensions, which is what makes the construction effective with
+ * low-discrepancy (e.g. Sobol) points: feed the inverse-normal transform of each point directly
+ * to `build()`.
+ *
+ * The bridge works on any time grid. Indices, weights and conditional standard deviations are
+ * precomputed once by the constructor, so `build()` is a linear pass with no allocation.
+ *
+ * @tparam T The floating-point type of the path values.
+ *
+ * @example
+ * ```cpp
+ * bpr::BrownianBridge<double> bridge(252, 1.0 / 252);
+ * std::vector<double> z(252), path(252);
+ * bpr::fill_normal(engine, z.data(), z.size());    // or inverse-normal Sobol coordinates
+ * bridge.build(z.data(), path.data());
+ * ```
+ */
+template <typename T = double>
+class BrownianBridge
+{
+public:
+    static_assert(std::is_floating_point_v<T>, "T must be a floating point");
+
+    /**
+     * @brief Creates a bridge over the uniform grid `dt, 2 dt, ..., n_steps dt`.
+     */
+    BrownianBridge(size_t n_steps, T dt)
+        : BrownianBridge(uniform_grid(n_steps, dt))
+    { }
+
+    /**
+     * @brief Creates a bridge over an arbitrary increasing time grid (excluding the origin).
+     */
+    explicit BrownianBridge(const std::vector<T>& times)
+        : m_times(times)
+        , m_bridge_index(times.size())
+        , m_left_index(times.size())
+        , m_right_index(times.size())
+        , m_left_weight(times.size())
+        , m_right_weight(times.size())
+        , m_stddev(times.size())
+    {
+        const size_t n = m_times.size();
+        if (n == 0) return;
+
+        // map[i] is non-zero once point i has been constructed
+        std::vector<size_t> map(n, 0);
+        map[n - 1] = 1;
+
+        // The terminal point is drawn first, unconditionally
+        m_bridge_index[0] = n - 1;
+        m_stddev[0] = std::sqrt(m_times[n - 1]);
+
+        size_t j = 0;
+        for (size_t i = 1; i < n; ++i) {
+            // Find the next unpopulated interval [j, k]
+            while (map[j]) ++j;
+            size_t k = j;
+            while (!map[k]) ++k;
+
+            // Bisect it, the point l is conditioned on its neighbours j - 1 and k
+            const size_t l = j + ((k - 1 - j) >> 1);
+            map[l] = i;
+            m_bridge_index[i] = l;
+            m_left_index[i] = j;
+            m_right_index[i] = k;
+
+            const T t_left = j ? m_times[j - 1] : T(0);
+            const T span = m_times[k] - t_left;
+            m_left_weight[i] = (m_times[k] - m_times[l]) / span;
+            m_right_weight[i] = (m_times[l] - t_left) / span;
+            m_stddev[i] = std::sqrt((m_times[l] - t_left) * (m_times[k] - m_times[l]) / span);
+
+            j = k + 1;
+            if (j >= n) j = 0;
+        }
+    }
+
+    /**
+     * @brief Returns the number of points of the paths built by this bridge.
+     */
+    size_t size() const noexcept {
+        return m_times.size();
+    }
+
+    /**
+     * @brief Builds one path from `size()` standard normals given in bridge order.
+     *
+     * @param normals The standard normal variates, the first one sets the terminal value.
+     * @param path Receives `W(t_0), ..., W(t_{n-1})`.
+     */
+    void build(const T* normals, T* path) const noexcept {
+        const size_t n = m_times.size();
+        if (n == 0) return;
+
+        path[n - 1] = m_stddev[0] * normals[0];
+        for (size_t i = 1; i < n; ++i) {
+            const size_t j = m_left_index[i];
+            const size_t k = m_right_index[i];
+            const size_t l = m_bridge_index[i];
+            const T left = j ? path[j - 1] : T(0);
+            path[l] = m_left_weight[i] * left + m_right_weight[i] * path[k] + m_stddev[i] * normals[i];
+        }
+    }
+
+    /**
+     * @brief Builds a batch of paths from path-major normals.
+     *
+     * @param normals `n_paths * size()` standard normals, the normals of path `p` start at `p * size()`.
+     * @param n_paths The number of paths to build.
+     * @param out Receives the paths in the requested layout.
+     * @param layout The memory layout of `out`.
+     */
+    void build(const T* normals, size_t n_paths, T* out, PathLayout layout = PathLayout::PathMajor) const {
+        const size_t n = m_times.size();
+
+        if (layout == PathLayout::PathMajor) {
+            for (size_t p = 0; p < n_paths; ++p) {
+                build(normals + p * n, out + p * n);
+            }
+            return;
+        }
+
+        std::vector<T> path(n);
+        for (size_t p = 0; p < n_paths; ++p) {
+            build(normals + p * n, path.data());
+            for (size_t s = 0; s < n; ++s) {
+                out[s * n_paths + p] = path[s];
+            }
+        }
+    }
+
+    /**
+     * @brief Generates `n_paths` paths with the bridge, drawing the normals from the engine in tiles.
+     */
+    template <typename Engine>
+    void generate(Engine& e, size_t n_paths, T* out, PathLayout layout = PathLayout::PathMajor) const {
+        const size_t n = m_times.size();
+        if (n == 0) return;
+
+        const size_t block = std::clamp<size_t>(detail::PATH_TILE_BYTES / (n * sizeof(T)), 1, std::max<size_t>(n_paths, 1));
+        std::vector<T> tile(block * n);
+        std::vector<T> path(n);
+
+        for (size_t first = 0; first < n_paths; first += block) {
+            const size_t count = std::min(block, n_paths - first);
+            fill_normal(e, tile.data(), count * n);
+            if (layout == PathLayout::PathMajor) {
+                build(tile.data(), count, out + first * n, PathLayout::PathMajor);
+            } else {
+                for (size_t p = 0; p < count; ++p) {
+                    build(tile.data() + p * n, path.data());
+                    for (size_t s = 0; s < n; ++s) {
+                        out[s * n_paths + first + p] = path[s];
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    static std::vector<T> uniform_grid(size_t n_steps, T dt) {
+        std::vector<T> times(n_steps);
+        for (size_t i = 0; i < n_steps; ++i) {
+            times[i] = static_cast<T>(i + 1) * dt;
+        }
+        return times;
+    }
+
+private:
+    std::vector<T> m_times;
+    std::vector<size_t> m_bridge_index;
+    std::vector<size_t> m_left_index;
+    std::vector<size_t> m_right_index;
+    std::vector<T> m_left_weight;
+    std::vector<T> m_right_weight;
+    std::vector<T> m_stddev;
+};
+
+} // namespace bpr
+
+#endif // BPR_BROWNIAN_HPP
@@ -0,0 +1,364 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event 
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial 
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you 
+ *   wrote the original software. If you use this software in a product, an acknowledgment 
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_CHACHA20_HPP
+#define BPR_CHACHA20_HPP
+
+#include "engine.hpp"
+#include "utils.hpp"
+#include "simd.hpp"
+
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <array>
+
+namespace bpr { namespace csprng {
+
+/**
+ * @brief ChaCha20 Cryptographically Secure Pseudo-Random Number Generator
+ * 
+ * @details
+ * A high-performance CSPRNG based on the ChaCha20 stream cipher algorithm.
+ * Recommended for:
+ * - High-throughput applications requiring fast random number generation
+ * - Applications needing a simple, compact implementation
+ * - Cases where a modern, well-analyzed algorithm is preferred
+ * 
+ * Key features:
+ * - 256-bit security strength
+ * - Simple and compact implementation
+ * - No complex key schedule required
+ * - Designed for efficient software implementation
+ * - Based on simple 32-bit operations (addition, XOR, rotation)
+ * 
+ * Performance characteristics:
+ * - State size: 64 bytes
+ * - Initialization: Fast (no key schedule)
+ * - Code size: Compact (simpler operations)
+ * - Generation speed: Very good (optimized for software)
+ * 
+ * @example
+ * ```cpp
+ * std::random_device rd;
+ * ChaCha20 rng(rd);
+ * uint64_t random_number = rng.next();          // Generate a 64-bit random number
+ * auto block = rng.next512();                   // Generate 512 bits of random data
+ * ```
+ * 
+ * @see RFC 8439: ChaCha20 and Poly1305 for IETF Protocols
+ */
+class ChaCha20 : public IEngine<uint32_t, 16>
+{
+public:
+    /**
+     * @brief Draws the key and the nonce from `rd()`, e.g. a `std::random_device`.
+     * 
+     * Any object whose call operator returns an unsigned integer is accepted, which keeps
+     * `<random>` out of this header.
+     */
+    template <typename SeedSource, std::enable_if_t<is_seed_source_v<SeedSource>, int> = 0>
+    explicit ChaCha20(SeedSource& rd)
+        : IEngine({})
+    {
+        // Constants "expand 32-byte k"
+        for (int i = 0; i < 4; i++) {
+            m_state[i] = EXPAND_32_BYTE_K[i];
+        }
+        
+        // Key (use of seed)
+        // We divide the seed into 4 32-bit words
+        for (int i = 0; i < 2; ++i) {
+            m_state[4 + i*2] = static_cast<uint32_t>(rd());
+            m_state[5 + i*2] = static_cast<uint32_t>(rd());
+        }
+
+        // Counter (starts at 0)
+        m_state[12] = 0;
+        m_state[13] = 0;
+        
+        // Nonce (divided into 2 32-bit words)
+        m_state[14] = static_cast<uint32_t>(rd());
+        m_state[15] = static_cast<uint32_t>(rd());
+    }
+
+    ChaCha20(const std::array<uint32_t, 8>& key, const std::array<uint32_t, 2>& nonce) noexcept
+        : IEngine({})
+    {
+        // Constants "expand 32-byte k"
+        for (int i = 0; i < 4; i++) {
+            m_state[i] = EXPAND_32_BYTE_K[i];
+        }
+
+        // Key (using user-provided key)
+        for (int i = 0; i < 8; ++i) {
+            m_state[4 + i] = key[i];
+        }
+
+        // Counter (starts at 0)
+        m_state[12] = 0;
+        m_state[13] = 0;
+
+        // Nonce (using user-provided nonce)
+        m_state[14] = nonce[0];
+        m_state[15] = nonce[1];
+    }
+
+    ~ChaCha20() override {
+        // The state holds the key, do not leave it behind in memory
+        secure_zero(m_state.data(), sizeof(m_state));
+    }
+
+    uint64_t next() noexcept override {
+        std::array<uint32_t, 16> result = block();
+        uint64_t combined = 0;
+        for (size_t i = 0; i < 16; i += 2) {
+            combined ^= (static_cast<uint64_t>(result[i]) << 32) | result[i + 1];
+        }
+        return combined;
+    }
+
+    std::array<uint32_t, 16> next512() noexcept {
+        return block();
+    }
+
+    /**
+     * @brief Fills a buffer with raw keystream, several blocks at a time.
+     * 
+     * Unlike `next()`, which folds a whole block into a single 64-bit value, this bulk path
+     * returns the keystream itself: word `k` of a block is `block[2k] | (block[2k + 1] << 32)`
+     * and consecutive blocks follow each other, exactly as successive `next512()` calls would.
+     * The blocks are computed 4, 8 or 16 at a time by the SIMD backend selected by `bpr::simd`,
+     * which does not change the output. If `count` is not a multiple of 8, the unused words of
+     * the last block are discarded.
+     * 
+     * @param out Pointer to the buffer that receives the keystream.
+     * @param count The number of 64-bit words to generate.
+     */
+    void fill(uint64_t* out, size_t count) noexcept {
+        const size_t blocks = count / 8;
+        const uint64_t counter = (static_cast<uint64_t>(m_state[13]) << 32) | m_state[12];
+        simd::chacha20_blocks(m_state.data(), out, blocks);
+        seek(counter + blocks);
+
+        if (count % 8 != 0) {
+            const std::array<uint32_t, 16> words = block();
+            for (size_t k = 0, i = blocks * 8; i < count; ++k, ++i) {
+                out[i] = static_cast<uint64_t>(words[2 * k]) | (static_cast<uint64_t>(words[2 * k + 1]) << 32);
+            }
+        }
+    }
+
+    /**
+     * @brief Positions the generator at the given block of its keystream.
+     * 
+     * ChaCha20 is a counter-mode generator, so any part of its keystream can be produced
+     * directly. This allows several threads to generate disjoint parts of the same stream.
+     * 
+     * @param block The index of the next block to generate.
+     */
+    void seek(uint64_t block) noexcept {
+        m_state[12] = static_cast<uint32_t>(block);
+        m_state[13] = static_cast<uint32_t>(block >> 32);
+    }
+
+    /**
+     * @brief Mixes 256 bits of fresh entropy into the key, in place.
+     * 
+     * The entropy is XORed into the key, then the key is replaced by the first 32 bytes of the
+     * keystream of the mixed key. The new key is thus unpredictable as long as either the old key
+     * or the entropy is, and the old key cannot be recovered from it. The counter restarts at 0.
+     * 
+     * @param entropy The entropy to mix, e.g. from `HardwareEntropy`.
+     */
+    void reseed(const std::array<uint64_t, 4>& entropy) noexcept {
+        for (size_t i = 0; i < 4; ++i) {
+            m_state[4 + 2 * i] ^= static_cast<uint32_t>(entropy[i]);
+            m_state[5 + 2 * i] ^= static_cast<uint32_t>(entropy[i] >> 32);
+        }
+        seek(0);
+        std::array<uint32_t, 16> words = block();
+        std::memcpy(m_state.data() + 4, words.data(), 8 * sizeof(uint32_t));
+        secure_zero(words.data(), sizeof(words));
+        seek(0);
+    }
+
+private:
+    static constexpr std::array<uint32_t, 4> EXPAND_32_BYTE_K
+    {
+        0x61707865,
+        0x3320646e,
+        0x79622d32,
+        0x6b206574
+    };
+
+private:
+    static void quarter_round(uint32_t* a, uint32_t* b, uint32_t* c, uint32_t* d) noexcept {
+        *a += *b; *d ^= *a; *d = rotl(*d, 16);
+        *c += *d; *b ^= *c; *b = rotl(*b, 12);
+        *a += *b; *d ^= *a; *d = rotl(*d, 8);
+        *c += *d; *b ^= *c; *b = rotl(*b, 7);
+    }
+
+    void round(std::array<uint32_t, 16>& working_state) noexcept {
+        // Columns
+        quarter_round(&working_state[0], &working_state[4], &working_state[8], &working_state[12]);
+        quarter_round(&working_state[1], &working_state[5], &working_state[9], &working_state[13]);
+        quarter_round(&working_state[2], &working_state[6], &working_state[10], &working_state[14]);
+        quarter_round(&working_state[3], &working_state[7], &working_state[11], &working_state[15]);
+        // Diagonals
+        quarter_round(&working_state[0], &working_state[5], &working_state[10], &working_state[15]);
+        quarter_round(&working_state[1], &working_state[6], &working_state[11], &working_state[12]);
+        quarter_round(&working_state[2], &working_state[7], &working_state[8], &working_state[13]);
+        quarter_round(&working_state[3], &working_state[4], &working_state[9], &working_state[14]);
+    }
+
+    std::array<uint32_t, 16> block() noexcept {
+        std::array<uint32_t, 16> working_state = m_state;
+        // 20 rounds (10 double rounds)
+        for (int i = 0; i < 10; ++i) {
+            round(working_state);
+        }
+        // Final addition with initial state
+        for (auto i = 0; i < STATE_SIZE; ++i) {
+            working_state[i] += m_state[i];
+        }
+        // Counter increment
+        m_state[12]++;
+        if (m_state[12] == 0) m_state[13]++;
+        // Return the block
+        return working_state;
+    }
+};
+
+/**
+ * @brief ChaCha20 with fast key erasure, for long-lived generators holding secrets
+ * 
+ * @details
+ * The generator only keeps a 256-bit key. Each refill runs ChaCha20 with that key to produce a
+ * buffer of 16 blocks: the first 32 bytes immediately replace the key, the rest is served to the
+ * caller and erased as it is consumed. Neither the key nor the output already delivered can be
+ * recovered from the state, so compromising the process later does not reveal past output
+ * (forward secrecy).
+ * 
+ * Large `fill()` requests bypass the buffer: the key is renewed from the first block and the
+ * following blocks are generated directly into the destination.
+ * 
+ * @example
+ * ```cpp
+ * std::random_device rd;
+ * BufferedChaCha20 rng(rd);
+ * uint64_t token = rng.next();
+ * ```
+ * 
+ * @see D. J. Bernstein, "Fast-key-erasure random-number generators", 2017
+ */
+class BufferedChaCha20 : public IEngine<uint32_t, 8>
+{
+public:
+    static constexpr size_t BUFFER_WORDS = 128;     // 16 blocks, the first 4 words renew the key
+
+    /**
+     * @brief Draws the key from `rd()`, e.g. a `std::random_device`.
+     */
+    template <typename SeedSource, std::enable_if_t<is_seed_source_v<SeedSource>, int> = 0>
+    explicit BufferedChaCha20(SeedSource& rd)
+        : IEngine({})
+    {
+        for (auto& word : m_state) {
+            word = static_cast<uint32_t>(rd());
+        }
+    }
+
+    explicit BufferedChaCha20(const std::array<uint32_t, 8>& key) noexcept
+        : IEngine(std::array<uint32_t, 8>(key))
+    { }
+
+    ~BufferedChaCha20() override {
+        secure_zero(m_state.data(), sizeof(m_state));
+        secure_zero(m_buffer, sizeof(m_buffer));
+    }
+
+    uint64_t next() noexcept override {
+        if (m_position == BUFFER_WORDS) {
+            refill();
+        }
+        const uint64_t value = m_buffer[m_position];
+        m_buffer[m_position++] = 0;
+        return value;
+    }
+
+    /**
+     * @brief Fills a buffer with random words, erasing them from the generator.
+     */
+    void fill(uint64_t* out, size_t count) noexcept {
+        // Serve what is left in the buffer first
+        const size_t available = BUFFER_WORDS - m_position;
+        const size_t buffered = count < available ? count : available;
+        std::memcpy(out, m_buffer + m_position, buffered * sizeof(uint64_t));
+        secure_zero(m_buffer + m_position, buffered * sizeof(uint64_t));
+        m_position += buffered;
+        out += buffered;
+        count -= buffered;
+
+        if (count >= BUFFER_WORDS) {
+            ChaCha20 cipher(m_state, { 0, 0 });
+            uint64_t first[8];
+            cipher.fill(first, 8);
+            std::memcpy(m_state.data(), first, sizeof(m_state));
+            secure_zero(first, sizeof(first));
+            cipher.fill(out, count);
+            return;
+        }
+
+        while (count-- > 0) {
+            *out++ = next();
+        }
+    }
+
+    /**
+     * @brief Mixes 256 bits of fresh entropy into the key and discards the buffered output.
+     */
+    void reseed(const std::array<uint64_t, 4>& entropy) noexcept {
+        for (size_t i = 0; i < 4; ++i) {
+            m_state[2 * i] ^= static_cast<uint32_t>(entropy[i]);
+            m_state[2 * i + 1] ^= static_cast<uint32_t>(entropy[i] >> 32);
+        }
+        secure_zero(m_buffer, sizeof(m_buffer));
+        m_position = BUFFER_WORDS;
+    }
+
+private:
+    void refill() noexcept {
+        ChaCha20 cipher(m_state, { 0, 0 });
+        cipher.fill(m_buffer, BUFFER_WORDS);
+        std::memcpy(m_state.data(), m_buffer, sizeof(m_state));
+        secure_zero(m_buffer, sizeof(m_state));
+        m_position = sizeof(m_state) / sizeof(uint64_t);
+    }
+
+private:
+    uint64_t m_buffer[BUFFER_WORDS];
+    size_t m_position = BUFFER_WORDS;
+};
+
+}} // namespace bpr::csprng
+
+#endif // BPR_CHACHA20_HPP
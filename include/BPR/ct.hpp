@@ -0,0 +1,153 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_CT_HPP
+#define BPR_CT_HPP
+
+// Engines have a virtual destructor, which constant evaluation only accepts since C++20
+#if __cplusplus >= 202002L
+
+#include "generator.hpp"
+#include "engine.hpp"
+#include "prng.hpp"
+
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace bpr { namespace ct {
+
+namespace detail {
+
+/**
+ * @brief Holds an engine during constant evaluation without running its destructor.
+ *
+ * The engines only hold trivially destructible state, so skipping the destructor is harmless,
+ * and it avoids relying on implicitly defined virtual constexpr destructors, which some
+ * compilers do not evaluate correctly.
+ */
+template <typename Engine>
+union EngineHolder
+{
+    Engine engine;
+
+    constexpr explicit EngineHolder(uint64_t seed) noexcept
+        : engine(seed)
+    { }
+
+    constexpr ~EngineHolder() { }
+};
+
+} // namespace detail
+
+/**
+ * @brief Generates an array of N random values at compile time.
+ *
+ * The values are those that `bpr::rand<T>()` would return at runtime from `Engine(Seed)`, so a
+ * table can be produced at compile time and checked or extended at runtime. Assign the result to
+ * a `constexpr` variable to have it embedded in the read-only data of the program.
+ *
+ * @tparam T The integral or floating-point type of the values.
+ * @tparam N The number of values.
+ * @tparam Seed The seed of the engine.
+ * @tparam Engine The engine to use, one of the `constexpr` engines of prng.hpp.
+ *
+ * @example
+ * ```cpp
+ * // Zobrist keys: 12 pieces x 64 squares, no startup cost
+ * constexpr auto zobrist = bpr::ct::random_array<uint64_t, 12 * 64, 0x5EED>();
+ * ```
+ */
+template <typename T, size_t N, uint64_t Seed, typename Engine = prng::Xoshiro256ss>
+consteval std::array<T, N> random_array() noexcept
+{
+    detail::EngineHolder<Engine> holder(Seed);
+    std::array<T, N> values{};
+    for (auto& value : values) {
+        value = rand<T>(holder.engine);
+    }
+    return values;
+}
+
+/**
+ * @brief Generates an array of N random integers in [min, max] at compile time, without bias.
+ */
+template <typename T, size_t N, uint64_t Seed, typename Engine = prng::Xoshiro256ss>
+consteval std::array<T, N> random_array(T min, T max) noexcept
+{
+    static_assert(std::is_integral_v<T>, "T must be an integral type");
+    using U = std::make_unsigned_t<T>;
+
+    detail::EngineHolder<Engine> holder(Seed);
+    const uint64_t range = static_cast<uint64_t>(static_cast<U>(static_cast<U>(max) - static_cast<U>(min))) + 1;
+    std::array<T, N> values{};
+    for (auto& value : values) {
+        const uint64_t offset = range ? bounded(holder.engine, range) : holder.engine.next();
+        value = static_cast<T>(static_cast<U>(min) + static_cast<U>(offset));
+    }
+    return values;
+}
+
+/**
+ * @brief Shuffles an array at compile time (Fisher-Yates with unbiased bounded draws).
+ *
+ * @example
+ * ```cpp
+ * constexpr auto order = bpr::ct::shuffle<42>(std::array{ 'a', 'b', 'c', 'd' });
+ * ```
+ */
+template <uint64_t Seed, typename Engine = prng::Xoshiro256ss, typename T, size_t N>
+consteval std::array<T, N> shuffle(std::array<T, N> values) noexcept
+{
+    detail::EngineHolder<Engine> holder(Seed);
+    for (size_t i = N; i > 1; --i) {
+        const size_t j = static_cast<size_t>(bounded(holder.engine, i));
+        const T tmp = values[i - 1];
+        values[i - 1] = values[j];
+        values[j] = tmp;
+    }
+    return values;
+}
+
+/**
+ * @brief Generates a random permutation of [0, N) at compile time.
+ *
+ * @example
+ * ```cpp
+ * // Perlin noise permutation table
+ * constexpr auto perm = bpr::ct::permutation<256, 1234, uint8_t>();
+ * ```
+ */
+template <size_t N, uint64_t Seed, typename T = size_t, typename Engine = prng::Xoshiro256ss>
+consteval std::array<T, N> permutation() noexcept
+{
+    static_assert(std::is_integral_v<T>, "T must be an integral type");
+    std::array<T, N> values{};
+    for (size_t i = 0; i < N; ++i) {
+        values[i] = static_cast<T>(i);
+    }
+    return shuffle<Seed, Engine>(values);
+}
+
+}} // namespace bpr::ct
+
+#endif // __cplusplus >= 202002L
+
+#endif // BPR_CT_HPP
@@ -0,0 +1,613 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_DATAGEN_HPP
+#define BPR_DATAGEN_HPP
+
+#include "distributions.hpp"
+#include "permutation.hpp"
+#include "generator.hpp"
+#include "parallel.hpp"
+#include "sampling.hpp"
+#include "utils.hpp"
+#include "prng.hpp"
+
+#include <system_error>
+#include <stdexcept>
+#include <memory>
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <string_view>
+#include <string>
+#include <vector>
+#include <cerrno>
+
+namespace bpr { namespace datagen {
+
+/**
+ * @brief Storage type of a generated column.
+ */
+enum class ColumnType
+{
+    Int64,
+    Float64,
+    String
+};
+
+/**
+ * @brief Distribution of the values of a generated column.
+ */
+enum class ColumnKind
+{
+    UniformInt,     ///< Integers uniform in [min, max]                            (Int64)
+    UniformReal,    ///< Reals uniform in [a, b)                                   (Float64)
+    Normal,         ///< Normal reals of mean a and standard deviation b           (Float64)
+    Zipf,           ///< Zipf ranks in [1, domain] with exponent a                 (Int64)
+    Categorical,    ///< Category index drawn from weights, printed as its label   (Int64)
+    UniqueId,       ///< Distinct ids `min + perm(row)` with perm over [0, domain) (Int64)
+    String          ///< Strings over an alphabet with a uniform length            (String)
+};
+
+/**
+ * @brief Description of one column of a schema. Use the static factories to create columns.
+ */
+struct Column
+{
+    std::string name;
+    ColumnKind kind = ColumnKind::UniformInt;
+
+    int64_t min = 0;                    ///< UniformInt lower bound, UniqueId first id
+    int64_t max = 0;                    ///< UniformInt upper bound (inclusive)
+    uint64_t domain = 0;                ///< Zipf and UniqueId domain size
+    double a = 0.0;                     ///< UniformReal lower bound, Normal mean, Zipf exponent
+    double b = 1.0;                     ///< UniformReal upper bound, Normal standard deviation
+    std::vector<double> weights;        ///< Categorical weights
+    std::vector<std::string> labels;    ///< Categorical labels, one per weight; indices are written when empty
+    std::string alphabet;               ///< String alphabet
+    size_t min_length = 0;              ///< String minimum length
+    size_t max_length = 0;              ///< String maximum length (inclusive)
+
+    ColumnType type() const noexcept {
+        switch (kind) {
+            case ColumnKind::UniformReal:
+            case ColumnKind::Normal:
+                return ColumnType::Float64;
+            case ColumnKind::String:
+                return ColumnType::String;
+            default:
+                return ColumnType::Int64;
+        }
+    }
+
+    static Column uniform_int(std::string name, int64_t min, int64_t max) {
+        Column c; c.name = std::move(name); c.kind = ColumnKind::UniformInt;
+        c.min = min; c.max = max;
+        return c;
+    }
+
+    static Column uniform_real(std::string name, double min, double max) {
+        Column c; c.name = std::move(name); c.kind = ColumnKind::UniformReal;
+        c.a = min; c.b = max;
+        return c;
+    }
+
+    static Column normal(std::string name, double mean, double stddev) {
+        Column c; c.name = std::move(name); c.kind = ColumnKind::Normal;
+        c.a = mean; c.b = stddev;
+        return c;
+    }
+
+    static Column zipf(std::string name, uint64_t n, double exponent) {
+        Column c; c.name = std::move(name); c.kind = ColumnKind::Zipf;
+        c.domain = n; c.a = exponent;
+        return c;
+    }
+
+    static Column categorical(std::string name, std::vector<double> weights, std::vector<std::string> labels = {}) {
+        Column c; c.name = std::move(name); c.kind = ColumnKind::Categorical;
+        c.weights = std::move(weights); c.labels = std::move(labels);
+        return c;
+    }
+
+    /**
+     * @brief Unique ids in [first, first + domain). The domain must be at least the number of generated rows.
+     *
+     * The generator rejects an empty domain when it is constructed, and a table of more rows than
+     * the domain when it is generated, rather than repeating ids.
+     */
+    static Column unique_id(std::string name, uint64_t domain, int64_t first = 0) {
+        Column c; c.name = std::move(name); c.kind = ColumnKind::UniqueId;
+        c.domain = domain; c.min = first;
+        return c;
+    }
+
+    static Column string(std::string name, std::string alphabet, size_t min_length, size_t max_length) {
+        Column c; c.name = std::move(name); c.kind = ColumnKind::String;
+        c.alphabet = std::move(alphabet); c.min_length = min_length; c.max_length = max_length;
+        return c;
+    }
+};
+
+using Schema = std::vector<Column>;
+
+/**
+ * @brief Values of one column of a chunk. Only the buffers matching the column type are used.
+ *
+ * Strings are stored Arrow-style: the characters of row `i` are `chars[offsets[i], offsets[i + 1])`.
+ */
+struct ColumnData
+{
+    ColumnType type = ColumnType::Int64;
+    std::vector<int64_t> ints;
+    std::vector<double> reals;
+    std::vector<uint32_t> offsets;
+    std::string chars;
+};
+
+/**
+ * @brief A block of consecutive rows stored column by column.
+ */
+struct Chunk
+{
+    uint64_t index = 0;     ///< Index of the chunk
+    uint64_t first_row = 0; ///< Index of the first row of the chunk
+    size_t rows = 0;        ///< Number of rows of the chunk
+    std::vector<ColumnData> columns;
+};
+
+/**
+ * @brief File format written by `Generator::write()`.
+ *
+ * - `Binary`: for each chunk, the row count as a 64-bit integer, then each column in schema order:
+ *   `rows` 64-bit integers or doubles, or for strings `rows + 1` 32-bit offsets followed by the
+ *   characters. All values are native-endian.
+ * - `CSV`: a header line with the column names, then one line per row. Strings containing a
+ *   separator, a quote or a line break are quoted.
+ */
+enum class Format
+{
+    Binary,
+    CSV
+};
+
+/**
+ * @class Generator
+ * @brief Generates synthetic columnar data from a schema, in parallel and reproducibly.
+ *
+ * Rows are grouped in chunks of `rows_per_chunk` rows. Column `c` of chunk `k` draws from its own
+ * engine seeded with `stream_seed(stream_seed(seed, c), k)`, so any chunk can be generated on its
+ * own and the output only depends on the schema, the seed and the chunk size, never on the number
+ * of threads. Columns are filled with the bulk kernels of the library: tiles of engine words are
+ * generated through `fill()` then converted in tight loops.
+ *
+ * Writing to a file generates and serializes one chunk per thread at a time, then appends the
+ * serialized chunks in order with one large sequential write each.
+ *
+ * @tparam Engine The type of the random engine used for each column stream. It must be constructible from a 64-bit seed.
+ *
+ * @example
+ * ```cpp
+ * using namespace bpr::datagen;
+ * Generator<> gen({
+ *     Column::unique_id("id", 1000000000),
+ *     Column::zipf("product", 100000, 1.1),
+ *     Column::categorical("country", { 0.6, 0.3, 0.1 }, { "FR", "DE", "IT" }),
+ *     Column::normal("amount", 50.0, 10.0),
+ *     Column::string("comment", "abcdefghijklmnopqrstuvwxyz", 4, 16)
+ * }, 42);
+ * gen.write("orders.csv", 1000000000, Format::CSV);
+ * ```
+ */
+template <typename Engine = prng::Xoshiro256ss>
+class Generator
+{
+public:
+    /**
+     * @throws std::invalid_argument If a unique id column has an empty domain, or a categorical
+     * column has fewer labels than weights.
+     */
+    explicit Generator(Schema schema, uint64_t seed, size_t rows_per_chunk = 65536)
+        : m_schema(std::move(schema)), m_seed(seed), m_rows_per_chunk(std::max<size_t>(rows_per_chunk, 1))
+    {
+        m_prepared.reserve(m_schema.size());
+        for (size_t c = 0; c < m_schema.size(); ++c) {
+            const Column& column = m_schema[c];
+            if (column.kind == ColumnKind::UniqueId && column.domain == 0) {
+                throw std::invalid_argument("bpr::datagen: empty domain for unique id column " + column.name);
+            }
+            if (column.kind == ColumnKind::Categorical && !column.labels.empty() && column.labels.size() < column.weights.size()) {
+                throw std::invalid_argument("bpr::datagen: fewer labels than weights in categorical column " + column.name);
+            }
+            Prepared prepared{
+                AliasTable<uint32_t>(),
+                Zipf(column.kind == ColumnKind::Zipf ? column.domain : 1, column.a),
+                FeistelPermutation(column.kind == ColumnKind::UniqueId ? column.domain : 1, stream_seed(seed, ~uint64_t(c)))
+            };
+            if (column.kind == ColumnKind::Categorical) {
+                prepared.table = AliasTable<uint32_t>(column.weights);
+            }
+            m_prepared.push_back(std::move(prepared));
+        }
+    }
+
+    const Schema& schema() const noexcept {
+        return m_schema;
+    }
+
+    size_t rows_per_chunk() const noexcept {
+        return m_rows_per_chunk;
+    }
+
+    /**
+     * @brief Returns the number of chunks needed to generate `rows` rows.
+     */
+    uint64_t chunk_count(uint64_t rows) const noexcept {
+        return (rows + m_rows_per_chunk - 1) / m_rows_per_chunk;
+    }
+
+    /**
+     * @brief Generates chunk `index` of a table of `total_rows` rows into `out`, reusing its buffers.
+     *
+     * @throws std::invalid_argument If `total_rows` exceeds the domain of a unique id column.
+     */
+    void generate(uint64_t index, uint64_t total_rows, Chunk& out) const {
+        check_rows(total_rows);
+        out.index = index;
+        out.first_row = index * m_rows_per_chunk;
+        out.rows = out.first_row < total_rows
+            ? static_cast<size_t>(std::min<uint64_t>(m_rows_per_chunk, total_rows - out.first_row))
+            : 0;
+        out.columns.resize(m_schema.size());
+
+        for (size_t c = 0; c < m_schema.size(); ++c) {
+            Engine e(stream_seed(stream_seed(m_seed, c), index));
+            fill_column(e, c, out.first_row, out.rows, out.columns[c]);
+        }
+    }
+
+    /**
+     * @brief Generates a table of `rows` rows and passes each chunk, in order, to `sink(const Chunk&)`.
+     *
+     * Chunks are generated in parallel batches of one chunk per thread, the sink is called from the
+     * calling thread only.
+     *
+     * @throws std::invalid_argument If `rows` exceeds the domain of a unique id column.
+     */
+    template <typename Sink>
+    void generate(uint64_t rows, Sink&& sink, unsigned thread_count = 0) const {
+        check_rows(rows);
+        const uint64_t chunks = chunk_count(rows);
+        const unsigned batch = thread_count_for(static_cast<size_t>(chunks), thread_count);
+        std::vector<Chunk> slots(batch);
+
+        for (uint64_t first = 0; first < chunks; first += batch) {
+            const size_t count = static_cast<size_t>(std::min<uint64_t>(batch, chunks - first));
+            parallel_for(count, [&](size_t i, unsigned) {
+                generate(first + i, rows, slots[i]);
+            }, thread_count);
+            for (size_t i = 0; i < count; ++i) {
+                sink(static_cast<const Chunk&>(slots[i]));
+            }
+        }
+    }
+
+    /**
+     * @brief Generates a table of `rows` rows and writes it to a file.
+     *
+     * @return The number of bytes written.
+     *
+     * @throws std::invalid_argument If `rows` exceeds the domain of a unique id column.
+     * @throws std::system_error If the file cannot be created or written.
+     */
+    uint64_t write(const std::string& path, uint64_t rows, Format format, unsigned thread_count = 0) const {
+        check_rows(rows);
+        // Closed on every exit, including the exceptions of the generation threads
+        std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(std::fopen(path.c_str(), "wb"), &std::fclose);
+        if (!file) {
+            throw std::system_error(errno, std::generic_category(), "bpr: cannot create " + path);
+        }
+
+        uint64_t written = 0;
+        auto write_bytes = [&](const std::string& bytes) {
+            if (std::fwrite(bytes.data(), 1, bytes.size(), file.get()) != bytes.size()) {
+                const int error = errno;
+                throw std::system_error(error, std::generic_category(), "bpr: cannot write " + path);
+            }
+            written += bytes.size();
+        };
+
+        if (format == Format::CSV) {
+            std::string header;
+            for (size_t c = 0; c < m_schema.size(); ++c) {
+                if (c) header += ',';
+                append_field(header, m_schema[c].name);
+            }
+            header += '\n';
+            write_bytes(header);
+        }
+
+        // Generate and serialize one chunk per thread, then write the batch in order
+        const uint64_t chunks = chunk_count(rows);
+        const unsigned batch = thread_count_for(static_cast<size_t>(chunks), thread_count);
+        std::vector<Chunk> slots(batch);
+        std::vector<std::string> buffers(batch);
+
+        for (uint64_t first = 0; first < chunks; first += batch) {
+            const size_t count = static_cast<size_t>(std::min<uint64_t>(batch, chunks - first));
+            parallel_for(count, [&](size_t i, unsigned) {
+                generate(first + i, rows, slots[i]);
+                buffers[i].clear();
+                if (format == Format::CSV) {
+                    serialize_csv(slots[i], buffers[i]);
+                } else {
+                    serialize_binary(slots[i], buffers[i]);
+                }
+            }, thread_count);
+            for (size_t i = 0; i < count; ++i) {
+                write_bytes(buffers[i]);
+            }
+        }
+
+        // Buffered data is written by fclose, which can fail too
+        if (std::fclose(file.release()) != 0) {
+            const int error = errno;
+            throw std::system_error(error, std::generic_category(), "bpr: cannot write " + path);
+        }
+        return written;
+    }
+
+    /**
+     * @brief Appends the binary representation of a chunk to `out` (see `Format::Binary`).
+     */
+    void serialize_binary(const Chunk& chunk, std::string& out) const {
+        const uint64_t rows = chunk.rows;
+        append_raw(out, &rows, sizeof(rows));
+        for (const ColumnData& data : chunk.columns) {
+            switch (data.type) {
+                case ColumnType::Int64:
+                    append_raw(out, data.ints.data(), chunk.rows * sizeof(int64_t));
+                    break;
+                case ColumnType::Float64:
+                    append_raw(out, data.reals.data(), chunk.rows * sizeof(double));
+                    break;
+                case ColumnType::String:
+                    append_raw(out, data.offsets.data(), (chunk.rows + 1) * sizeof(uint32_t));
+                    out += data.chars;
+                    break;
+            }
+        }
+    }
+
+    /**
+     * @brief Appends the CSV lines of a chunk to `out` (see `Format::CSV`).
+     */
+    void serialize_csv(const Chunk& chunk, std::string& out) const {
+        char number[32];
+        for (size_t r = 0; r < chunk.rows; ++r) {
+            for (size_t c = 0; c < m_schema.size(); ++c) {
+                if (c) out += ',';
+                const Column& column = m_schema[c];
+                const ColumnData& data = chunk.columns[c];
+                switch (data.type) {
+                    case ColumnType::Int64: {
+                        const int64_t value = data.ints[r];
+                        if (column.kind == ColumnKind::Categorical && !column.labels.empty()) {
+                            append_field(out, column.labels[static_cast<size_t>(value)]);
+                        } else {
+                            const auto result = std::to_chars(number, number + sizeof(number), value);
+                            out.append(number, result.ptr);
+                        }
+                        break;
+                    }
+                    case ColumnType::Float64: {
+                        const auto result = std::to_chars(number, number + sizeof(number), data.reals[r]);
+                        out.append(number, result.ptr);
+                        break;
+                    }
+                    case ColumnType::String:
+                        append_field(out, std::string_view(data.chars).substr(
+                            data.offsets[r], data.offsets[r + 1] - data.offsets[r]));
+                        break;
+                }
+            }
+            out += '\n';
+        }
+    }
+
+private:
+    struct Prepared
+    {
+        AliasTable<uint32_t> table;
+        Zipf zipf;
+        FeistelPermutation permutation;
+    };
+
+    static constexpr size_t TILE = detail::DISTRIBUTION_TILE_WORDS;
+
+    /**
+     * @brief Rejects a table too large for the ids of a unique id column to be distinct.
+     */
+    void check_rows(uint64_t rows) const {
+        for (const Column& column : m_schema) {
+            if (column.kind == ColumnKind::UniqueId && rows > column.domain) {
+                throw std::invalid_argument("bpr::datagen: more rows than ids in unique id column " + column.name);
+            }
+        }
+    }
+
+    void fill_column(Engine& e, size_t c, uint64_t first_row, size_t rows, ColumnData& data) const {
+        const Column& column = m_schema[c];
+        const Prepared& prepared = m_prepared[c];
+        data.type = column.type();
+        uint64_t tile[TILE];
+
+        switch (column.kind) {
+            case ColumnKind::UniformInt: {
+                data.ints.resize(rows);
+                const uint64_t range = static_cast<uint64_t>(column.max) - static_cast<uint64_t>(column.min) + 1;
+                for_each_tile(e, tile, rows, [&](size_t row, size_t count) {
+                    for (size_t i = 0; i < count; ++i) {
+                        // A range of zero means the full 64-bit range
+                        const uint64_t offset = range ? bounded_from(e, tile[i], range) : tile[i];
+                        data.ints[row + i] = static_cast<int64_t>(static_cast<uint64_t>(column.min) + offset);
+                    }
+                });
+                break;
+            }
+            case ColumnKind::UniformReal: {
+                data.reals.resize(rows);
+                const double span = column.b - column.a;
+                for_each_tile(e, tile, rows, [&](size_t row, size_t count) {
+                    for (size_t i = 0; i < count; ++i) {
+                        data.reals[row + i] = column.a + span * detail::unit_closed_open<double>(tile[i]);
+                    }
+                });
+                break;
+            }
+            case ColumnKind::Normal: {
+                data.reals.resize(rows);
+                fill_normal(e, data.reals.data(), rows, column.a, column.b);
+                break;
+            }
+            case ColumnKind::Zipf: {
+                data.ints.resize(rows);
+                for (size_t i = 0; i < rows; ++i) {
+                    data.ints[i] = static_cast<int64_t>(prepared.zipf(e));
+                }
+                break;
+            }
+            case ColumnKind::Categorical: {
+                data.ints.resize(rows);
+                if (prepared.table.size() == 0) {
+                    std::fill(data.ints.begin(), data.ints.end(), 0);
+                    break;
+                }
+                for_each_tile(e, tile, rows, [&](size_t row, size_t count) {
+                    for (size_t i = 0; i < count; ++i) {
+                        data.ints[row + i] = static_cast<int64_t>(prepared.table.sample(tile[i]));
+                    }
+                });
+                break;
+            }
+            case ColumnKind::UniqueId: {
+                // No randomness is drawn: the permutation maps row indices to distinct ids
+                data.ints.resize(rows);
+                for (size_t i = 0; i < rows; ++i) {
+                    data.ints[i] = static_cast<int64_t>(static_cast<uint64_t>(column.min) + prepared.permutation(first_row + i));
+                }
+                break;
+            }
+            case ColumnKind::String: {
+                fill_strings(e, column, rows, data);
+                break;
+            }
+        }
+    }
+
+    void fill_strings(Engine& e, const Column& column, size_t rows, ColumnData& data) const {
+        data.offsets.resize(rows + 1);
+        data.chars.clear();
+
+        const size_t min_length = column.min_length;
+        const size_t max_length = std::max(column.min_length, column.max_length);
+        const uint64_t alphabet_size = column.alphabet.size();
+        uint64_t tile[TILE];
+
+        // Lengths first, so that the character buffer is allocated once
+        data.offsets[0] = 0;
+        for_each_tile(e, tile, rows, [&](size_t row, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                const size_t length = min_length + static_cast<size_t>(bounded_from(e, tile[i], max_length - min_length + 1));
+                data.offsets[row + i + 1] = data.offsets[row + i] + static_cast<uint32_t>(length);
+            }
+        });
+        data.chars.resize(data.offsets[rows]);
+        if (alphabet_size == 0) {
+            std::fill(data.chars.begin(), data.chars.end(), ' ');
+            return;
+        }
+
+        // Two characters per word, each from a 32-bit multiply-shift reduction
+        const size_t total = data.chars.size();
+        for_each_tile(e, tile, (total + 1) / 2, [&](size_t word, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                const size_t pos = 2 * (word + i);
+                const uint64_t lo = tile[i] & 0xFFFFFFFF, hi = tile[i] >> 32;
+                data.chars[pos] = column.alphabet[static_cast<size_t>((lo * alphabet_size) >> 32)];
+                if (pos + 1 < total) {
+                    data.chars[pos + 1] = column.alphabet[static_cast<size_t>((hi * alphabet_size) >> 32)];
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Fills the tile with engine words for each block of at most TILE items and calls `body(first, count)`.
+     */
+    template <typename Body>
+    static void for_each_tile(Engine& e, uint64_t* tile, size_t items, Body&& body) {
+        for (size_t first = 0; first < items; first += TILE) {
+            const size_t count = std::min(TILE, items - first);
+            fill(e, tile, count);
+            body(first, count);
+        }
+    }
+
+    /**
+     * @brief Lemire's reduction of a pre-generated word, falling back to `bounded()` on rejection.
+     */
+    static uint64_t bounded_from(Engine& e, uint64_t word, uint64_t range) noexcept {
+        uint64_t lo = 0;
+        const uint64_t hi = mul128(word, range, lo);
+        if (lo < range && lo < (0 - range) % range) {
+            return bounded(e, range);
+        }
+        return hi;
+    }
+
+    static void append_raw(std::string& out, const void* data, size_t size) {
+        out.append(static_cast<const char*>(data), size);
+    }
+
+    static void append_field(std::string& out, std::string_view field) {
+        if (field.find_first_of(",\"\n\r") == std::string_view::npos) {
+            out += field;
+            return;
+        }
+        out += '"';
+        for (char c : field) {
+            if (c == '"') out += '"';
+            out += c;
+        }
+        out += '"';
+    }
+
+private:
+    Schema m_schema;
+    uint64_t m_seed;
+    size_t m_rows_per_chunk;
+    std::vector<Prepared> m_prepared;
+};
+
+}} // namespace bpr::datagen
+
+#endif // BPR_DATAGEN_HPP
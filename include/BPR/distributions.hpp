@@ -0,0 +1,357 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_DISTRIBUTIONS_HPP
+#define BPR_DISTRIBUTIONS_HPP
+
+#include "generator.hpp"
+#include "engine.hpp"
+#include "utils.hpp"
+
+#include <type_traits>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+namespace bpr {
+
+namespace detail {
+
+/**
+ * @brief Converts a random 64-bit word to a floating-point value in the open interval (0, 1).
+ *
+ * The 53 high bits of the word are centered in their interval, so the result is never exactly 0
+ * or 1 and can be safely passed to `log()`.
+ */
+template <typename T>
+constexpr T unit_open(uint64_t bits) noexcept
+{
+    // 2^-53, the spacing of doubles in [0.5, 1)
+    constexpr double inv_2_53 = 1.0 / 9007199254740992.0;
+    return static_cast<T>((static_cast<double>(bits >> 11) + 0.5) * inv_2_53);
+}
+
+/**
+ * @brief Converts a random 64-bit word to a floating-point value in the half-open interval [0, 1).
+ */
+template <typename T>
+constexpr T unit_closed_open(uint64_t bits) noexcept
+{
+    constexpr double inv_2_53 = 1.0 / 9007199254740992.0;
+    return static_cast<T>(static_cast<double>(bits >> 11) * inv_2_53);
+}
+
+/**
+ * @brief Number of 64-bit words generated per tile by the bulk distribution kernels.
+ *
+ * 256 words (2 KiB) keep the random tile and the output chunk it produces well within L1.
+ */
+inline constexpr size_t DISTRIBUTION_TILE_WORDS = 256;
+
+} // namespace detail
+
+/**
+ * @brief Generates a normally distributed value using the provided random engine.
+ *
+ * This function uses the Marsaglia polar method, which needs no trigonometric function and
+ * accepts about 78.5% of the candidate points. To generate many values at once, prefer
+ * `fill_normal()` which amortizes the engine calls and transcendental functions over a tile.
+ *
+ * @tparam T The floating-point type of the value to generate.
+ * @tparam Engine The type of the random engine used to generate random values. It must be a class that implements a `next()` method.
+ *
+ * @param e The random engine used to generate random values.
+ * @param mean The mean of the distribution.
+ * @param stddev The standard deviation of the distribution.
+ *
+ * @return A normally distributed value of type T.
+ */
+template <typename T = double, typename Engine>
+T normal(Engine& e, T mean = T(0), T stddev = T(1)) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+    static_assert(std::is_floating_point_v<T>, "T must be a floating point");
+
+    double u, v, s;
+    do {
+        u = 2.0 * detail::unit_open<double>(e.next()) - 1.0;
+        v = 2.0 * detail::unit_open<double>(e.next()) - 1.0;
+        s = u * u + v * v;
+    } while (s >= 1.0);
+
+    return mean + stddev * static_cast<T>(u * std::sqrt(-2.0 * std::log(s) / s));
+}
+
+/**
+ * @brief Fills a buffer with normally distributed values using the provided random engine.
+ *
+ * Random words are generated in L1-sized tiles through the bulk path of the engine (see `fill()`),
+ * then converted pairwise with the Box-Muller transform. The conversion loop has no branch and no
+ * rejection, so its cost per value is constant and it can be vectorized by the compiler.
+ *
+ * @tparam T The floating-point type of the values to generate.
+ * @tparam Engine The type of the random engine used to generate random values. It must be a class that implements a `next()` method.
+ *
+ * @param e The random engine used to generate random values.
+ * @param out Pointer to the buffer that receives the values.
+ * @param count The number of values to generate.
+ * @param mean The mean of the distribution.
+ * @param stddev The standard deviation of the distribution.
+ */
+template <typename T, typename Engine>
+void fill_normal(Engine& e, T* out, size_t count, T mean = T(0), T stddev = T(1)) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+    static_assert(std::is_floating_point_v<T>, "T must be a floating point");
+
+    constexpr double two_pi = 6.283185307179586476925286766559;
+    constexpr size_t TILE = detail::DISTRIBUTION_TILE_WORDS;
+    uint64_t tile[TILE];
+
+    size_t i = 0;
+    while (i < count) {
+        // Each pair of words gives two values, an odd remainder is handled by a full pair
+        const size_t n = std::min(count - i, TILE);
+        const size_t pairs = (n + 1) / 2;
+        fill(e, tile, 2 * pairs);
+
+        for (size_t p = 0; p < n / 2; ++p) {
+            const double r = std::sqrt(-2.0 * std::log(detail::unit_open<double>(tile[2 * p])));
+            const double theta = two_pi * detail::unit_closed_open<double>(tile[2 * p + 1]);
+            out[i + 2 * p + 0] = mean + stddev * static_cast<T>(r * std::cos(theta));
+            out[i + 2 * p + 1] = mean + stddev * static_cast<T>(r * std::sin(theta));
+        }
+
+        if (n & 1) {
+            const double r = std::sqrt(-2.0 * std::log(detail::unit_open<double>(tile[n - 1])));
+            const double theta = two_pi * detail::unit_closed_open<double>(tile[n]);
+            out[i + n - 1] = mean + stddev * static_cast<T>(r * std::cos(theta));
+        }
+
+        i += n;
+    }
+}
+
+/**
+ * @brief Generates an exponentially distributed value using the provided random engine.
+ *
+ * @tparam T The floating-point type of the value to generate.
+ * @tparam Engine The type of the random engine used to generate random values. It must be a class that implements a `next()` method.
+ *
+ * @param e The random engine used to generate random values.
+ * @param rate The rate (inverse of the mean) of the distribution.
+ *
+ * @return An exponentially distributed value of type T.
+ */
+template <typename T = double, typename Engine>
+T exponential(Engine& e, T rate = T(1)) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+    static_assert(std::is_floating_point_v<T>, "T must be a floating point");
+
+    return static_cast<T>(-std::log(detail::unit_open<double>(e.next()))) / rate;
+}
+
+/**
+ * @brief Fills a buffer with exponentially distributed values using the provided random engine.
+ *
+ * Random words are generated in L1-sized tiles through the bulk path of the engine, then
+ * converted by inversion (`-log(u) / rate`) in a loop without branches.
+ *
+ * @tparam T The floating-point type of the values to generate.
+ * @tparam Engine The type of the random engine used to generate random values. It must be a class that implements a `next()` method.
+ *
+ * @param e The random engine used to generate random values.
+ * @param out Pointer to the buffer that receives the values.
+ * @param count The number of values to generate.
+ * @param rate The rate (inverse of the mean) of the distribution.
+ */
+template <typename T, typename Engine>
+void fill_exponential(Engine& e, T* out, size_t count, T rate = T(1)) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+    static_assert(std::is_floating_point_v<T>, "T must be a floating point");
+
+    constexpr size_t TILE = detail::DISTRIBUTION_TILE_WORDS;
+    uint64_t tile[TILE];
+    const double inv_rate = 1.0 / static_cast<double>(rate);
+
+    for (size_t i = 0; i < count; i += TILE) {
+        const size_t n = std::min(count - i, TILE);
+        fill(e, tile, n);
+        for (size_t j = 0; j < n; ++j) {
+            out[i + j] = static_cast<T>(-std::log(detail::unit_open<double>(tile[j])) * inv_rate);
+        }
+    }
+}
+
+/**
+ * @brief Generates a Poisson distributed count of the given mean using the provided random engine.
+ *
+ * Means below 10 use inversion by sequential search, which costs one random word and about
+ * `mean` multiplications. Larger means use the transformed rejection method with squeeze of
+ * Hormann (PTRS), which accepts about 90% of the candidates in the squeeze, without evaluating
+ * any logarithm, so its cost does not grow with the mean.
+ *
+ * @tparam T The integral type of the value to generate.
+ * @tparam Engine The type of the random engine used to generate random values. It must be a class that implements a `next()` method.
+ *
+ * @param e The random engine used to generate random values.
+ * @param mean The mean of the distribution. A mean that is not positive gives 0.
+ *
+ * @return A Poisson distributed value of type T.
+ */
+template <typename T = uint64_t, typename Engine>
+T poisson(Engine& e, double mean) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+    static_assert(std::is_integral_v<T>, "T must be an integral type");
+
+    if (!(mean > 0.0)) return T(0);
+
+    if (mean < 10.0) {
+        // Walk the cumulative distribution until it exceeds u
+        double u = detail::unit_closed_open<double>(e.next());
+        double p = std::exp(-mean);
+        uint64_t k = 0;
+        while (u > p && k < 128) {
+            u -= p;
+            p *= mean / static_cast<double>(++k);
+        }
+        return static_cast<T>(k);
+    }
+
+    const double smu = std::sqrt(mean);
+    const double b = 0.931 + 2.53 * smu;
+    const double a = -0.059 + 0.02483 * b;
+    const double inv_alpha = 1.1239 + 1.1328 / (b - 3.4);
+    const double vr = 0.9277 - 3.6224 / (b - 2.0);
+    const double log_mean = std::log(mean);
+
+    for (;;) {
+        const double u = detail::unit_closed_open<double>(e.next()) - 0.5;
+        const double v = detail::unit_open<double>(e.next());
+        const double us = 0.5 - std::abs(u);
+        const double k = std::floor((2.0 * a / us + b) * u + mean + 0.43);
+
+        if (us >= 0.07 && v <= vr) {
+            return static_cast<T>(k);
+        }
+        if (k < 0.0 || (us < 0.013 && v > us)) {
+            continue;
+        }
+        if (std::log(v * inv_alpha / (a / (us * us) + b)) <= -mean + k * log_mean - std::lgamma(k + 1.0)) {
+            return static_cast<T>(k);
+        }
+    }
+}
+
+/**
+ * @class Zipf
+ * @brief Samples integers in [1, n] with probability proportional to `1 / k^exponent`.
+ *
+ * This class implements the rejection-inversion method of Hormann and Derflinger, which needs no
+ * table (so `n` can be in the billions), runs in constant expected time for any exponent and
+ * accepts most candidates on the first attempt.
+ *
+ * @example
+ * ```cpp
+ * bpr::Zipf zipf(1000000, 1.1);
+ * uint64_t rank = zipf(engine);    // 1 is the most frequent value
+ * ```
+ */
+class Zipf
+{
+public:
+    /**
+     * @brief Creates a Zipf distribution over [1, n] with the given (positive) exponent.
+     */
+    Zipf(uint64_t n, double exponent) noexcept
+        : m_n(n < 1 ? 1 : n), m_exponent(exponent)
+    {
+        m_h_integral_x1 = h_integral(1.5) - 1.0;
+        m_h_integral_n = h_integral(static_cast<double>(m_n) + 0.5);
+        m_s = 2.0 - h_integral_inverse(h_integral(2.5) - h(2.0));
+    }
+
+    /**
+     * @brief Draws a value in [1, n].
+     */
+    template <typename Engine>
+    uint64_t operator()(Engine& e) const noexcept {
+        for (;;) {
+            const double u = m_h_integral_n + detail::unit_open<double>(e.next()) * (m_h_integral_x1 - m_h_integral_n);
+            const double x = h_integral_inverse(u);
+            double k = std::floor(x + 0.5);
+            if (k < 1.0) k = 1.0;
+            else if (k > static_cast<double>(m_n)) k = static_cast<double>(m_n);
+            // Quick acceptance inside the hat, exact test otherwise
+            if (k - x <= m_s || u >= h_integral(k + 0.5) - h(k)) {
+                return static_cast<uint64_t>(k);
+            }
+        }
+    }
+
+    uint64_t size() const noexcept {
+        return m_n;
+    }
+
+private:
+    double h(double x) const noexcept {
+        return std::exp(-m_exponent * std::log(x));
+    }
+
+    double h_integral(double x) const noexcept {
+        const double log_x = std::log(x);
+        return helper2((1.0 - m_exponent) * log_x) * log_x;
+    }
+
+    double h_integral_inverse(double x) const noexcept {
+        double t = x * (1.0 - m_exponent);
+        if (t < -1.0) t = -1.0;
+        return std::exp(helper1(t) * x);
+    }
+
+    // log(1 + x) / x, accurate near zero
+    static double helper1(double x) noexcept {
+        return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+    }
+
+    // (exp(x) - 1) / x, accurate near zero
+    static double helper2(double x) noexcept {
+        return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x));
+    }
+
+private:
+    uint64_t m_n;
+    double m_exponent;
+    double m_h_integral_x1;
+    double m_h_integral_n;
+    double m_s;
+};
+
+} // namespace bpr
+
+#endif // BPR_DISTRIBUTIONS_HPP
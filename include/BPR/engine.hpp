@@ -20,6 +20,9 @@
 #ifndef BPR_ENGINE_HPP
 #define BPR_ENGINE_HPP
 
+#include <type_traits>
+#include <utility>
+#include <cstddef>
 #include <cstdint>
 #include <array>
 
@@ -33,7 +36,12 @@ public:
         : m_state(std::move(state))
     { }
 
+#if __cplusplus >= 202002L
+    // A constexpr destructor makes the engines literal types, usable in constant expressions
+    constexpr virtual ~IEngine() = default;
+#else
     virtual ~IEngine() = default;
+#endif
     virtual uint64_t next() noexcept = 0;
 
 public:
@@ -44,6 +52,25 @@ protected:
     std::array<T, N> m_state;
 };
 
+namespace detail {
+
+template <typename EngineType, typename = void>
+struct has_bulk_fill : std::false_type { };
+
+template <typename EngineType>
+struct has_bulk_fill<EngineType, std::void_t<decltype(
+    std::declval<EngineType&>().fill(std::declval<uint64_t*>(), std::declval<size_t>()))>>
+    : std::true_type { };
+
+template <typename Source, typename = void>
+struct is_seed_source : std::false_type { };
+
+template <typename Source>
+struct is_seed_source<Source, std::void_t<decltype(std::declval<Source&>()())>>
+    : std::is_unsigned<decltype(std::declval<Source&>()())> { };
+
+} // namespace detail
+
 template<typename EngineType>
 struct EngineTraits {
     using StateValueType = typename EngineType::StateValueType;
@@ -51,8 +78,20 @@ struct EngineTraits {
 
     static constexpr bool is_valid_engine = 
         std::is_base_of_v<IEngine<StateValueType, STATE_SIZE>, EngineType>;
+
+    // True when the engine provides its own `fill(uint64_t*, size_t)` bulk generation path
+    static constexpr bool has_bulk_fill = detail::has_bulk_fill<EngineType>::value;
 };
 
+/**
+ * @brief True for the types whose call operator returns an unsigned integer, such as `std::random_device`.
+ *
+ * Engines that draw their key from such a source take it as a template parameter, so that their
+ * headers do not need `<random>`.
+ */
+template <typename Source>
+constexpr bool is_seed_source_v = detail::is_seed_source<Source>::value;
+
 } // namespace bpr
 
 #endif // BPR_ENGINE_HPP
@@ -0,0 +1,421 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_ENTROPY_HPP
+#define BPR_ENTROPY_HPP
+
+#include "generator.hpp"
+#include "engine.hpp"
+#include "utils.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include <array>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#   define BPR_HAS_X86_ENTROPY 1
+#   if defined(_MSC_VER) && !defined(__clang__)
+#       include <immintrin.h>
+#       include <intrin.h>
+#   else
+#       include <cpuid.h>
+#   endif
+#else
+#   define BPR_HAS_X86_ENTROPY 0
+#endif
+
+namespace bpr {
+
+namespace detail {
+
+#if BPR_HAS_X86_ENTROPY
+
+inline void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int out[4];
+    __cpuidex(out, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) regs[i] = static_cast<uint32_t>(out[i]);
+#else
+    regs[0] = regs[1] = regs[2] = regs[3] = 0;
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// Inline assembly rather than intrinsics, so that no -mrdseed/-mrdrnd flag is needed
+inline bool rdseed64(uint64_t& value) noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long long v;
+    const bool ok = _rdseed64_step(&v) != 0;
+    value = v;
+    return ok;
+#else
+    unsigned char ok;
+    __asm__ __volatile__("rdseed %0; setc %1" : "=r"(value), "=qm"(ok) : : "cc");
+    return ok != 0;
+#endif
+}
+
+inline bool rdrand64(uint64_t& value) noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long long v;
+    const bool ok = _rdrand64_step(&v) != 0;
+    value = v;
+    return ok;
+#else
+    unsigned char ok;
+    __asm__ __volatile__("rdrand %0; setc %1" : "=r"(value), "=qm"(ok) : : "cc");
+    return ok != 0;
+#endif
+}
+
+inline void cpu_pause() noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    _mm_pause();
+#else
+    __asm__ __volatile__("pause");
+#endif
+}
+
+#endif // BPR_HAS_X86_ENTROPY
+
+} // namespace detail
+
+/**
+ * @class HardwareEntropy
+ * @brief Entropy read from the CPU random number generator (RDSEED, falling back to RDRAND).
+ *
+ * RDSEED returns conditioned output of the hardware noise source and may transiently fail when
+ * many cores drain it, so each word is retried up to `retries` times with a pause in between.
+ * When RDSEED stays unavailable, the word is taken from RDRAND, a DRBG reseeded by the same
+ * source, with the 10 attempts recommended by Intel.
+ *
+ * Every word goes through health checks before being returned: a startup self-test, a
+ * repetition test (a 64-bit word equal to the previous one) and a stuck-output test (all zeros
+ * or all ones, as returned by some faulty parts while still reporting success). A failed check
+ * puts the source in a permanent failure state: `try_read()` then always returns false. A drained
+ * source is not a failure: the self-test is retried with a growing pause, and if the hardware
+ * stays drained during construction it runs before the first successful read instead.
+ *
+ * Unlike `std::random_device`, the backend is explicit: `source()` tells which instruction is
+ * used, and the source reports `Source::None` on CPUs without these instructions. An instance
+ * keeps the last word for the repetition test, so use one instance per thread.
+ *
+ * @example
+ * ```cpp
+ * bpr::HardwareEntropy entropy;
+ * uint64_t seed[4];
+ * if (entropy.try_read(seed, 4)) {
+ *     // seed holds 256 bits from the CPU
+ * }
+ * ```
+ */
+class HardwareEntropy
+{
+public:
+    enum class Source
+    {
+        RDSEED,     ///< Hardware noise source, RDRAND used as fallback when drained
+        RDRAND,     ///< Hardware DRBG only (RDSEED not supported)
+        None        ///< No hardware generator available
+    };
+
+    static constexpr unsigned DEFAULT_RETRIES = 128;
+    static constexpr unsigned RDRAND_RETRIES = 10;
+    static constexpr unsigned SELF_TEST_ATTEMPTS = 8;
+
+    /**
+     * @brief Detects the available instructions and runs the startup self-test.
+     */
+    HardwareEntropy() noexcept {
+        if (rdseed_supported()) m_source = Source::RDSEED;
+        else if (rdrand_supported()) m_source = Source::RDRAND;
+
+#if BPR_HAS_X86_ENTROPY
+        // Under contention RDSEED and RDRAND can both underflow: back off, doubling the pause
+        for (unsigned attempt = 0; m_source != Source::None && attempt < SELF_TEST_ATTEMPTS; ++attempt) {
+            if (self_test(DEFAULT_RETRIES) || !m_healthy) break;
+            for (unsigned i = 0; i < (64u << attempt); ++i) {
+                detail::cpu_pause();
+            }
+        }
+#endif
+    }
+
+    /**
+     * @brief Returns true if the CPU supports RDSEED.
+     */
+    static bool rdseed_supported() noexcept {
+#if BPR_HAS_X86_ENTROPY
+        uint32_t regs[4];
+        detail::cpuid(0, 0, regs);
+        if (regs[0] < 7) return false;
+        detail::cpuid(7, 0, regs);
+        return (regs[1] >> 18) & 1;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Returns true if the CPU supports RDRAND.
+     */
+    static bool rdrand_supported() noexcept {
+#if BPR_HAS_X86_ENTROPY
+        uint32_t regs[4];
+        detail::cpuid(1, 0, regs);
+        return (regs[2] >> 30) & 1;
+#else
+        return false;
+#endif
+    }
+
+    Source source() const noexcept {
+        return m_source;
+    }
+
+    /**
+     * @brief Returns false if no hardware generator is available or a health check failed.
+     */
+    bool healthy() const noexcept {
+        return m_source != Source::None && m_healthy;
+    }
+
+    /**
+     * @brief Reads `count` words of hardware entropy.
+     *
+     * @param out Pointer to the buffer that receives the words.
+     * @param count The number of words to read.
+     * @param retries The number of RDSEED attempts per word before falling back to RDRAND.
+     * @return True on success, false if the hardware is unavailable, drained or unhealthy.
+     */
+    bool try_read(uint64_t* out, size_t count, unsigned retries = DEFAULT_RETRIES) noexcept {
+#if BPR_HAS_X86_ENTROPY
+        if (!healthy()) return false;
+        if (!m_tested && !self_test(retries)) return false;
+        return read_checked(out, count, retries);
+#else
+        (void)out; (void)count; (void)retries;
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Returns one word of hardware entropy.
+     *
+     * @throws std::runtime_error If no entropy could be read.
+     */
+    uint64_t operator()() {
+        uint64_t word;
+        if (!try_read(&word, 1)) {
+            throw std::runtime_error("bpr::HardwareEntropy: hardware entropy unavailable");
+        }
+        return word;
+    }
+
+private:
+#if BPR_HAS_X86_ENTROPY
+    /**
+     * @brief Startup test: a few words must pass the health checks (distinct, not stuck).
+     *
+     * Returns false without failing the source when the hardware is drained.
+     */
+    bool self_test(unsigned retries) noexcept {
+        uint64_t words[8];
+        m_tested = read_checked(words, 8, retries);
+        secure_zero(words, sizeof(words));
+        return m_tested;
+    }
+
+    bool read_checked(uint64_t* out, size_t count, unsigned retries) noexcept {
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t word;
+            if (!read_word(word, retries)) return false;
+            if (word == m_last || word == 0 || word == ~uint64_t(0)) {
+                m_healthy = false;
+                return false;
+            }
+            out[i] = m_last = word;
+        }
+        return true;
+    }
+
+    bool read_word(uint64_t& word, unsigned retries) noexcept {
+        if (m_source == Source::RDSEED) {
+            for (unsigned i = 0; i < retries; ++i) {
+                if (detail::rdseed64(word)) return true;
+                detail::cpu_pause();
+            }
+        }
+        for (unsigned i = 0; i < RDRAND_RETRIES; ++i) {
+            if (detail::rdrand64(word)) return true;
+        }
+        return false;
+    }
+#endif
+
+private:
+    Source m_source = Source::None;
+    bool m_healthy = true;
+    bool m_tested = false;
+    uint64_t m_last = 0;
+};
+
+/**
+ * @brief When `Reseeding` mixes fresh entropy into the key of its engine.
+ *
+ * A reseed is due once `bytes` bytes have been generated or `interval` has elapsed since the
+ * last one, whichever comes first. A zero value disables the corresponding trigger.
+ */
+struct ReseedPolicy
+{
+    uint64_t bytes = uint64_t(1) << 30;
+    std::chrono::steady_clock::duration interval = std::chrono::seconds(60);
+};
+
+/**
+ * @class Reseeding
+ * @brief A CSPRNG that periodically mixes entropy from a source into its key.
+ *
+ * `Reseeding<Engine>` is the engine itself (it derives from it) with a counter in front: every
+ * few thousand words it checks the policy, and when a reseed is due it reads 256 bits from the
+ * source with a small retry budget and passes them to `Engine::reseed()`. If the source cannot
+ * deliver right away, generation goes on with the current key and the reseed is attempted again
+ * at the next check, so a drained or slow hardware source never blocks the caller.
+ *
+ * Supported engines are those with a `reseed(const std::array<uint64_t, 4>&)` method:
+ * `csprng::ChaCha20`, `csprng::BufferedChaCha20` and `csprng::AESCTR`.
+ *
+ * @tparam Engine The engine to reseed.
+ * @tparam Source The entropy source, invocable as `bool try_read(uint64_t*, size_t, unsigned)`.
+ *
+ * @example
+ * ```cpp
+ * std::random_device rd;
+ * bpr::Reseeding<bpr::csprng::ChaCha20> rng({ 1 << 20, std::chrono::seconds(10) }, rd);
+ * uint64_t value = rng.next();     // the key absorbs RDSEED output every MiB or 10 s
+ * ```
+ */
+template <typename Engine, typename Source = HardwareEntropy>
+class Reseeding : public Engine
+{
+public:
+    /**
+     * @param policy When to reseed.
+     * @param args The arguments forwarded to the constructor of `Engine`.
+     */
+    template <typename... Args>
+    explicit Reseeding(ReseedPolicy policy, Args&&... args)
+        : Engine(std::forward<Args>(args)...)
+        , m_policy(policy)
+        , m_last_reseed(std::chrono::steady_clock::now())
+    { }
+
+    uint64_t next() noexcept override {
+        if (m_countdown == 0) check();
+        --m_countdown;
+        return Engine::next();
+    }
+
+    /**
+     * @brief Fills a buffer through the bulk path of the engine, checking the policy between chunks.
+     */
+    void fill(uint64_t* out, size_t count) noexcept {
+        while (count > 0) {
+            if (m_countdown == 0) check();
+            const size_t n = static_cast<size_t>(std::min<uint64_t>(count, m_countdown));
+            ::bpr::fill(static_cast<Engine&>(*this), out, n);
+            m_countdown -= n;
+            out += n;
+            count -= n;
+        }
+    }
+
+    /**
+     * @brief Mixes entropy from the source into the key now, returns false if the source failed.
+     */
+    bool reseed_now() noexcept {
+        std::array<uint64_t, 4> entropy;
+        if (!m_source.try_read(entropy.data(), entropy.size(), RESEED_RETRIES)) {
+            return false;
+        }
+        Engine::reseed(entropy);
+        secure_zero(entropy.data(), sizeof(entropy));
+        m_words_since_reseed = 0;
+        m_last_reseed = std::chrono::steady_clock::now();
+        ++m_reseed_count;
+        return true;
+    }
+
+    /**
+     * @brief Number of successful reseeds, for monitoring.
+     */
+    uint64_t reseed_count() const noexcept {
+        return m_reseed_count;
+    }
+
+    Source& source() noexcept {
+        return m_source;
+    }
+
+private:
+    static constexpr uint64_t CHECK_WORDS = 4096;     // The clock is read at most every 32 KiB
+    static constexpr unsigned RESEED_RETRIES = 16;    // Small budget: never stall generation
+
+    void check() noexcept {
+        m_words_since_reseed += m_checked_words;
+
+        const bool bytes_due = m_policy.bytes && m_words_since_reseed * 8 >= m_policy.bytes;
+        const bool time_due = m_policy.interval.count() > 0
+            && std::chrono::steady_clock::now() - m_last_reseed >= m_policy.interval;
+        if (bytes_due || time_due) {
+            reseed_now();
+        }
+
+        // Next check after CHECK_WORDS words, or exactly when the byte budget runs out
+        m_countdown = CHECK_WORDS;
+        if (m_policy.bytes) {
+            const uint64_t budget = (m_policy.bytes + 7) / 8;
+            if (m_words_since_reseed < budget) {
+                m_countdown = std::min(m_countdown, budget - m_words_since_reseed);
+            }
+        }
+        m_checked_words = m_countdown;
+    }
+
+private:
+    ReseedPolicy m_policy;
+    Source m_source;
+    std::chrono::steady_clock::time_point m_last_reseed;
+    uint64_t m_countdown = 0;
+    uint64_t m_checked_words = 0;
+    uint64_t m_words_since_reseed = 0;
+    uint64_t m_reseed_count = 0;
+};
+
+} // namespace bpr
+
+#endif // BPR_ENTROPY_HPP
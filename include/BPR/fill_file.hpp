@@ -0,0 +1,358 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_FILL_FILE_HPP
+#define BPR_FILL_FILE_HPP
+
+#include "generator.hpp"
+#include "parallel.hpp"
+#include "csprng.hpp"
+#include "utils.hpp"
+#include "prng.hpp"
+
+#include <condition_variable>
+#include <system_error>
+#include <algorithm>
+#include <optional>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <array>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <cerrno>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   include <sys/stat.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#   define BPR_HAS_PWRITE 1
+#else
+#   define BPR_HAS_PWRITE 0
+#endif
+
+namespace bpr {
+
+/**
+ * @brief Engine used by `fill_file()` to generate the file content.
+ */
+enum class FillEngine
+{
+    ChaCha20,       ///< Keystream of a single ChaCha20 instance, suitable for secure wipes
+    Xoshiro256ss    ///< One Xoshiro256** stream per block, for benchmarks where speed matters most
+};
+
+/**
+ * @brief Options of `fill_file()`.
+ */
+struct FillFileOptions
+{
+    FillEngine engine = FillEngine::ChaCha20;
+    std::optional<uint64_t> seed;   ///< Reproducible content when set, key/seed from `std::random_device` otherwise
+    unsigned threads = 0;           ///< Generator threads, zero for every hardware thread
+    unsigned writers = 4;           ///< Threads issuing writes, i.e. the number of writes in flight
+    size_t block_size = 4 << 20;    ///< Bytes per write, rounded up to a multiple of 4096
+    bool direct_io = true;          ///< Bypass the page cache with O_DIRECT when the file system supports it
+};
+
+namespace detail {
+
+inline constexpr size_t FILL_ALIGNMENT = 4096;
+
+/**
+ * @brief A simple blocking queue used to pass buffers between the generator and writer threads.
+ */
+template <typename T>
+class BlockingQueue
+{
+public:
+    void push(T value) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_items.push_back(std::move(value));
+        }
+        m_ready.notify_one();
+    }
+
+    T pop() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_ready.wait(lock, [this] { return !m_items.empty(); });
+        T value = std::move(m_items.front());
+        m_items.pop_front();
+        return value;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_ready;
+    std::deque<T> m_items;
+};
+
+/**
+ * @brief Generates the content of block `index` of a filled file.
+ *
+ * The content of a block only depends on the key/seed and on the block index, so blocks can be
+ * generated by any thread in any order.
+ */
+class FillSource
+{
+public:
+    FillSource(const FillFileOptions& options, size_t block_size)
+        : m_engine(options.engine), m_block_size(block_size), m_chacha(make_chacha(options))
+    {
+        if (options.seed) {
+            m_seed = *options.seed;
+        } else {
+            std::random_device rd;
+            m_seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+        }
+    }
+
+    void generate(uint64_t index, uint64_t* out, size_t words) const noexcept {
+        if (m_engine == FillEngine::ChaCha20) {
+            // Each thread works on its own copy positioned at the block
+            csprng::ChaCha20 e = m_chacha;
+            e.seek(index * (m_block_size / 64));
+            fill(e, out, words);
+        } else {
+            prng::Xoshiro256ss e(stream_seed(m_seed, index));
+            fill(e, out, words);
+        }
+    }
+
+private:
+    static csprng::ChaCha20 make_chacha(const FillFileOptions& options) {
+        if (!options.seed) {
+            std::random_device rd;
+            return csprng::ChaCha20(rd);
+        }
+        std::array<uint32_t, 8> key;
+        for (size_t i = 0; i < key.size(); ++i) {
+            key[i] = static_cast<uint32_t>(stream_seed(*options.seed, i));
+        }
+        return csprng::ChaCha20(key, { 0, 0 });
+    }
+
+private:
+    FillEngine m_engine;
+    size_t m_block_size;
+    csprng::ChaCha20 m_chacha;
+    uint64_t m_seed = 0;
+};
+
+/**
+ * @brief Page-aligned buffer as required by O_DIRECT.
+ */
+struct AlignedBlock
+{
+    explicit AlignedBlock(size_t size)
+        : data(static_cast<uint64_t*>(::operator new(size, std::align_val_t(FILL_ALIGNMENT))))
+    { }
+
+    ~AlignedBlock() {
+        ::operator delete(data, std::align_val_t(FILL_ALIGNMENT));
+    }
+
+    AlignedBlock(const AlignedBlock&) = delete;
+    AlignedBlock& operator=(const AlignedBlock&) = delete;
+
+    uint64_t* data;
+};
+
+/**
+ * @brief A filled block waiting to be written, or the end marker of a writer when `block` is null.
+ */
+struct FillJob
+{
+    uint64_t index;
+    AlignedBlock* block;
+};
+
+} // namespace detail
+
+/**
+ * @brief Writes `size` bytes of random data to a file or block device as fast as the storage allows.
+ *
+ * The file is processed in blocks of `block_size` bytes. Generator threads fill page-aligned
+ * buffers through the bulk path of the engine (the four-block ChaCha20 kernel, or Xoshiro256**),
+ * while writer threads submit the filled buffers with `pwrite()`, opened with `O_DIRECT` when
+ * possible. Each generator owns two buffers, so the generation of a block overlaps with the write
+ * of the previous one, and several writes are kept in flight to feed the device queue.
+ *
+ * The content of each block only depends on the seed and the block index, so a seeded run
+ * produces the same file whatever the number of threads. With the ChaCha20 engine the file is the
+ * keystream of a single ChaCha20 instance.
+ *
+ * The file is created if needed but never truncated, so existing data beyond `size` is kept; this
+ * also allows filling block devices. On systems without `pwrite()`, blocks are generated and
+ * written sequentially.
+ *
+ * @param path The path of the file or device to fill.
+ * @param size The number of bytes to write.
+ * @param options The engine, seed, threading and I/O options.
+ * @return The number of bytes written.
+ *
+ * @throws std::system_error If the file cannot be opened or written.
+ */
+inline uint64_t fill_file(const std::string& path, uint64_t size, const FillFileOptions& options = {})
+{
+    using namespace detail;
+
+    const size_t block_size = std::max<size_t>(
+        (options.block_size + FILL_ALIGNMENT - 1) / FILL_ALIGNMENT * FILL_ALIGNMENT, FILL_ALIGNMENT);
+    const uint64_t block_count = (size + block_size - 1) / block_size;
+    const FillSource source(options, block_size);
+
+#if BPR_HAS_PWRITE
+    auto fail = [&](const char* what, int error) {
+        throw std::system_error(error, std::generic_category(), std::string("bpr: cannot ") + what + " " + path);
+    };
+
+    // Buffered descriptor, used for the unaligned tail and when O_DIRECT is not supported
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT, 0644);
+    if (fd < 0) fail("open", errno);
+
+    int direct_fd = -1;
+#if defined(O_DIRECT)
+    if (options.direct_io) {
+        direct_fd = ::open(path.c_str(), O_WRONLY | O_DIRECT);
+    }
+#endif
+
+    // Grow regular files up front so that writes do not extend them one by one
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && static_cast<uint64_t>(info.st_size) < size) {
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            const int error = errno;
+            ::close(fd);
+            if (direct_fd >= 0) ::close(direct_fd);
+            fail("resize", error);
+        }
+    }
+
+    const unsigned generators = thread_count_for(static_cast<size_t>(block_count), options.threads);
+    const unsigned writers = std::max(1u, options.writers);
+
+    // Two buffers per generator: one being filled while the other one is written
+    std::vector<std::unique_ptr<AlignedBlock>> blocks;
+    BlockingQueue<AlignedBlock*> free_blocks;
+    BlockingQueue<FillJob> pending_writes;
+    for (unsigned i = 0; i < 2 * generators; ++i) {
+        blocks.push_back(std::make_unique<AlignedBlock>(block_size));
+        free_blocks.push(blocks.back().get());
+    }
+
+    std::atomic<uint64_t> next_block{ 0 };
+    std::atomic<int> error{ 0 };
+
+    auto generator = [&] {
+        uint64_t index;
+        while ((index = next_block.fetch_add(1, std::memory_order_relaxed)) < block_count) {
+            if (error.load(std::memory_order_relaxed)) break;
+            AlignedBlock* block = free_blocks.pop();
+            const uint64_t bytes = std::min<uint64_t>(block_size, size - index * block_size);
+            source.generate(index, block->data, static_cast<size_t>((bytes + 7) / 8));
+            pending_writes.push(FillJob{ index, block });
+        }
+    };
+
+    auto writer = [&] {
+        for (;;) {
+            const FillJob job = pending_writes.pop();
+            if (!job.block) break;
+
+            const uint64_t offset = job.index * block_size;
+            const size_t bytes = static_cast<size_t>(std::min<uint64_t>(block_size, size - offset));
+            // O_DIRECT needs aligned sizes, a short tail goes through the page cache
+            const int target = (direct_fd >= 0 && bytes % FILL_ALIGNMENT == 0) ? direct_fd : fd;
+
+            const char* data = reinterpret_cast<const char*>(job.block->data);
+            size_t done = 0;
+            while (done < bytes) {
+                const ssize_t n = ::pwrite(target, data + done, bytes - done, static_cast<off_t>(offset + done));
+                if (n <= 0) {
+                    if (n < 0 && errno == EINTR) continue;
+                    // Nothing written without an error: the end of a device, or no space left
+                    int expected = 0;
+                    error.compare_exchange_strong(expected, n < 0 ? errno : ENOSPC);
+                    break;
+                }
+                done += static_cast<size_t>(n);
+            }
+            free_blocks.push(job.block);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < writers; ++i) {
+        threads.emplace_back(writer);
+    }
+    {
+        std::vector<std::thread> generator_threads;
+        for (unsigned i = 0; i < generators; ++i) {
+            generator_threads.emplace_back(generator);
+        }
+        for (auto& thread : generator_threads) {
+            thread.join();
+        }
+    }
+    // One end marker per writer
+    for (unsigned i = 0; i < writers; ++i) {
+        pending_writes.push(FillJob{ 0, nullptr });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (direct_fd >= 0) ::close(direct_fd);
+    if (::close(fd) != 0 && !error) error = errno;
+    if (error) fail("write", error);
+#else
+    std::FILE* file = std::fopen(path.c_str(), "r+b");
+    if (!file) file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        throw std::system_error(errno, std::generic_category(), "bpr: cannot open " + path);
+    }
+
+    std::vector<uint64_t> buffer(block_size / 8);
+    for (uint64_t index = 0; index < block_count; ++index) {
+        const size_t bytes = static_cast<size_t>(std::min<uint64_t>(block_size, size - index * block_size));
+        source.generate(index, buffer.data(), (bytes + 7) / 8);
+        if (std::fwrite(buffer.data(), 1, bytes, file) != bytes) {
+            const int error = errno;
+            std::fclose(file);
+            throw std::system_error(error, std::generic_category(), "bpr: cannot write " + path);
+        }
+    }
+    std::fclose(file);
+#endif
+
+    return size;
+}
+
+} // namespace bpr
+
+#endif // BPR_FILL_FILE_HPP
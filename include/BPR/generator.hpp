@@ -23,10 +23,9 @@
 #include "engine.hpp"
 #include "utils.hpp"
 
-#include <unordered_set>
 #include <type_traits>
-#include <vector>
-#include <cmath>
+#include <cstdint>
+#include <cstddef>
 
 namespace bpr {
 
@@ -51,6 +50,15 @@ constexpr T rand(Engine& e) noexcept
     // Assert that the Engine type is valid (derived from IEngine)
     static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
 
+#if defined(__SIZEOF_INT128__)
+    // 128-bit integers take two words, a single one would leave their high half at zero
+    if constexpr (is_int128_v<T>) {
+        const __uint128_t hi = e.next();
+        return static_cast<T>((hi << 64) | e.next());
+    }
+    else
+#endif
+
     // If T is an integral type, return the next generated value as the desired type
     if constexpr (std::is_integral_v<T>) {
         return static_cast<T>(e.next());
@@ -94,6 +102,17 @@ constexpr T rand(Engine& e, T min, T max) noexcept
     // Assert that the Engine type is valid (derived from IEngine)
     static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
 
+#if defined(__SIZEOF_INT128__)
+    // 128-bit ranges are reduced without bias by a 256-bit multiply-shift
+    if constexpr (is_int128_v<T>) {
+        const __uint128_t range = static_cast<__uint128_t>(max) - static_cast<__uint128_t>(min) + 1;
+        // A range of zero is the whole 128-bit range
+        const __uint128_t offset = range ? bounded128(e, range) : rand<__uint128_t>(e);
+        return static_cast<T>(static_cast<__uint128_t>(min) + offset);
+    }
+    else
+#endif
+
     // If T is an integral type, generate a random number in the range [min, max]
     if constexpr (std::is_integral_v<T>) {
         // Calculate the range size (inclusive of max)
@@ -117,59 +136,114 @@ constexpr T rand(Engine& e, T min, T max) noexcept
 }
 
 /**
- * @brief Generates a sequence of unique random values within the range [min, max].
+ * @brief Generates a uniformly distributed integer in the range [0, range) without modulo bias.
  * 
- * This function generates a sequence of `count` unique random values of type T within the specified range [min, max].
- * The values can be either integral or floating-point types, and the function ensures that no duplicate values are added.
+ * This function uses Lemire's multiply-shift method: the 64-bit output of the engine is multiplied
+ * by `range` and the high half of the 128-bit product is the result. A rejection step, which is only
+ * entered with probability `range / 2^64`, removes the bias that a plain modulo would introduce.
+ * No division is performed in the common case.
  * 
- * If the requested `count` exceeds the number of possible unique values within the range, the function adjusts `count`
- * to the maximum number of unique values that can be generated within the range.
- * 
- * @tparam T The type of the values to be generated. It can be either integral (e.g., int, uint32_t) or floating-point (e.g., float, double).
  * @tparam Engine The type of the random engine used to generate random values. It must be a class that implements a `next()` method.
  * 
- * @param e The random engine used to generate random values. It must meet the requirements of the Engine concept.
- * @param min The minimum value of the range.
- * @param max The maximum value of the range.
- * @param count The number of unique random values to generate.
+ * @param e The random engine used to generate random values.
+ * @param range The number of possible values. Must be greater than zero.
  * 
- * @return A vector containing the unique random values.
- * 
- * @throws static_assert If the provided engine type does not meet the requirements of the Engine concept, or if T is not an integral or floating-point type.
+ * @return A random integer in the range [0, range).
  */
-template <typename T, typename Engine>
-std::vector<T> sequence(Engine& e, T min, T max, size_t count)
+template <typename Engine>
+constexpr uint64_t bounded(Engine& e, uint64_t range) noexcept
 {
-    // For integral types, ensure that `count` does not exceed the range of unique values
-    if constexpr (std::is_integral_v<T>) {
-        if (count > static_cast<size_t>(max - min) + 1) {
-            count = static_cast<size_t>(max - min + 1);
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+    uint64_t lo = 0;
+    uint64_t hi = mul128(e.next(), range, lo);
+
+    // Reject the few products that fall in the biased part of the low word
+    if (lo < range) {
+        const uint64_t threshold = (0 - range) % range;
+        while (lo < threshold) {
+            hi = mul128(e.next(), range, lo);
         }
-    } 
+    }
 
-    // For floating-point types, calculate the maximum number of unique values based on epsilon
-    else if constexpr (std::is_floating_point_v<T>) {
-        T range = max - min;
-        // Calculate the number of unique values that can be represented within the range
-        size_t unique_count = static_cast<size_t>(std::ceil(range / std::numeric_limits<T>::epsilon()));
-        if (count > unique_count) count = unique_count;
+    return hi;
+}
+
+#if defined(__SIZEOF_INT128__)
+
+/**
+ * @brief Generates a uniformly distributed 128-bit integer in the range [0, range) without bias.
+ * 
+ * This is Lemire's multiply-shift method on 128-bit words: two engine outputs form a 128-bit
+ * value, the high half of its 256-bit product with `range` is the result, and the low half is
+ * rejected in the rare cases where it falls in the biased part. Ranges that fit in 64 bits are
+ * forwarded to `bounded()`, which only uses one word.
+ * 
+ * @tparam Engine The type of the random engine used to generate random values. It must be a class that implements a `next()` method.
+ * 
+ * @param e The random engine used to generate random values.
+ * @param range The number of possible values. Must be greater than zero.
+ * 
+ * @return A random integer in the range [0, range).
+ */
+template <typename Engine>
+constexpr __uint128_t bounded128(Engine& e, __uint128_t range) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+    if ((range >> 64) == 0) {
+        return bounded(e, static_cast<uint64_t>(range));
     }
 
-    // Vector to store the unique random values
-    std::vector<T> seq;
-    seq.reserve(count);
-    std::unordered_set<T> unique_values;
-
-    // Generate values until we have `count` unique values
-    while (seq.size() < count) {
-        T value = rand(e, min, max);
-        // Insert the value into the set; if successful, add it to the sequence
-        if (unique_values.insert(value).second) {
-            seq.push_back(value);
+    __uint128_t lo = 0;
+    __uint128_t hi = mul256(rand<__uint128_t>(e), range, lo);
+
+    // Reject the few products that fall in the biased part of the low half
+    if (lo < range) {
+        const __uint128_t threshold = (0 - range) % range;
+        while (lo < threshold) {
+            hi = mul256(rand<__uint128_t>(e), range, lo);
         }
     }
 
-    return seq;
+    return hi;
+}
+
+#endif
+
+/**
+ * @brief Fills a buffer with raw 64-bit outputs of the provided random engine.
+ * 
+ * This is the bulk generation path of the library. If the engine provides its own
+ * `fill(uint64_t*, size_t)` method it is used, otherwise the engine's `next()` is called
+ * through a qualified (non-virtual) call so that the compiler can inline the generator
+ * body into the loop.
+ * 
+ * @tparam Engine The type of the random engine used to generate random values. It must be a class that implements a `next()` method.
+ * 
+ * @param e The random engine used to generate random values.
+ * @param out Pointer to the buffer that receives the generated words.
+ * @param count The number of 64-bit words to generate.
+ */
+template <typename Engine>
+void fill(Engine& e, uint64_t* out, size_t count) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+    // Use the dedicated bulk path of the engine when it has one
+    if constexpr (EngineTraits<Engine>::has_bulk_fill) {
+        e.fill(out, count);
+    }
+
+    // Otherwise call the generator statically to avoid one virtual dispatch per word
+    else {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = e.Engine::next();
+        }
+    }
 }
 
 } // namespace bpr
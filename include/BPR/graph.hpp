@@ -0,0 +1,558 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_GRAPH_HPP
+#define BPR_GRAPH_HPP
+
+#include "distributions.hpp"
+#include "generator.hpp"
+#include "parallel.hpp"
+#include "sampling.hpp"
+#include "engine.hpp"
+#include "utils.hpp"
+#include "prng.hpp"
+
+#include <system_error>
+#include <stdexcept>
+#include <algorithm>
+#include <numeric>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cerrno>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   include <sys/mman.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#   define BPR_HAS_MMAP 1
+#else
+#   define BPR_HAS_MMAP 0
+#endif
+
+namespace bpr { namespace graph {
+
+/**
+ * @brief A directed edge, or an undirected edge stored once.
+ *
+ * Edge files written by `write_edges()` are a flat array of this structure (two native-endian
+ * 64-bit vertex ids per edge, no header).
+ */
+struct Edge
+{
+    uint64_t src;
+    uint64_t dst;
+};
+
+static_assert(sizeof(Edge) == 16, "Edge must be two packed 64-bit integers");
+
+/**
+ * @class ErdosRenyi
+ * @brief G(n, p) random graph generated with geometric skipping (Batagelj-Brandes).
+ *
+ * Instead of testing each of the n^2 candidate pairs, the generator jumps from one edge to the next
+ * with a geometrically distributed skip `floor(log(u) / log(1 - p))`, so the cost is proportional
+ * to the number of edges. The linear index space of the candidate pairs is split into fixed chunks
+ * that are sampled independently, which is exact since geometric skips are memoryless.
+ *
+ * Undirected graphs contain the pairs `dst < src`, directed graphs every pair with `src != dst`.
+ * Self loops are never generated. The number of candidate pairs must fit in 64 bits, which allows
+ * n up to about 2^32 (directed) or 2^32.5 (undirected).
+ *
+ * `count()` replays the skips of a chunk without decoding the edges, so the drivers draw the
+ * random stream of each chunk twice.
+ */
+template <typename Engine = prng::Xoshiro256ss>
+class ErdosRenyi
+{
+public:
+    /**
+     * @throws std::invalid_argument If the number of candidate pairs does not fit in 64 bits.
+     */
+    ErdosRenyi(uint64_t seed, uint64_t n, double p, bool directed = false)
+        : m_seed(seed), m_n(n), m_p(p), m_directed(directed)
+    {
+        m_pairs = n < 2 ? 0 : pair_count(n, directed);
+        m_log_q = std::log1p(-std::min(p, 1.0));
+
+        // About 2^20 expected edges per chunk, and chunks never smaller than 2^16 pairs
+        const double expected = static_cast<double>(m_pairs) * std::clamp(p, 0.0, 1.0);
+        const double chunks = std::clamp(std::ceil(expected / EDGES_PER_CHUNK), 1.0,
+                                         std::max(1.0, static_cast<double>(m_pairs >> 16)));
+        m_chunk_count = static_cast<size_t>(chunks);
+        m_span = m_pairs / m_chunk_count + (m_pairs % m_chunk_count != 0);
+    }
+
+    size_t chunk_count() const noexcept {
+        return m_p > 0.0 && m_pairs > 0 ? m_chunk_count : 0;
+    }
+
+    uint64_t count(size_t chunk) const noexcept {
+        uint64_t edges = 0;
+        skip_through(chunk, [&](uint64_t) { ++edges; });
+        return edges;
+    }
+
+    template <typename Emit>
+    void generate(size_t chunk, Emit&& emit) const {
+        if (m_directed) {
+            skip_through(chunk, [&](uint64_t k) {
+                const uint64_t v = k / (m_n - 1);
+                const uint64_t w = k % (m_n - 1);
+                emit(v, w + (w >= v));
+            });
+            return;
+        }
+
+        // Undirected: decode the first pair of the chunk once, then walk the triangle incrementally
+        uint64_t v = 0, w = 0, position = 0;
+        bool first = true;
+        skip_through(chunk, [&](uint64_t k) {
+            if (first) {
+                v = row_of(k);
+                w = k - triangle(v);
+                first = false;
+            } else {
+                w += k - position;
+                while (w >= v) {
+                    w -= v;
+                    ++v;
+                }
+            }
+            position = k;
+            emit(v, w);
+        });
+    }
+
+private:
+    static constexpr double EDGES_PER_CHUNK = 1048576.0;
+
+    /**
+     * @brief Number of pairs (v, w) with w < v < n, computed without intermediate overflow.
+     */
+    static constexpr uint64_t triangle(uint64_t n) noexcept {
+        return (n & 1) ? n * ((n - 1) / 2) : (n / 2) * (n - 1);
+    }
+
+    /**
+     * @brief Number of candidate pairs of a graph of n >= 2 vertices, checked for overflow.
+     */
+    static uint64_t pair_count(uint64_t n, bool directed) {
+        // n * (n - 1), halved on the even factor for undirected graphs
+        const uint64_t a = directed || (n & 1) ? n : n / 2;
+        const uint64_t b = directed || !(n & 1) ? n - 1 : (n - 1) / 2;
+        if (a > UINT64_MAX / b) {
+            throw std::invalid_argument("bpr::graph::ErdosRenyi: too many vertices, the number of pairs overflows 64 bits");
+        }
+        return a * b;
+    }
+
+    /**
+     * @brief Row v of the lower triangle containing the linear index k.
+     */
+    static uint64_t row_of(uint64_t k) noexcept {
+        uint64_t v = static_cast<uint64_t>((1.0 + std::sqrt(1.0 + 8.0 * static_cast<double>(k))) / 2.0);
+        // Fix the rounding of the floating-point estimate
+        while (v > 1 && triangle(v) > k) --v;
+        while (triangle(v + 1) <= k) ++v;
+        return v;
+    }
+
+    /**
+     * @brief Calls `on_edge(k)` for the linear index of each edge of a chunk.
+     */
+    template <typename OnEdge>
+    void skip_through(size_t chunk, OnEdge&& on_edge) const {
+        const uint64_t begin = static_cast<uint64_t>(chunk) * m_span;
+        const uint64_t end = std::min(m_pairs, begin + m_span);
+        if (begin >= end || m_p <= 0.0) return;
+
+        Engine e(stream_seed(m_seed, chunk));
+        constexpr size_t TILE = detail::DISTRIBUTION_TILE_WORDS;
+        uint64_t tile[TILE];
+        size_t used = TILE;
+
+        uint64_t k = begin;
+        for (;;) {
+            if (used == TILE) {
+                fill(e, tile, TILE);
+                used = 0;
+            }
+            // Number of pairs rejected before the next edge
+            const double skip = std::floor(std::log(detail::unit_open<double>(tile[used++])) / m_log_q);
+            if (skip >= static_cast<double>(end - k)) break;
+            k += static_cast<uint64_t>(skip);
+            on_edge(k);
+            if (++k == end) break;
+        }
+    }
+
+private:
+    uint64_t m_seed;
+    uint64_t m_n;
+    double m_p;
+    bool m_directed;
+    uint64_t m_pairs;
+    double m_log_q;
+    size_t m_chunk_count;
+    uint64_t m_span;
+};
+
+/**
+ * @class ChungLu
+ * @brief Chung-Lu random graph with a prescribed expected degree sequence.
+ *
+ * Each of the `edge_count` edges draws both endpoints independently with probability proportional
+ * to their weight, using an `AliasTable` so that each endpoint costs one engine word and one memory
+ * access whatever the number of vertices. By default, `edge_count` is half the sum of the weights,
+ * which gives each vertex an expected degree equal to its weight. Self loops and multi-edges are
+ * possible, as in the usual fast Chung-Lu construction.
+ */
+template <typename Engine = prng::Xoshiro256ss>
+class ChungLu
+{
+public:
+    ChungLu(uint64_t seed, const std::vector<double>& weights, uint64_t edge_count = 0)
+        : m_seed(seed), m_table(weights), m_edge_count(edge_count)
+    {
+        if (m_edge_count == 0) {
+            const double total = std::accumulate(weights.begin(), weights.end(), 0.0);
+            m_edge_count = static_cast<uint64_t>(std::llround(total / 2.0));
+        }
+        if (m_table.size() == 0) {
+            m_edge_count = 0;
+        }
+    }
+
+    size_t chunk_count() const noexcept {
+        return static_cast<size_t>((m_edge_count + EDGES_PER_CHUNK - 1) / EDGES_PER_CHUNK);
+    }
+
+    uint64_t count(size_t chunk) const noexcept {
+        const uint64_t begin = static_cast<uint64_t>(chunk) * EDGES_PER_CHUNK;
+        return std::min<uint64_t>(EDGES_PER_CHUNK, m_edge_count - begin);
+    }
+
+    template <typename Emit>
+    void generate(size_t chunk, Emit&& emit) const {
+        Engine e(stream_seed(m_seed, chunk));
+        constexpr size_t TILE = detail::DISTRIBUTION_TILE_WORDS;
+        uint64_t tile[TILE];
+
+        uint64_t remaining = count(chunk);
+        while (remaining > 0) {
+            const size_t edges = static_cast<size_t>(std::min<uint64_t>(remaining, TILE / 2));
+            fill(e, tile, 2 * edges);
+            for (size_t i = 0; i < edges; ++i) {
+                emit(m_table.sample(tile[2 * i]), m_table.sample(tile[2 * i + 1]));
+            }
+            remaining -= edges;
+        }
+    }
+
+private:
+    static constexpr uint64_t EDGES_PER_CHUNK = 1 << 20;
+
+    uint64_t m_seed;
+    AliasTable<uint32_t> m_table;
+    uint64_t m_edge_count;
+};
+
+/**
+ * @class RMAT
+ * @brief R-MAT (recursive matrix) graph on 2^scale vertices, as used by the Graph500 benchmark.
+ *
+ * Each edge descends `scale` levels of the adjacency matrix, choosing at each level the quadrant
+ * (a: top-left, b: top-right, c: bottom-left, d: bottom-right) with the given probabilities.
+ * The descent is done level by level over a batch of edges, with 32-bit integer thresholds and
+ * branchless comparisons, so the inner loop is vectorized by the compiler. Each 64-bit word
+ * provides the decisions of two edges.
+ */
+template <typename Engine = prng::Xoshiro256ss>
+class RMAT
+{
+public:
+    RMAT(uint64_t seed, unsigned scale, uint64_t edge_count,
+         double a = 0.57, double b = 0.19, double c = 0.19) noexcept
+        : m_seed(seed), m_scale(std::min(scale, 63u)), m_edge_count(edge_count)
+        , m_ta(to_threshold(a))
+        , m_tab(to_threshold(a + b))
+        , m_tabc(to_threshold(a + b + c))
+    { }
+
+    size_t chunk_count() const noexcept {
+        return static_cast<size_t>((m_edge_count + EDGES_PER_CHUNK - 1) / EDGES_PER_CHUNK);
+    }
+
+    uint64_t count(size_t chunk) const noexcept {
+        const uint64_t begin = static_cast<uint64_t>(chunk) * EDGES_PER_CHUNK;
+        return std::min<uint64_t>(EDGES_PER_CHUNK, m_edge_count - begin);
+    }
+
+    template <typename Emit>
+    void generate(size_t chunk, Emit&& emit) const {
+        Engine e(stream_seed(m_seed, chunk));
+
+        // Decision bits of one level of a batch: BATCH / 2 words
+        uint64_t bits[BATCH / 2];
+        uint64_t src[BATCH], dst[BATCH];
+
+        uint64_t remaining = count(chunk);
+        while (remaining > 0) {
+            const size_t edges = static_cast<size_t>(std::min<uint64_t>(remaining, BATCH));
+            std::fill(src, src + BATCH, 0);
+            std::fill(dst, dst + BATCH, 0);
+
+            for (unsigned level = 0; level < m_scale; ++level) {
+                fill(e, bits, (edges + 1) / 2);
+                for (size_t i = 0; i < edges; ++i) {
+                    const uint32_t u = static_cast<uint32_t>(bits[i / 2] >> (32 * (i & 1)));
+                    const uint64_t ge_a = u >= m_ta, ge_ab = u >= m_tab, ge_abc = u >= m_tabc;
+                    // Quadrants c and d set the row bit, quadrants b and d the column bit
+                    src[i] = (src[i] << 1) | ge_ab;
+                    dst[i] = (dst[i] << 1) | (ge_a ^ ge_ab ^ ge_abc);
+                }
+            }
+
+            for (size_t i = 0; i < edges; ++i) {
+                emit(src[i], dst[i]);
+            }
+            remaining -= edges;
+        }
+    }
+
+private:
+    static constexpr uint64_t EDGES_PER_CHUNK = 1 << 20;
+    static constexpr size_t BATCH = 256;
+
+    static uint32_t to_threshold(double probability) noexcept {
+        const double scaled = std::clamp(probability, 0.0, 1.0) * 4294967296.0;
+        return scaled >= 4294967295.0 ? UINT32_MAX : static_cast<uint32_t>(scaled);
+    }
+
+private:
+    uint64_t m_seed;
+    unsigned m_scale;
+    uint64_t m_edge_count;
+    uint32_t m_ta, m_tab, m_tabc;
+};
+
+/**
+ * @class BarabasiAlbert
+ * @brief Preferential attachment graph generated in linear time (Batagelj-Brandes).
+ *
+ * Every new vertex attaches `m` edges to existing vertices chosen with probability proportional to
+ * their degree. Choosing a uniform entry of the list of all edge endpoints seen so far samples by
+ * degree directly, without any weighted sampling structure. The process is inherently sequential,
+ * so this generator has a single chunk and uses 16 bytes of memory per edge while generating.
+ * Self loops and multi-edges are possible.
+ */
+template <typename Engine = prng::Xoshiro256ss>
+class BarabasiAlbert
+{
+public:
+    BarabasiAlbert(uint64_t seed, uint64_t n, uint64_t m) noexcept
+        : m_seed(seed), m_n(n), m_m(m)
+    { }
+
+    size_t chunk_count() const noexcept {
+        return m_n > 0 && m_m > 0 ? 1 : 0;
+    }
+
+    uint64_t count(size_t) const noexcept {
+        return m_n * m_m;
+    }
+
+    template <typename Emit>
+    void generate(size_t chunk, Emit&& emit) const {
+        Engine e(stream_seed(m_seed, chunk));
+        std::vector<uint64_t> endpoints(2 * m_n * m_m);
+
+        for (uint64_t v = 0; v < m_n; ++v) {
+            for (uint64_t i = 0; i < m_m; ++i) {
+                const uint64_t k = 2 * (v * m_m + i);
+                endpoints[k] = v;
+                // Uniform among all endpoints so far, including the one just written
+                endpoints[k + 1] = endpoints[bounded(e, k + 1)];
+                emit(endpoints[k], endpoints[k + 1]);
+            }
+        }
+    }
+
+private:
+    uint64_t m_seed;
+    uint64_t m_n;
+    uint64_t m_m;
+};
+
+namespace detail {
+
+/**
+ * @brief Computes the offset of each chunk of a generator in its output.
+ */
+template <typename Generator>
+std::vector<uint64_t> chunk_offsets(const Generator& g, unsigned thread_count)
+{
+    const size_t chunks = g.chunk_count();
+    std::vector<uint64_t> offsets(chunks + 1, 0);
+    parallel_for(chunks, [&](size_t c, unsigned) {
+        offsets[c + 1] = g.count(c);
+    }, thread_count);
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    return offsets;
+}
+
+/**
+ * @brief Generates every chunk of a generator directly at its final position in `out`.
+ */
+template <typename Generator>
+void generate_chunks(const Generator& g, const std::vector<uint64_t>& offsets, Edge* out, unsigned thread_count)
+{
+    parallel_for(offsets.size() - 1, [&](size_t c, unsigned) {
+        Edge* edge = out + offsets[c];
+        g.generate(c, [&](uint64_t src, uint64_t dst) {
+            *edge++ = Edge{ src, dst };
+        });
+    }, thread_count);
+}
+
+} // namespace detail
+
+/**
+ * @brief Runs a graph generator on several threads and returns its edges in memory.
+ *
+ * The work of every generator of this file is split into chunks, and chunk `c` draws from an
+ * engine seeded with `stream_seed(seed, c)`. The number and contents of the chunks only depend
+ * on the parameters of the generator, so the generated graph is identical whatever the number
+ * of threads. A generator provides:
+ * - `size_t chunk_count() const`
+ * - `uint64_t count(size_t chunk) const`, the exact number of edges of a chunk
+ * - `void generate(size_t chunk, Emit&& emit) const`, calling `emit(src, dst)` for each edge
+ *
+ * Knowing the exact size of each chunk up front allows the drivers to write every chunk directly
+ * at its final position, with no intermediate buffer and no lock.
+ *
+ * @tparam Generator A generator of this file (`ErdosRenyi`, `ChungLu`, `RMAT`, `BarabasiAlbert`) or any type with the same interface.
+ *
+ * @param g The generator.
+ * @param thread_count The number of threads to use, or zero to use every hardware thread.
+ * @return The edges, in chunk order. The result does not depend on the number of threads.
+ */
+template <typename Generator>
+std::vector<Edge> generate_edges(const Generator& g, unsigned thread_count = 0)
+{
+    const std::vector<uint64_t> offsets = detail::chunk_offsets(g, thread_count);
+    std::vector<Edge> edges(offsets.back());
+    detail::generate_chunks(g, offsets, edges.data(), thread_count);
+    return edges;
+}
+
+/**
+ * @brief Runs a graph generator on several threads and writes its edges to a binary file.
+ *
+ * On POSIX systems the file is sized up front and memory-mapped, and every thread writes its
+ * chunks directly into the mapping, so there is no intermediate buffer and no copy. Elsewhere,
+ * chunks are generated in parallel batches and appended with large sequential writes.
+ * The file content does not depend on the number of threads.
+ *
+ * @tparam Generator A generator of this file or any type with the interface described in `generate_edges()`.
+ *
+ * @param path The path of the file to create or truncate.
+ * @param g The generator.
+ * @param thread_count The number of threads to use, or zero to use every hardware thread.
+ * @return The number of edges written.
+ *
+ * @throws std::system_error If the file cannot be created, resized, mapped or written.
+ */
+template <typename Generator>
+uint64_t write_edges(const std::string& path, const Generator& g, unsigned thread_count = 0)
+{
+    const std::vector<uint64_t> offsets = detail::chunk_offsets(g, thread_count);
+    const uint64_t edge_count = offsets.back();
+    const uint64_t bytes = edge_count * sizeof(Edge);
+
+#if BPR_HAS_MMAP
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "bpr: cannot create " + path);
+    }
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        const int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "bpr: cannot resize " + path);
+    }
+    if (bytes == 0) {
+        ::close(fd);
+        return 0;
+    }
+
+    void* mapping = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        const int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "bpr: cannot map " + path);
+    }
+
+    detail::generate_chunks(g, offsets, static_cast<Edge*>(mapping), thread_count);
+
+    ::munmap(mapping, bytes);
+    ::close(fd);
+#else
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        throw std::system_error(errno, std::generic_category(), "bpr: cannot create " + path);
+    }
+
+    // Generate one chunk per thread at a time, then write the batch in order
+    const size_t chunks = offsets.size() - 1;
+    const unsigned batch = thread_count_for(chunks, thread_count);
+    std::vector<std::vector<Edge>> buffers(batch);
+
+    for (size_t first = 0; first < chunks; first += batch) {
+        const size_t count = std::min<size_t>(batch, chunks - first);
+        parallel_for(count, [&](size_t i, unsigned) {
+            std::vector<Edge>& buffer = buffers[i];
+            buffer.clear();
+            buffer.reserve(static_cast<size_t>(offsets[first + i + 1] - offsets[first + i]));
+            g.generate(first + i, [&](uint64_t src, uint64_t dst) {
+                buffer.push_back(Edge{ src, dst });
+            });
+        }, thread_count);
+
+        for (size_t i = 0; i < count; ++i) {
+            if (std::fwrite(buffers[i].data(), sizeof(Edge), buffers[i].size(), file) != buffers[i].size()) {
+                const int error = errno;
+                std::fclose(file);
+                throw std::system_error(error, std::generic_category(), "bpr: cannot write " + path);
+            }
+        }
+    }
+
+    std::fclose(file);
+#endif
+
+    return edge_count;
+}
+
+}} // namespace bpr::graph
+
+#endif // BPR_GRAPH_HPP
@@ -0,0 +1,496 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_INIT_HPP
+#define BPR_INIT_HPP
+
+#include "distributions.hpp"
+#include "generator.hpp"
+#include "rounding.hpp"
+#include "parallel.hpp"
+#include "engine.hpp"
+#include "utils.hpp"
+#include "prng.hpp"
+
+#include <type_traits>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <cmath>
+
+namespace bpr { namespace init {
+
+namespace detail {
+
+/**
+ * @brief Number of values of a task: each task owns an engine seeded with `stream_seed(seed, task)`.
+ */
+inline constexpr size_t CHUNK = size_t(1) << 16;
+
+/**
+ * @brief Number of 64-bit words generated per tile, each giving two single-precision values.
+ */
+inline constexpr size_t TILE_WORDS = ::bpr::detail::DISTRIBUTION_TILE_WORDS;
+
+/**
+ * @brief Type in which the values are computed: double for double tensors, float otherwise.
+ */
+template <typename T>
+using real_t = std::conditional_t<std::is_same_v<T, double>, double, float>;
+
+template <typename T>
+inline T store(real_t<T> value) noexcept
+{
+    if constexpr (std::is_same_v<T, bfloat16>) {
+        return to_bfloat16(value);
+    } else {
+        return value;
+    }
+}
+
+/**
+ * @brief Natural logarithm of a positive normal float, without branches (Cephes `logf` polynomial).
+ */
+inline float fast_log(float x) noexcept
+{
+    const uint32_t bits = ::bpr::detail::float_bits(x);
+    float m = ::bpr::detail::bits_float((bits & 0x7FFFFF) | 0x3F000000);    // Mantissa in [0.5, 1)
+    float e = static_cast<float>(static_cast<int>(bits >> 23) - 126);
+
+    // Center the mantissa on 1: [sqrt(0.5), sqrt(2))
+    const bool small = m < 0.70710678118654752f;
+    e = small ? e - 1.0f : e;
+    m = small ? m + m - 1.0f : m - 1.0f;
+
+    const float z = m * m;
+    float y = 7.0376836292e-2f;
+    y = y * m - 1.1514610310e-1f;
+    y = y * m + 1.1676998740e-1f;
+    y = y * m - 1.2420140846e-1f;
+    y = y * m + 1.4249322787e-1f;
+    y = y * m - 1.6668057665e-1f;
+    y = y * m + 2.0000714765e-1f;
+    y = y * m - 2.4999993993e-1f;
+    y = y * m + 3.3333331174e-1f;
+    y = y * m * z;
+    y += -2.12194440e-4f * e;
+    y += -0.5f * z;
+    return m + y + 0.693359375f * e;
+}
+
+/**
+ * @brief Square root of a positive normal float: bit-level estimate of 1 / sqrt(x) and three Newton steps.
+ *
+ * Unlike `std::sqrt()`, which has to set errno for negative inputs unless compiled with
+ * `-fno-math-errno`, it does not prevent the vectorization of the loops that call it.
+ */
+inline float fast_sqrt(float x) noexcept
+{
+    float y = ::bpr::detail::bits_float(0x5F375A86 - (::bpr::detail::float_bits(x) >> 1));
+    y = y * (1.5f - 0.5f * x * y * y);
+    y = y * (1.5f - 0.5f * x * y * y);
+    y = y * (1.5f - 0.5f * x * y * y);
+    return x * y;
+}
+
+/**
+ * @brief Fills `out` with `n` (at most 2 * TILE_WORDS) values uniform in [0, 1).
+ *
+ * Single precision values take 24 bits each, two per word; double precision values take 53 bits of one word.
+ */
+template <typename Real, typename Engine>
+void uniform_tile(Engine& e, Real* out, size_t n) noexcept
+{
+    uint64_t words[TILE_WORDS];
+    if constexpr (std::is_same_v<Real, double>) {
+        fill(e, words, n);
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = ::bpr::detail::unit_closed_open<double>(words[i]);
+        }
+    } else {
+        constexpr float inv_2_24 = 1.0f / 16777216.0f;
+        const size_t pairs = (n + 1) / 2;
+        float values[2 * TILE_WORDS];
+        fill(e, words, pairs);
+        for (size_t w = 0; w < pairs; ++w) {
+            values[2 * w + 0] = static_cast<float>(words[w] >> 40) * inv_2_24;
+            values[2 * w + 1] = static_cast<float>((words[w] >> 8) & 0xFFFFFF) * inv_2_24;
+        }
+        std::copy(values, values + n, out);
+    }
+}
+
+/**
+ * @brief Fills `out` with `n` (at most 2 * TILE_WORDS) standard normal values.
+ *
+ * Double precision values come from `fill_normal()`. Single precision values use a Box-Muller
+ * transform on one word per pair: 24 bits give the radius, 2 bits the quadrant of the angle and
+ * 24 bits its position within the quadrant, so that the sine and cosine only need the Cephes
+ * polynomials on [-pi/4, pi/4]. With `fast_log()` and `fast_sqrt()`, the loop has no branch and
+ * no libm call and is vectorized by the compiler. The radius is at most sqrt(50 log 2), about 5.9 standard deviations.
+ */
+template <typename Real, typename Engine>
+void normal_tile(Engine& e, Real* out, size_t n) noexcept
+{
+    if constexpr (std::is_same_v<Real, double>) {
+        fill_normal(e, out, n);
+    } else {
+        constexpr float inv_2_24 = 1.0f / 16777216.0f;
+        constexpr float half_pi = 1.5707963267948966f;
+        const size_t pairs = (n + 1) / 2;
+        uint64_t words[TILE_WORDS];
+        float values[2 * TILE_WORDS];
+        fill(e, words, pairs);
+
+        for (size_t w = 0; w < pairs; ++w) {
+            const uint64_t word = words[w];
+            const float u = (static_cast<float>(word >> 40) + 0.5f) * inv_2_24;
+            const float r = fast_sqrt(-2.0f * fast_log(u));
+
+            const uint32_t quadrant = static_cast<uint32_t>(word >> 38) & 3;
+            const float y = (static_cast<float>(word & 0xFFFFFF) * inv_2_24 - 0.5f) * half_pi;
+            const float z = y * y;
+            const float s = y + y * z * ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f);
+            const float c = 1.0f - 0.5f * z + z * z * ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f);
+
+            // Rotate (c, s) by quadrant * pi / 2
+            const bool swap = quadrant & 1;
+            const float cos_q = swap ? s : c;
+            const float sin_q = swap ? c : s;
+            const float cos_sign = (quadrant == 1 || quadrant == 2) ? -1.0f : 1.0f;
+            const float sin_sign = quadrant >= 2 ? -1.0f : 1.0f;
+            values[2 * w + 0] = r * cos_q * cos_sign;
+            values[2 * w + 1] = r * sin_q * sin_sign;
+        }
+        std::copy(values, values + n, out);
+    }
+}
+
+/**
+ * @brief Runs `chunk(engine, out + begin, n)` over chunks of CHUNK values, in parallel.
+ */
+template <typename Engine, typename T, typename Chunk>
+void for_each_chunk(uint64_t seed, T* out, size_t count, unsigned thread_count, Chunk&& chunk)
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double> || std::is_same_v<T, bfloat16>,
+                  "T must be float, double or bpr::bfloat16");
+
+    const size_t chunks = (count + CHUNK - 1) / CHUNK;
+    parallel_for(chunks, [&](size_t c, unsigned) {
+        // The stream of a chunk only depends on its index
+        Engine e(stream_seed(seed, c));
+        const size_t begin = c * CHUNK;
+        chunk(e, out + begin, std::min(CHUNK, count - begin));
+    }, thread_count);
+}
+
+/**
+ * @brief Standard normal cumulative distribution function.
+ */
+inline double normal_cdf(double x) noexcept
+{
+    return 0.5 * std::erfc(-x * 0.70710678118654752440);
+}
+
+/**
+ * @brief Inverse of `normal_cdf()` for p in (0, 1): Acklam's rational approximation refined by one Halley step.
+ */
+inline double normal_quantile(double p) noexcept
+{
+    static constexpr double a[] = { -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                                    1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+    static constexpr double b[] = { -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                                    6.680131188771972e+01, -1.328068155288572e+01 };
+    static constexpr double c[] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                                    -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+    static constexpr double d[] = { 7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                                    3.754408661907416e+00 };
+
+    double x;
+    if (p < 0.02425 || p > 0.97575) {
+        const double q = std::sqrt(-2.0 * std::log(p < 0.5 ? p : 1.0 - p));
+        x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+            ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+        if (p > 0.5) x = -x;
+    } else {
+        const double q = p - 0.5;
+        const double r = q * q;
+        x = (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+            (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+    }
+
+    // Halley step on normal_cdf(x) - p
+    const double err = normal_cdf(x) - p;
+    const double u = err * 2.50662827463100050242 * std::exp(0.5 * x * x);
+    return x - u / (1.0 + 0.5 * x * u);
+}
+
+} // namespace detail
+
+/**
+ * @brief Fills a tensor with values uniform in [min, max), in parallel.
+ *
+ * All the functions of this namespace split the tensor into chunks of 65536 values, chunk `c`
+ * being generated by an engine seeded with `stream_seed(seed, c)`: the result only depends on
+ * the seed, never on the number of threads. Random words are produced in tiles through the bulk
+ * path of the engine and converted by branch-free loops that the compiler vectorizes. Float and
+ * bfloat16 tensors are generated in single precision (24 random bits per value, bfloat16 being
+ * rounded to nearest), double tensors in double precision.
+ *
+ * @tparam Engine The engine of each chunk. It must be constructible from a 64-bit seed.
+ * @tparam T float, double or `bpr::bfloat16`.
+ *
+ * @param seed The seed of the initialization.
+ * @param out The tensor, as a contiguous array.
+ * @param count The number of values.
+ * @param thread_count The number of threads to use, or zero to use every hardware thread.
+ */
+template <typename Engine = prng::Xoshiro256ss, typename T>
+void uniform(uint64_t seed, T* out, size_t count, double min, double max, unsigned thread_count = 0)
+{
+    using Real = detail::real_t<T>;
+    const Real lo = static_cast<Real>(min);
+    const Real span = static_cast<Real>(max - min);
+
+    detail::for_each_chunk<Engine>(seed, out, count, thread_count, [&](Engine& e, T* chunk, size_t n) {
+        constexpr size_t TILE = 2 * detail::TILE_WORDS;
+        Real values[TILE];
+        for (size_t i = 0; i < n; i += TILE) {
+            const size_t m = std::min(n - i, TILE);
+            detail::uniform_tile(e, values, m);
+            for (size_t k = 0; k < m; ++k) {
+                chunk[i + k] = detail::store<T>(lo + span * values[k]);
+            }
+        }
+    });
+}
+
+/**
+ * @brief Fills a tensor with normally distributed values, in parallel (see `uniform()`).
+ *
+ * Single precision values are limited to about 5.9 standard deviations from the mean.
+ */
+template <typename Engine = prng::Xoshiro256ss, typename T>
+void normal(uint64_t seed, T* out, size_t count, double mean = 0.0, double stddev = 1.0, unsigned thread_count = 0)
+{
+    using Real = detail::real_t<T>;
+    const Real mu = static_cast<Real>(mean);
+    const Real sigma = static_cast<Real>(stddev);
+
+    detail::for_each_chunk<Engine>(seed, out, count, thread_count, [&](Engine& e, T* chunk, size_t n) {
+        constexpr size_t TILE = 2 * detail::TILE_WORDS;
+        Real values[TILE];
+        for (size_t i = 0; i < n; i += TILE) {
+            const size_t m = std::min(n - i, TILE);
+            detail::normal_tile(e, values, m);
+            for (size_t k = 0; k < m; ++k) {
+                chunk[i + k] = detail::store<T>(mu + sigma * values[k]);
+            }
+        }
+    });
+}
+
+/**
+ * @brief Fills a tensor with a normal distribution truncated to [a, b], in parallel (see `uniform()`).
+ *
+ * As in PyTorch's `trunc_normal_`, `a` and `b` are absolute bounds. When the interval holds at
+ * least a quarter of the probability mass (e.g. the usual +/- 2 standard deviations), values are
+ * drawn by rejection: each tile of normal values is compacted without branches, keeping those in
+ * range. Otherwise the inverse CDF is applied to uniform values in double precision, computed in
+ * the lower tail for accuracy.
+ *
+ * @param a The lower bound, smaller than `b`.
+ * @param b The upper bound.
+ */
+template <typename Engine = prng::Xoshiro256ss, typename T>
+void truncated_normal(uint64_t seed, T* out, size_t count, double mean = 0.0, double stddev = 1.0,
+                      double a = -2.0, double b = 2.0, unsigned thread_count = 0)
+{
+    using Real = detail::real_t<T>;
+    const Real mu = static_cast<Real>(mean);
+    const Real sigma = static_cast<Real>(stddev);
+
+    // Standardized bounds, mirrored into the lower tail when the interval is above the mean
+    const bool mirror = a > mean;
+    const double alpha = mirror ? (mean - b) / stddev : (a - mean) / stddev;
+    const double beta = mirror ? (mean - a) / stddev : (b - mean) / stddev;
+    const double cdf_alpha = detail::normal_cdf(alpha);
+    const double mass = detail::normal_cdf(beta) - cdf_alpha;
+
+    if (mass >= 0.25) {
+        const Real lo = static_cast<Real>(alpha);
+        const Real hi = static_cast<Real>(beta);
+        const Real scale = mirror ? -sigma : sigma;
+
+        detail::for_each_chunk<Engine>(seed, out, count, thread_count, [&](Engine& e, T* chunk, size_t n) {
+            constexpr size_t TILE = 2 * detail::TILE_WORDS;
+            Real values[TILE];
+            Real kept[TILE];
+            size_t i = 0;
+            while (i < n) {
+                detail::normal_tile(e, values, TILE);
+                size_t k = 0;
+                for (size_t j = 0; j < TILE; ++j) {
+                    kept[k] = values[j];
+                    k += static_cast<size_t>(values[j] >= lo && values[j] <= hi);
+                }
+                k = std::min(k, n - i);
+                for (size_t j = 0; j < k; ++j) {
+                    chunk[i + j] = detail::store<T>(mu + scale * kept[j]);
+                }
+                i += k;
+            }
+        });
+    } else {
+        detail::for_each_chunk<Engine>(seed, out, count, thread_count, [&](Engine& e, T* chunk, size_t n) {
+            constexpr size_t TILE = detail::TILE_WORDS;
+            uint64_t words[TILE];
+            for (size_t i = 0; i < n; i += TILE) {
+                const size_t m = std::min(n - i, TILE);
+                fill(e, words, m);
+                for (size_t k = 0; k < m; ++k) {
+                    const double p = cdf_alpha + mass * ::bpr::detail::unit_open<double>(words[k]);
+                    const double x = std::min(beta, std::max(alpha, detail::normal_quantile(p)));
+                    chunk[i + k] = detail::store<T>(static_cast<Real>(mirror ? mean - stddev * x : mean + stddev * x));
+                }
+            }
+        });
+    }
+}
+
+/**
+ * @brief Xavier (Glorot) uniform initialization: U(-bound, bound) with `bound = gain * sqrt(6 / (fan_in + fan_out))`.
+ */
+template <typename Engine = prng::Xoshiro256ss, typename T>
+void xavier_uniform(uint64_t seed, T* out, size_t count, size_t fan_in, size_t fan_out,
+                    double gain = 1.0, unsigned thread_count = 0)
+{
+    const double bound = gain * std::sqrt(6.0 / static_cast<double>(fan_in + fan_out));
+    uniform<Engine>(seed, out, count, -bound, bound, thread_count);
+}
+
+/**
+ * @brief Xavier (Glorot) normal initialization: N(0, std^2) with `std = gain * sqrt(2 / (fan_in + fan_out))`.
+ */
+template <typename Engine = prng::Xoshiro256ss, typename T>
+void xavier_normal(uint64_t seed, T* out, size_t count, size_t fan_in, size_t fan_out,
+                   double gain = 1.0, unsigned thread_count = 0)
+{
+    const double stddev = gain * std::sqrt(2.0 / static_cast<double>(fan_in + fan_out));
+    normal<Engine>(seed, out, count, 0.0, stddev, thread_count);
+}
+
+/**
+ * @brief He (Kaiming) uniform initialization: U(-bound, bound) with `bound = gain * sqrt(3 / fan)`.
+ *
+ * @param fan `fan_in` to preserve the variance of the activations, `fan_out` for the gradients.
+ * @param gain sqrt(2) for ReLU layers.
+ */
+template <typename Engine = prng::Xoshiro256ss, typename T>
+void he_uniform(uint64_t seed, T* out, size_t count, size_t fan,
+                double gain = 1.4142135623730951, unsigned thread_count = 0)
+{
+    const double bound = gain * std::sqrt(3.0 / static_cast<double>(fan));
+    uniform<Engine>(seed, out, count, -bound, bound, thread_count);
+}
+
+/**
+ * @brief He (Kaiming) normal initialization: N(0, std^2) with `std = gain / sqrt(fan)`.
+ */
+template <typename Engine = prng::Xoshiro256ss, typename T>
+void he_normal(uint64_t seed, T* out, size_t count, size_t fan,
+               double gain = 1.4142135623730951, unsigned thread_count = 0)
+{
+    const double stddev = gain / std::sqrt(static_cast<double>(fan));
+    normal<Engine>(seed, out, count, 0.0, stddev, thread_count);
+}
+
+/**
+ * @brief Orthogonal initialization of a `rows x cols` row-major matrix, scaled by `gain`.
+ *
+ * The rows (if `rows <= cols`) or the columns are orthonormal and uniformly distributed (Haar
+ * measure): `min(rows, cols)` Gaussian vectors are orthonormalized by block Gram-Schmidt with
+ * reorthogonalization, which gives the same distribution as the sign-corrected QR decomposition
+ * used by other frameworks. Vector `v` is drawn from `stream_seed(seed, v)`. Each block of 32
+ * vectors is first projected out of the previous blocks in parallel, one task per vector, then
+ * orthonormalized sequentially; every sum is taken in a fixed order so the result does not depend
+ * on the number of threads. The computation is in double precision, in a scratch buffer of
+ * `rows * cols` doubles, and costs O(min(rows, cols)^2 max(rows, cols)).
+ */
+template <typename Engine = prng::Xoshiro256ss, typename T>
+void orthogonal(uint64_t seed, T* out, size_t rows, size_t cols, double gain = 1.0, unsigned thread_count = 0)
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double> || std::is_same_v<T, bfloat16>,
+                  "T must be float, double or bpr::bfloat16");
+
+    constexpr size_t BLOCK = 32;
+    const size_t k = std::min(rows, cols);
+    const size_t n = std::max(rows, cols);
+    std::vector<double> q(k * n);
+
+    parallel_for(k, [&](size_t v, unsigned) {
+        Engine e(stream_seed(seed, v));
+        fill_normal(e, q.data() + v * n, n);
+    }, thread_count);
+
+    // Removes from `x` its components along vectors [first, last), twice
+    auto project_out = [&](double* x, size_t first, size_t last) {
+        for (int pass = 0; pass < 2; ++pass) {
+            for (size_t j = first; j < last; ++j) {
+                const double* y = q.data() + j * n;
+                double dot = 0.0;
+                for (size_t i = 0; i < n; ++i) dot += x[i] * y[i];
+                for (size_t i = 0; i < n; ++i) x[i] -= dot * y[i];
+            }
+        }
+    };
+
+    for (size_t block = 0; block < k; block += BLOCK) {
+        const size_t end = std::min(k, block + BLOCK);
+        parallel_for(end - block, [&](size_t v, unsigned) {
+            project_out(q.data() + (block + v) * n, 0, block);
+        }, thread_count);
+
+        for (size_t v = block; v < end; ++v) {
+            double* x = q.data() + v * n;
+            project_out(x, block, v);
+            double norm = 0.0;
+            for (size_t i = 0; i < n; ++i) norm += x[i] * x[i];
+            const double scale = 1.0 / std::sqrt(norm);
+            for (size_t i = 0; i < n; ++i) x[i] *= scale;
+        }
+    }
+
+    using Real = detail::real_t<T>;
+    for (size_t r = 0; r < rows; ++r) {
+        for (size_t c = 0; c < cols; ++c) {
+            const double value = rows <= cols ? q[r * n + c] : q[c * n + r];
+            out[r * cols + c] = detail::store<T>(static_cast<Real>(gain * value));
+        }
+    }
+}
+
+}} // namespace bpr::init
+
+#endif // BPR_INIT_HPP
@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event 
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial 
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you 
+ *   wrote the original software. If you use this software in a product, an acknowledgment 
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_MULTILANE_HPP
+#define BPR_MULTILANE_HPP
+
+#include "engine.hpp"
+#include "utils.hpp"
+#include "simd.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+namespace bpr { namespace prng {
+
+/**
+ * @class Xoshiro256ssX8
+ * @brief Eight interleaved Xoshiro256** streams, computed together with SIMD instructions.
+ * 
+ * Word `8 * i + l` of the output is output `i` of lane `l`, and lane `l` is exactly the stream
+ * of `Xoshiro256ss(stream_seed(seed, l))`. A single Xoshiro256 stream cannot be vectorized, as
+ * each step depends on the previous one, but eight independent lanes fill one AVX-512 register
+ * (two AVX2 or four SSE2 registers). The number of lanes is part of the definition of the
+ * stream, so the output is the same on every CPU, whatever backend `bpr::simd` selects.
+ * 
+ * Best suited for:
+ * - Bulk generation through `fill()`, several times faster than `Xoshiro256ss`
+ * - Callers that need the same stream on hosts with different instruction sets
+ * 
+ * Performance characteristics:
+ * - Period: 2^256 - 1 per lane
+ * - State size: 8 x 256 bits, plus a buffer of one round
+ * 
+ * @see bpr::simd for the stream-layout contract of multi-lane engines
+ */
+class Xoshiro256ssX8 : public IEngine<uint64_t, 32>
+{
+public:
+    static constexpr size_t LANES = 8;
+
+    explicit Xoshiro256ssX8(uint64_t seed = compile_time()) noexcept
+        : IEngine({})
+    {
+        // Word j of lane l is stored at index j * LANES + l
+        for (size_t l = 0; l < LANES; ++l) {
+            const uint64_t lane_seed = stream_seed(seed, l);
+            for (size_t j = 0; j < 4; ++j) {
+                m_state[j * LANES + l] = splitmix64(lane_seed + j);
+            }
+        }
+    }
+
+    uint64_t next() noexcept override {
+        if (m_position == LANES) {
+            simd::xoshiro256ss_x8(m_state.data(), m_buffer, 1);
+            m_position = 0;
+        }
+        return m_buffer[m_position++];
+    }
+
+    /**
+     * @brief Fills a buffer with the words of `count` calls to `next()`.
+     * 
+     * The rest of the current round is served first, then whole rounds are written directly to
+     * `out`, and a final partial round is buffered for the next calls.
+     */
+    void fill(uint64_t* out, size_t count) noexcept {
+        const size_t available = LANES - m_position;
+        const size_t buffered = count < available ? count : available;
+        std::memcpy(out, m_buffer + m_position, buffered * sizeof(uint64_t));
+        m_position += buffered;
+        out += buffered;
+        count -= buffered;
+
+        const size_t rounds = count / LANES;
+        simd::xoshiro256ss_x8(m_state.data(), out, rounds);
+        out += rounds * LANES;
+        count -= rounds * LANES;
+
+        while (count-- > 0) {
+            *out++ = next();
+        }
+    }
+
+private:
+    uint64_t m_buffer[LANES] = {};
+    size_t m_position = LANES;
+};
+
+}} // namespace bpr::prng
+
+#endif // BPR_MULTILANE_HPP
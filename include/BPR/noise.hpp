@@ -0,0 +1,341 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_NOISE_HPP
+#define BPR_NOISE_HPP
+
+#include "generator.hpp"
+#include "engine.hpp"
+
+#include <type_traits>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+namespace bpr {
+
+/**
+ * @brief Packed little-endian 24-bit PCM sample.
+ */
+struct int24
+{
+    uint8_t bytes[3];
+};
+
+namespace detail {
+
+/**
+ * @brief Number of 64-bit words generated per tile by the noise generators (2 KiB, on the stack).
+ */
+inline constexpr size_t NOISE_TILE_WORDS = 256;
+
+/**
+ * @brief Converts the signed 32-bit value of a half word to a float in [-1, 1).
+ *
+ * Only the top 24 bits are kept, which a float represents exactly: converting all 32 bits would
+ * round values close to 2^31 up to exactly 1.
+ */
+inline float signed_unit(uint32_t bits) noexcept
+{
+    constexpr float inv_2_23 = 1.0f / 8388608.0f;
+    return static_cast<float>(static_cast<int32_t>(bits) >> 8) * inv_2_23;
+}
+
+/**
+ * @brief Full-scale value of each sample format.
+ *
+ * Scaling is done in double: above 2^22 the ulp of a float is half an LSB of a 24-bit sample,
+ * which would swallow the rounding offset and most of the dither.
+ */
+template <typename Sample>
+inline constexpr double SAMPLE_SCALE = std::is_same_v<Sample, int16_t> ? 32767.0 : 8388607.0;
+
+/**
+ * @brief Stores a sample already scaled to the integer range and clamped, rounding to nearest.
+ */
+inline void store_scaled(double x, int16_t& out) noexcept
+{
+    out = static_cast<int16_t>(std::floor(x + 0.5));
+}
+
+inline void store_scaled(double x, int24& out) noexcept
+{
+    const int32_t v = static_cast<int32_t>(std::floor(x + 0.5));
+    out.bytes[0] = static_cast<uint8_t>(v);
+    out.bytes[1] = static_cast<uint8_t>(v >> 8);
+    out.bytes[2] = static_cast<uint8_t>(v >> 16);
+}
+
+/**
+ * @brief Converts float samples in [-1, 1] (clamped otherwise) to the output format.
+ */
+template <typename Sample>
+inline void store_samples(const float* in, Sample* out, size_t count) noexcept
+{
+    static_assert(std::is_same_v<Sample, float> || std::is_same_v<Sample, int16_t> || std::is_same_v<Sample, int24>,
+                  "Sample must be float, int16_t or bpr::int24");
+
+    if constexpr (std::is_same_v<Sample, float>) {
+        std::copy(in, in + count, out);
+    } else {
+        constexpr double scale = SAMPLE_SCALE<Sample>;
+        for (size_t i = 0; i < count; ++i) {
+            store_scaled(static_cast<double>(std::min(1.0f, std::max(-1.0f, in[i]))) * scale, out[i]);
+        }
+    }
+}
+
+/**
+ * @brief Index of the lowest set bit of a non-zero value, by de Bruijn multiplication (no branch, no intrinsic).
+ */
+constexpr unsigned ctz32(uint32_t x) noexcept
+{
+    constexpr uint8_t table[32] = {
+        0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+        31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+    };
+    return table[((x & (0u - x)) * 0x077CB531u) >> 27];
+}
+
+} // namespace detail
+
+/**
+ * @class WhiteNoise
+ * @brief Block generator of white noise, with a rectangular or triangular (TPDF) distribution.
+ *
+ * Each 64-bit word gives two rectangular samples (one per 32-bit half) or one triangular sample
+ * (the sum of the two halves). Words are generated in tiles through the bulk path of the engine
+ * (`bpr::fill()`), which calls the concrete engine directly, never through the virtual `next()`,
+ * and the conversion loops have no branch. `generate()` allocates nothing and its cost is
+ * proportional to the block size, so it can run on a real-time audio thread.
+ *
+ * @example
+ * ```cpp
+ * bpr::prng::Xoshiro256ss engine(seed);
+ * bpr::WhiteNoise noise(0.5f);
+ * noise.generate(engine, block, frames);
+ * ```
+ */
+class WhiteNoise
+{
+public:
+    enum class Shape
+    {
+        Rectangular,    ///< Uniform in [-amplitude, amplitude)
+        Triangular      ///< Sum of two uniforms: triangular in [-amplitude, amplitude)
+    };
+
+    explicit WhiteNoise(float amplitude = 1.0f, Shape shape = Shape::Rectangular) noexcept
+        : m_amplitude(amplitude), m_shape(shape)
+    { }
+
+    /**
+     * @brief Writes `count` samples to `out` (float, int16_t or int24; integers are full scale for amplitude 1).
+     */
+    template <typename Engine, typename Sample>
+    void generate(Engine& e, Sample* out, size_t count) const noexcept {
+        // Assert that the Engine type is valid (derived from IEngine)
+        static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+        constexpr size_t TILE = detail::NOISE_TILE_WORDS;
+        uint64_t words[TILE];
+        float block[2 * TILE];
+
+        for (size_t i = 0; i < count; ) {
+            size_t n;
+            if (m_shape == Shape::Rectangular) {
+                n = std::min(count - i, 2 * TILE);
+                fill(e, words, (n + 1) / 2);
+                for (size_t w = 0; w < (n + 1) / 2; ++w) {
+                    block[2 * w + 0] = m_amplitude * detail::signed_unit(static_cast<uint32_t>(words[w]));
+                    block[2 * w + 1] = m_amplitude * detail::signed_unit(static_cast<uint32_t>(words[w] >> 32));
+                }
+            } else {
+                n = std::min(count - i, TILE);
+                fill(e, words, n);
+                for (size_t w = 0; w < n; ++w) {
+                    const float half = 0.5f * m_amplitude;
+                    block[w] = half * (detail::signed_unit(static_cast<uint32_t>(words[w])) +
+                                       detail::signed_unit(static_cast<uint32_t>(words[w] >> 32)));
+                }
+            }
+            detail::store_samples(block, out + i, n);
+            i += n;
+        }
+    }
+
+private:
+    float m_amplitude;
+    Shape m_shape;
+};
+
+/**
+ * @brief Quantizes float samples in [-1, 1] to int16_t or 24-bit PCM with TPDF dither.
+ *
+ * Triangular dither of 2 LSB peak to peak, the sum of the two 32-bit halves of one random word,
+ * is added before rounding, which makes the quantization error independent of the signal (no
+ * harmonic distortion, only a constant noise floor). Out-of-range samples are clipped.
+ *
+ * @param e The random engine.
+ * @param in The float samples.
+ * @param out Receives the integer samples.
+ * @param count The number of samples.
+ */
+template <typename Engine, typename Sample>
+void tpdf_dither(Engine& e, const float* in, Sample* out, size_t count) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+    static_assert(std::is_same_v<Sample, int16_t> || std::is_same_v<Sample, int24>, "Sample must be int16_t or bpr::int24");
+
+    constexpr size_t TILE = detail::NOISE_TILE_WORDS;
+    constexpr double scale = detail::SAMPLE_SCALE<Sample>;
+    constexpr double half_lsb = 1.0 / 4294967296.0;     // Each signed half spans [-0.5, 0.5) LSB
+    uint64_t words[TILE];
+
+    for (size_t i = 0; i < count; i += TILE) {
+        const size_t n = std::min(count - i, TILE);
+        fill(e, words, n);
+        for (size_t k = 0; k < n; ++k) {
+            // In double, exactly: the dither and the rounding offset survive near full scale
+            const double dither = (static_cast<double>(static_cast<int32_t>(words[k])) +
+                                   static_cast<double>(static_cast<int32_t>(words[k] >> 32))) * half_lsb;
+            const double v = static_cast<double>(in[i + k]) * scale + dither;
+            detail::store_scaled(std::min(scale, std::max(-scale, v)), out[i + k]);
+        }
+    }
+}
+
+/**
+ * @class PinkNoise
+ * @brief Pink (1/f) noise by the Voss-McCartney algorithm.
+ *
+ * The output is the sum of `ROWS` random values and one white value. At sample `k`, the row
+ * given by the number of trailing zeros of `k` is redrawn, so row `r` changes every 2^(r+1)
+ * samples, and each row contributes one octave of the spectrum. The row index is computed
+ * without branch (de Bruijn `ctz`) and the sum is updated incrementally, so each sample costs
+ * one 64-bit random word (two 24-bit values: the new row value and the white one) and a few
+ * integer operations. 16 rows give a 1/f slope down to about 1 Hz at 48 kHz.
+ */
+class PinkNoise
+{
+public:
+    static constexpr unsigned ROWS = 16;
+
+    /**
+     * @param amplitude Peak amplitude: the output never exceeds it. The RMS level is about a seventh of it.
+     */
+    explicit PinkNoise(float amplitude = 1.0f) noexcept
+        : m_scale(amplitude / static_cast<float>((ROWS + 1) << 23))
+    { }
+
+    template <typename Engine, typename Sample>
+    void generate(Engine& e, Sample* out, size_t count) noexcept {
+        // Assert that the Engine type is valid (derived from IEngine)
+        static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+        constexpr size_t TILE = detail::NOISE_TILE_WORDS;
+        uint64_t words[TILE];
+        float block[TILE];
+
+        for (size_t i = 0; i < count; i += TILE) {
+            const size_t n = std::min(count - i, TILE);
+            fill(e, words, n);
+            for (size_t k = 0; k < n; ++k) {
+                // Counter never zero: the last row takes the rare samples with ctz >= ROWS - 1
+                m_counter = m_counter + 1 ? m_counter + 1 : 1;
+                const unsigned row = std::min(detail::ctz32(m_counter), ROWS - 1);
+                const int32_t value = static_cast<int32_t>(static_cast<uint32_t>(words[k])) >> 8;
+                const int32_t white = static_cast<int32_t>(static_cast<uint32_t>(words[k] >> 32)) >> 8;
+                m_sum += value - m_rows[row];
+                m_rows[row] = value;
+                block[k] = static_cast<float>(m_sum + white) * m_scale;
+            }
+            detail::store_samples(block, out + i, n);
+        }
+    }
+
+private:
+    int32_t m_rows[ROWS] = {};
+    int32_t m_sum = 0;
+    uint32_t m_counter = 0;
+    float m_scale;
+};
+
+/**
+ * @class BrownNoise
+ * @brief Brown (1/f^2) noise: white noise through a leaky integrator.
+ *
+ * `y[n] = leak * y[n-1] + w[n]`, scaled by sqrt(1 - leak^2) so that the RMS level does not
+ * depend on `leak`, and clipped to the amplitude (which happens beyond four standard
+ * deviations). The leak sets the corner frequency below which the spectrum flattens, about
+ * `(1 - leak) * sample_rate / (2 pi)`, and prevents the drift of a pure random walk. Each
+ * 64-bit word gives two white samples.
+ */
+class BrownNoise
+{
+public:
+    /**
+     * @param amplitude Peak amplitude. The RMS level is a quarter of it.
+     * @param leak Pole of the integrator, in (0, 1). 0.999 puts the corner at about 8 Hz at 48 kHz.
+     */
+    explicit BrownNoise(float amplitude = 1.0f, float leak = 0.999f) noexcept
+        : m_amplitude(amplitude)
+        , m_leak(leak)
+        , m_gain(amplitude * std::sqrt(3.0f * (1.0f - leak * leak)) / 4.0f)
+    { }
+
+    template <typename Engine, typename Sample>
+    void generate(Engine& e, Sample* out, size_t count) noexcept {
+        // Assert that the Engine type is valid (derived from IEngine)
+        static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+        constexpr size_t TILE = detail::NOISE_TILE_WORDS;
+        uint64_t words[TILE];
+        float block[2 * TILE];
+
+        for (size_t i = 0; i < count; i += 2 * TILE) {
+            const size_t n = std::min(count - i, 2 * TILE);
+            fill(e, words, (n + 1) / 2);
+            for (size_t w = 0; w < (n + 1) / 2; ++w) {
+                block[2 * w + 0] = detail::signed_unit(static_cast<uint32_t>(words[w]));
+                block[2 * w + 1] = detail::signed_unit(static_cast<uint32_t>(words[w] >> 32));
+            }
+            // The recursion is sequential; the scaling and clipping are done in the same pass
+            float y = m_state;
+            for (size_t k = 0; k < n; ++k) {
+                y = m_leak * y + block[k];
+                block[k] = std::min(m_amplitude, std::max(-m_amplitude, m_gain * y));
+            }
+            m_state = y;
+            detail::store_samples(block, out + i, n);
+        }
+    }
+
+private:
+    float m_amplitude;
+    float m_leak;
+    float m_gain;
+    float m_state = 0.0f;
+};
+
+} // namespace bpr
+
+#endif // BPR_NOISE_HPP
@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event 
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial 
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you 
+ *   wrote the original software. If you use this software in a product, an acknowledgment 
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+
+#ifndef BPR_PARALLEL_HPP
+#define BPR_PARALLEL_HPP
+
+#include <exception>
+#include <cstddef>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <mutex>
+
+namespace bpr {
+
+/**
+ * @brief Returns the number of worker threads to use for a parallel job.
+ * 
+ * When `requested` is zero, the number of hardware threads reported by the system is used.
+ * The result is never greater than `task_count` (there is no point in starting idle threads)
+ * and never smaller than one.
+ * 
+ * @param task_count The number of independent tasks of the job.
+ * @param requested The number of threads requested by the caller, or zero for automatic.
+ * @return The number of threads that `parallel_for` will use for this job.
+ */
+inline unsigned thread_count_for(size_t task_count, unsigned requested = 0) noexcept
+{
+    unsigned count = requested;
+    if (count == 0) {
+        count = std::thread::hardware_concurrency();
+    }
+    if (count > task_count) {
+        count = static_cast<unsigned>(task_count);
+    }
+    return count > 0 ? count : 1;
+}
+
+/**
+ * @brief Runs `fn(task_index, thread_index)` for every task index in [0, task_count) on a pool of threads.
+ * 
+ * Tasks are distributed dynamically through an atomic counter, so the assignment of tasks to
+ * threads is not deterministic. Algorithms built on top of this function must therefore derive
+ * their random streams from the task index (see `stream_seed()`), never from the thread index.
+ * The thread index, in [0, thread_count_for(task_count, thread_count)), is only meant to select
+ * per-thread scratch buffers.
+ * 
+ * The calling thread takes part in the work. If a task throws, the remaining tasks are skipped
+ * and the first exception is rethrown once all threads have joined.
+ * 
+ * @tparam Fn Callable type invocable as `fn(size_t task_index, unsigned thread_index)`.
+ * 
+ * @param task_count The number of tasks to run.
+ * @param fn The task body.
+ * @param thread_count The number of threads to use, or zero to use every hardware thread.
+ */
+template <typename Fn>
+void parallel_for(size_t task_count, Fn&& fn, unsigned thread_count = 0)
+{
+    thread_count = thread_count_for(task_count, thread_count);
+
+    // Run inline when there is nothing to parallelize
+    if (thread_count == 1) {
+        for (size_t i = 0; i < task_count; ++i) {
+            fn(i, 0u);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next_task{ 0 };
+    std::exception_ptr error = nullptr;
+    std::mutex error_mutex;
+
+    auto worker = [&](unsigned thread_index) {
+        try {
+            size_t task;
+            while ((task = next_task.fetch_add(1, std::memory_order_relaxed)) < task_count) {
+                fn(task, thread_index);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) error = std::current_exception();
+            // Make the other workers stop at their next task
+            next_task.store(task_count, std::memory_order_relaxed);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count - 1);
+    for (unsigned t = 1; t < thread_count; ++t) {
+        threads.emplace_back(worker, t);
+    }
+
+    worker(0);
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace bpr
+
+#endif // BPR_PARALLEL_HPP
@@ -0,0 +1,271 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_PERMUTATION_HPP
+#define BPR_PERMUTATION_HPP
+
+#include "engine.hpp"
+#include "utils.hpp"
+
+#include <type_traits>
+#include <iterator>
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+#if __cplusplus >= 202002L
+#   include <ranges>
+#endif
+
+namespace bpr {
+
+/**
+ * @class FeistelPermutation
+ * @brief A keyed pseudo-random permutation of [0, n) evaluated in O(1) time and memory.
+ *
+ * The permutation is a balanced Feistel network on the smallest even number of bits covering `n`,
+ * with SplitMix64 as round function. Values that fall outside of [0, n) are fed back into the
+ * network ("cycle walking") until they land inside; since the network domain is less than 4 n,
+ * fewer than 4 evaluations are needed on average.
+ *
+ * Because any index can be mapped independently, the permutation can be evaluated in parallel
+ * and in any order, which makes it suitable to generate unique identifiers or to visit a range
+ * in random order without storing it.
+ *
+ * @example
+ * ```cpp
+ * bpr::FeistelPermutation perm(1000000, seed);
+ * for (uint64_t i = 0; i < 10; ++i) {
+ *     uint64_t unique = perm(i);       // ten distinct values in [0, 1000000)
+ * }
+ * ```
+ */
+class FeistelPermutation
+{
+public:
+    /**
+     * @brief Creates the permutation of [0, n) associated with `key`.
+     */
+    constexpr FeistelPermutation(uint64_t n, uint64_t key) noexcept
+        : m_size(n)
+        , m_half_bits(half_bits_for(n))
+        , m_mask((uint64_t(1) << half_bits_for(n)) - 1)
+        , m_keys{}
+    {
+        for (size_t i = 0; i < ROUNDS; ++i) {
+            m_keys[i] = stream_seed(key, i);
+        }
+    }
+
+    /**
+     * @brief Returns the image of `index`, which must be in [0, size()).
+     */
+    constexpr uint64_t operator()(uint64_t index) const noexcept {
+        uint64_t x = index;
+        do {
+            x = encrypt(x);
+        } while (x >= m_size);
+        return x;
+    }
+
+    /**
+     * @brief Returns the size `n` of the permuted range.
+     */
+    constexpr uint64_t size() const noexcept {
+        return m_size;
+    }
+
+private:
+    static constexpr size_t ROUNDS = 4;
+
+    /**
+     * @brief Number of bits of each half of the network: ceil(log2(n)) / 2, rounded up.
+     */
+    static constexpr unsigned half_bits_for(uint64_t n) noexcept {
+        unsigned bits = 0;
+        while (bits < 64 && (uint64_t(1) << bits) < n) ++bits;
+        return bits < 2 ? 1 : (bits + 1) / 2;
+    }
+
+    constexpr uint64_t encrypt(uint64_t x) const noexcept {
+        uint64_t left = (x >> m_half_bits) & m_mask;
+        uint64_t right = x & m_mask;
+        for (size_t i = 0; i < ROUNDS; ++i) {
+            const uint64_t next = left ^ (splitmix64(right ^ m_keys[i]) & m_mask);
+            left = right;
+            right = next;
+        }
+        return (left << m_half_bits) | right;
+    }
+
+private:
+    uint64_t m_size;
+    unsigned m_half_bits;
+    uint64_t m_mask;
+    std::array<uint64_t, ROUNDS> m_keys;
+};
+
+/**
+ * @class UniqueStream
+ * @brief A lazy range over the values of [min, max] in random order, each value appearing once.
+ *
+ * The range stores a `FeistelPermutation` and nothing else: element `i` is `min + perm(i)`,
+ * computed when the iterator is dereferenced. Memory is O(1) whatever the number of values
+ * taken, the first value is available immediately, and consumers can stop at any point.
+ *
+ * The range is random access and can be iterated several times, always yielding the same order.
+ * With C++20 it models `std::ranges::random_access_range` and `std::ranges::view`, so it composes
+ * with `std::views::take`, `std::views::filter`, etc.
+ *
+ * @tparam T The integral type of the values.
+ */
+template <typename T>
+class UniqueStream
+#if __cplusplus >= 202002L
+    : public std::ranges::view_interface<UniqueStream<T>>
+#endif
+{
+    static_assert(std::is_integral_v<T>, "T must be an integral type");
+
+public:
+    class iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = T;
+
+        constexpr iterator() noexcept = default;
+
+        constexpr iterator(const UniqueStream* stream, uint64_t index) noexcept
+            : m_stream(stream), m_index(index)
+        { }
+
+        constexpr T operator*() const noexcept { return (*m_stream)[m_index]; }
+        constexpr T operator[](difference_type n) const noexcept { return (*m_stream)[m_index + n]; }
+
+        constexpr iterator& operator++() noexcept { ++m_index; return *this; }
+        constexpr iterator operator++(int) noexcept { iterator it = *this; ++m_index; return it; }
+        constexpr iterator& operator--() noexcept { --m_index; return *this; }
+        constexpr iterator operator--(int) noexcept { iterator it = *this; --m_index; return it; }
+
+        constexpr iterator& operator+=(difference_type n) noexcept { m_index += n; return *this; }
+        constexpr iterator& operator-=(difference_type n) noexcept { m_index -= n; return *this; }
+        constexpr iterator operator+(difference_type n) const noexcept { return iterator(m_stream, m_index + n); }
+        constexpr iterator operator-(difference_type n) const noexcept { return iterator(m_stream, m_index - n); }
+        friend constexpr iterator operator+(difference_type n, const iterator& it) noexcept { return it + n; }
+
+        constexpr difference_type operator-(const iterator& other) const noexcept {
+            return static_cast<difference_type>(m_index - other.m_index);
+        }
+
+        constexpr bool operator==(const iterator& other) const noexcept { return m_index == other.m_index; }
+        constexpr bool operator!=(const iterator& other) const noexcept { return m_index != other.m_index; }
+        constexpr bool operator<(const iterator& other) const noexcept { return m_index < other.m_index; }
+        constexpr bool operator>(const iterator& other) const noexcept { return m_index > other.m_index; }
+        constexpr bool operator<=(const iterator& other) const noexcept { return m_index <= other.m_index; }
+        constexpr bool operator>=(const iterator& other) const noexcept { return m_index >= other.m_index; }
+
+    private:
+        const UniqueStream* m_stream = nullptr;
+        uint64_t m_index = 0;
+    };
+
+    /**
+     * @brief Creates the stream of the values of [min, max] ordered by the permutation of `key`.
+     *
+     * The range may contain at most 2^64 - 1 values.
+     */
+    constexpr UniqueStream(T min, T max, uint64_t key) noexcept
+        : m_min(min), m_permutation(range_size(min, max), key)
+    { }
+
+    constexpr iterator begin() const noexcept {
+        return iterator(this, 0);
+    }
+
+    constexpr iterator end() const noexcept {
+        return iterator(this, m_permutation.size());
+    }
+
+    constexpr uint64_t size() const noexcept {
+        return m_permutation.size();
+    }
+
+    /**
+     * @brief Returns the value at position `index`, in O(1) without visiting the previous ones.
+     */
+    constexpr T operator[](uint64_t index) const noexcept {
+        using U = std::make_unsigned_t<T>;
+        return static_cast<T>(static_cast<U>(m_min) + static_cast<U>(m_permutation(index)));
+    }
+
+private:
+    static constexpr uint64_t range_size(T min, T max) noexcept {
+        using U = std::make_unsigned_t<T>;
+        const uint64_t span = static_cast<uint64_t>(static_cast<U>(static_cast<U>(max) - static_cast<U>(min)));
+        // A full 64-bit range cannot be counted, its last value is left out
+        return span == UINT64_MAX ? span : span + 1;
+    }
+
+private:
+    T m_min;
+    FeistelPermutation m_permutation;
+};
+
+/**
+ * @brief Returns a lazy range yielding the values of [min, max] in random order, without repetition.
+ *
+ * Unlike `sequence()`, which builds all the values up front in a vector with a hash set to reject
+ * duplicates, the values are produced on demand by a keyed permutation of the range, in constant
+ * time and memory. The engine is only used to draw the key of the permutation.
+ *
+ * @tparam T The integral type of the values.
+ * @tparam Engine The type of the random engine used to draw the key of the permutation.
+ *
+ * @param e The random engine used to draw the key of the permutation.
+ * @param min The minimum value of the range.
+ * @param max The maximum value of the range.
+ *
+ * @example
+ * ```cpp
+ * for (int id : bpr::unique_stream(engine, 1, 1000000)) {
+ *     if (try_assign(id)) break;       // stop whenever: nothing else was generated
+ * }
+ * ```
+ */
+template <typename T, typename Engine>
+UniqueStream<T> unique_stream(Engine& e, T min, T max) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+    return UniqueStream<T>(min, max, e.next());
+}
+
+} // namespace bpr
+
+#if __cplusplus >= 202002L
+template <typename T>
+inline constexpr bool std::ranges::enable_view<bpr::UniqueStream<T>> = true;
+#endif
+
+#endif // BPR_PERMUTATION_HPP
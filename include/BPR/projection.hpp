@@ -0,0 +1,240 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_PROJECTION_HPP
+#define BPR_PROJECTION_HPP
+
+#include "distributions.hpp"
+#include "parallel.hpp"
+#include "utils.hpp"
+
+#include <type_traits>
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+namespace bpr {
+
+/**
+ * @brief Distribution of the entries of a `RandomProjection` matrix.
+ */
+enum class ProjectionKind
+{
+    Gaussian,       ///< N(0, 1) entries, the classic Johnson-Lindenstrauss construction
+    Rademacher,     ///< +1 / -1 entries, one random bit each
+    Achlioptas      ///< Sparse entries: +1 / -1 with probability 1 / (2 s) each, 0 otherwise
+};
+
+/**
+ * @class RandomProjection
+ * @brief A random linear map from `in_dim` to `out_dim` dimensions that is never stored.
+ *
+ * The `out_dim x in_dim` matrix is split into tiles of one output row by `BLOCK` input columns.
+ * Each tile is regenerated when needed from a counter-based stream (`splitmix64_at()`) keyed by
+ * the seed and addressed by (row, column block), so the projection needs no memory, any node
+ * using the same seed computes exactly the same map, and tiles can be produced in any order by
+ * any thread.
+ *
+ * Entries are scaled so that squared norms are preserved in expectation: `1 / sqrt(out_dim)` for
+ * Gaussian and Rademacher entries, `sqrt(s / out_dim)` for the sparse variant of density `1 / s`.
+ * Rademacher tiles cost a single 64-bit word (one sign bit per entry); sparse tiles use 32 bits
+ * per entry, the probabilities being rounded to multiples of 2^-32, and are scaled by the
+ * rounded density; Gaussian tiles use one word per entry.
+ *
+ * `project_batch()` regenerates each tile once for a group of vectors, which amortizes the
+ * generation cost when many vectors are projected, and runs groups in parallel.
+ *
+ * @example
+ * ```cpp
+ * bpr::RandomProjection proj(seed, 100000, 256, bpr::ProjectionKind::Rademacher);
+ * std::vector<float> embedding(256);
+ * proj.project(features.data(), embedding.data());
+ * ```
+ */
+class RandomProjection
+{
+public:
+    static constexpr size_t BLOCK = 64;      // Input dimensions per tile
+    static constexpr size_t GROUP = 16;      // Vectors sharing each regenerated tile in project_batch()
+
+    /**
+     * @param seed The seed identifying the projection.
+     * @param in_dim The dimension of the input vectors.
+     * @param out_dim The dimension of the projected vectors.
+     * @param kind The distribution of the matrix entries.
+     * @param s For `Achlioptas`, the inverse density (3 for Achlioptas' original scheme, sqrt(in_dim) for "very sparse" projections).
+     *
+     * @throws std::invalid_argument If `s` is so large (beyond about 4.3e9) that the entries
+     * would all be zero.
+     */
+    RandomProjection(uint64_t seed, size_t in_dim, size_t out_dim,
+                     ProjectionKind kind = ProjectionKind::Rademacher, double s = 3.0)
+        : m_key(splitmix64(seed))
+        , m_in_dim(in_dim)
+        , m_out_dim(out_dim)
+        , m_blocks((in_dim + BLOCK - 1) / BLOCK)
+        , m_kind(kind)
+    {
+        m_scale = 1.0 / std::sqrt(static_cast<double>(out_dim));
+        if (kind == ProjectionKind::Achlioptas) {
+            const double density = s > 1.0 ? 1.0 / s : 1.0;
+            m_sparse_threshold = static_cast<uint32_t>(std::llround(4294967296.0 * density / 2.0));
+            if (m_sparse_threshold == 0) {
+                throw std::invalid_argument("bpr::RandomProjection: sparsity s too large, every entry would be zero");
+            }
+            // Scale by the density actually drawn, so that norms are preserved whatever the rounding
+            m_scale = std::sqrt(2147483648.0 / (static_cast<double>(m_sparse_threshold) * static_cast<double>(out_dim)));
+        }
+    }
+
+    size_t in_dim() const noexcept { return m_in_dim; }
+    size_t out_dim() const noexcept { return m_out_dim; }
+    ProjectionKind kind() const noexcept { return m_kind; }
+
+    /**
+     * @brief Projects one vector: `out[j] = sum_i R[j][i] * in[i]`.
+     */
+    template <typename T>
+    void project(const T* in, T* out) const noexcept {
+        project_group(&in, &out, 1);
+    }
+
+    /**
+     * @brief Projects `count` vectors stored contiguously (`in_dim` values each) into `out` (`out_dim` values each).
+     *
+     * @param thread_count The number of threads to use, or zero to use every hardware thread.
+     */
+    template <typename T>
+    void project_batch(const T* in, size_t count, T* out, unsigned thread_count = 0) const {
+        const size_t groups = (count + GROUP - 1) / GROUP;
+        parallel_for(groups, [&](size_t group, unsigned) {
+            const T* inputs[GROUP];
+            T* outputs[GROUP];
+            const size_t first = group * GROUP;
+            const size_t n = std::min(GROUP, count - first);
+            for (size_t v = 0; v < n; ++v) {
+                inputs[v] = in + (first + v) * m_in_dim;
+                outputs[v] = out + (first + v) * m_out_dim;
+            }
+            project_group(inputs, outputs, n);
+        }, thread_count);
+    }
+
+    /**
+     * @brief Returns the entry R[row][col] of the (scaled) matrix, regenerating its tile.
+     */
+    double entry(size_t row, size_t col) const noexcept {
+        double tile[BLOCK];
+        generate_tile(row, col / BLOCK, tile);
+        return tile[col % BLOCK] * m_scale;
+    }
+
+private:
+    /**
+     * @brief Number of stream words consumed by one tile.
+     */
+    size_t tile_words() const noexcept {
+        switch (m_kind) {
+            case ProjectionKind::Rademacher: return 1;
+            case ProjectionKind::Achlioptas: return BLOCK / 2;
+            default: return BLOCK;
+        }
+    }
+
+    /**
+     * @brief Writes the unscaled entries of tile (row, block) to `tile`.
+     */
+    template <typename T>
+    void generate_tile(size_t row, size_t block, T* tile) const noexcept {
+        const uint64_t first = (static_cast<uint64_t>(row) * m_blocks + block) * tile_words();
+
+        if (m_kind == ProjectionKind::Rademacher) {
+            // One sign bit per entry
+            const uint64_t signs = splitmix64_at(m_key, first);
+            for (size_t k = 0; k < BLOCK; ++k) {
+                tile[k] = T(1) - T(2) * static_cast<T>((signs >> k) & 1);
+            }
+        }
+        else if (m_kind == ProjectionKind::Achlioptas) {
+            // 32 bits per entry: -1 below the threshold, +1 at or above 2^32 - threshold, 0 in between
+            const uint32_t t = m_sparse_threshold;
+            for (size_t w = 0; w < BLOCK / 2; ++w) {
+                const uint64_t word = splitmix64_at(m_key, first + w);
+                for (size_t k = 0; k < 2; ++k) {
+                    const uint32_t u = static_cast<uint32_t>(word >> (32 * k));
+                    tile[2 * w + k] = static_cast<T>(static_cast<int>(u >= 0 - t) - static_cast<int>(u < t));
+                }
+            }
+        }
+        else {
+            // Box-Muller on pairs of words
+            constexpr double two_pi = 6.283185307179586476925286766559;
+            for (size_t k = 0; k < BLOCK; k += 2) {
+                const double r = std::sqrt(-2.0 * std::log(detail::unit_open<double>(splitmix64_at(m_key, first + k))));
+                const double theta = two_pi * detail::unit_closed_open<double>(splitmix64_at(m_key, first + k + 1));
+                tile[k] = static_cast<T>(r * std::cos(theta));
+                tile[k + 1] = static_cast<T>(r * std::sin(theta));
+            }
+        }
+    }
+
+    /**
+     * @brief Projects up to GROUP vectors, regenerating each tile once for all of them.
+     */
+    template <typename T>
+    void project_group(const T* const* in, T* const* out, size_t n) const noexcept {
+        static_assert(std::is_floating_point_v<T>, "T must be a floating point");
+
+        T tile[BLOCK];
+        for (size_t row = 0; row < m_out_dim; ++row) {
+            T acc[GROUP] = {};
+            for (size_t block = 0; block < m_blocks; ++block) {
+                generate_tile(row, block, tile);
+                const size_t base = block * BLOCK;
+                const size_t len = std::min(BLOCK, m_in_dim - base);
+                for (size_t v = 0; v < n; ++v) {
+                    const T* x = in[v] + base;
+                    T sum = 0;
+                    for (size_t k = 0; k < len; ++k) {
+                        sum += tile[k] * x[k];
+                    }
+                    acc[v] += sum;
+                }
+            }
+            for (size_t v = 0; v < n; ++v) {
+                out[v][row] = static_cast<T>(acc[v] * m_scale);
+            }
+        }
+    }
+
+private:
+    uint64_t m_key;
+    size_t m_in_dim;
+    size_t m_out_dim;
+    size_t m_blocks;
+    ProjectionKind m_kind;
+    uint32_t m_sparse_threshold = 0;
+    double m_scale = 1.0;
+};
+
+} // namespace bpr
+
+#endif // BPR_PROJECTION_HPP
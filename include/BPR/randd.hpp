@@ -0,0 +1,574 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_RANDD_HPP
+#define BPR_RANDD_HPP
+
+#if !defined(__linux__)
+#   error "bpr/randd.hpp requires Linux (memfd, futex and SCM_RIGHTS)"
+#endif
+
+#include "csprng.hpp"
+#include "engine.hpp"
+#include "utils.hpp"
+
+#include <system_error>
+#include <stdexcept>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <array>
+#include <mutex>
+#include <new>
+#include <cerrno>
+#include <ctime>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+
+namespace bpr { namespace randd {
+
+/**
+ * @brief Socket used when no path is given and `BPR_RANDD_SOCKET` is not set.
+ */
+inline constexpr const char* DEFAULT_SOCKET_PATH = "/run/bpr_randd.sock";
+
+/**
+ * @brief Returns the socket path from `BPR_RANDD_SOCKET`, or `DEFAULT_SOCKET_PATH`.
+ */
+inline std::string default_socket_path()
+{
+    const char* path = std::getenv("BPR_RANDD_SOCKET");
+    return path && *path ? path : DEFAULT_SOCKET_PATH;
+}
+
+/**
+ * @brief Header of the shared-memory ring given to each consumer, followed by the data at `DATA_OFFSET`.
+ *
+ * The ring is single-producer (the daemon) and single-consumer (the client). `head` and `tail`
+ * count bytes produced and consumed since creation, so the fill level is `head - tail` and no
+ * slot is wasted. Each side only waits on a futex when the ring is empty (consumer) or does not
+ * have room for a refill (producer), after raising its `*_waiting` flag so that the other side
+ * knows it has to wake it.
+ */
+struct RingHeader
+{
+    static constexpr uint32_t MAGIC = 0x44525042;    // "BPRD"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t DATA_OFFSET = 4096;
+
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;
+
+    alignas(64) std::atomic<uint64_t> head;
+    std::atomic<uint32_t> data_seq;             // Futex bumped by the producer, waited on by the consumer
+    std::atomic<uint32_t> consumer_waiting;
+
+    alignas(64) std::atomic<uint64_t> tail;
+    std::atomic<uint32_t> space_seq;            // Futex bumped by the consumer, waited on by the producer
+    std::atomic<uint32_t> producer_waiting;
+};
+
+static_assert(sizeof(RingHeader) <= RingHeader::DATA_OFFSET, "ring header does not fit its page");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "the ring needs lock-free 64-bit atomics");
+
+namespace detail {
+
+inline void futex_wait(std::atomic<uint32_t>& word, uint32_t expected, const timespec* timeout = nullptr) noexcept
+{
+    // Shared (non-private) futex: the word lives in memory mapped by two processes
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, timeout, nullptr, 0);
+}
+
+inline void futex_wake(std::atomic<uint32_t>& word) noexcept
+{
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+
+[[noreturn]] inline void throw_errno(const char* what)
+{
+    throw std::system_error(errno, std::generic_category(), std::string("bpr::randd: ") + what);
+}
+
+/**
+ * @brief Incremented in the child after each `fork()`, so that clients notice they were duplicated.
+ *
+ * A ring has a single consumer: a child process reading from the ring inherited from its parent
+ * would receive the same bytes as the parent. Clients compare this counter with the value seen
+ * at connection time (a plain load on the fast path) and reconnect when it changed.
+ */
+inline std::atomic<uint32_t>& fork_generation() noexcept
+{
+    static std::atomic<uint32_t> generation{ 0 };
+    static const int registered = ::pthread_atfork(nullptr, nullptr, [] {
+        fork_generation().fetch_add(1, std::memory_order_relaxed);
+    });
+    (void)registered;
+    return generation;
+}
+
+} // namespace detail
+
+/**
+ * @class Client
+ * @brief Engine reading random bytes from the ring that `bpr_randd` maintains for this process.
+ *
+ * On construction the client connects to the daemon, which creates a dedicated ring in a memfd,
+ * passes its descriptor over the socket and starts filling it. Reads are then plain copies out of
+ * shared memory: no system call is made unless the ring runs empty. Consumed bytes are erased from
+ * the ring before being handed back to the daemon.
+ *
+ * The client is a regular engine, so it can be used with `bpr::rand()` and the other functions of
+ * the library. After a `fork()` the child transparently opens its own ring on first use.
+ *
+ * @example
+ * ```cpp
+ * bpr::randd::Client rng;                  // connects to $BPR_RANDD_SOCKET or /run/bpr_randd.sock
+ * uint8_t key[32];
+ * rng.read(key, sizeof(key));
+ * uint64_t roll = bpr::bounded(rng, 6) + 1;
+ * ```
+ *
+ * @throws std::system_error If the daemon cannot be reached or the ring cannot be mapped.
+ */
+class Client : public IEngine<uint64_t, 0>
+{
+public:
+    explicit Client(std::string socket_path = default_socket_path())
+        : IEngine({}), m_path(std::move(socket_path))
+    {
+        connect();
+    }
+
+    ~Client() override {
+        disconnect();
+    }
+
+    Client(const Client&) = delete;
+    Client& operator=(const Client&) = delete;
+
+    uint64_t next() noexcept override {
+        uint64_t value;
+        read(&value, sizeof(value));
+        return value;
+    }
+
+    void fill(uint64_t* out, size_t count) noexcept {
+        read(out, count * sizeof(uint64_t));
+    }
+
+    /**
+     * @brief Copies `size` random bytes to `out`, waiting for the daemon if the ring is empty.
+     *
+     * If the daemon went away, the client tries to reconnect and terminates the process if it
+     * cannot: returning predictable bytes is never an option.
+     */
+    void read(void* out, size_t size) noexcept {
+        if (m_generation != detail::fork_generation().load(std::memory_order_relaxed)) {
+            reconnect();
+        }
+
+        unsigned char* dst = static_cast<unsigned char*>(out);
+        uint64_t tail = m_ring->tail.load(std::memory_order_relaxed);
+
+        while (size > 0) {
+            const uint64_t available = m_ring->head.load(std::memory_order_acquire) - tail;
+            if (available == 0) {
+                wait_for_data(tail);
+                tail = m_ring->tail.load(std::memory_order_relaxed);
+                continue;
+            }
+
+            // Copy at most up to the end of the ring, the wrapped part is taken by the next iteration
+            const uint64_t capacity = m_ring->capacity;
+            const uint64_t offset = tail % capacity;
+            const size_t n = static_cast<size_t>(std::min<uint64_t>({ available, size, capacity - offset }));
+            std::memcpy(dst, m_data + offset, n);
+            secure_zero(m_data + offset, n);
+            dst += n;
+            size -= n;
+            tail += n;
+
+            m_ring->tail.store(tail, std::memory_order_seq_cst);
+            if (m_ring->producer_waiting.load(std::memory_order_seq_cst)) {
+                m_ring->space_seq.fetch_add(1, std::memory_order_release);
+                detail::futex_wake(m_ring->space_seq);
+            }
+        }
+    }
+
+private:
+    void connect() {
+        m_generation = detail::fork_generation().load(std::memory_order_relaxed);
+
+        m_socket = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (m_socket < 0) detail::throw_errno("socket");
+
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, m_path.c_str(), sizeof(address.sun_path) - 1);
+        if (::connect(m_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            const int error = errno;
+            disconnect();
+            throw std::system_error(error, std::generic_category(), "bpr::randd: cannot connect to " + m_path);
+        }
+
+        // The daemon answers with the memfd of the ring as ancillary data
+        char byte;
+        iovec io{ &byte, 1 };
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+        msghdr message{};
+        message.msg_iov = &io;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        ssize_t received;
+        do {
+            received = ::recvmsg(m_socket, &message, MSG_CMSG_CLOEXEC);
+        } while (received < 0 && errno == EINTR);
+
+        const cmsghdr* header = received > 0 ? CMSG_FIRSTHDR(&message) : nullptr;
+        if (!header || header->cmsg_type != SCM_RIGHTS) {
+            disconnect();
+            throw std::runtime_error("bpr::randd: the daemon did not send a ring");
+        }
+        int memfd;
+        std::memcpy(&memfd, CMSG_DATA(header), sizeof(int));
+
+        struct stat info;
+        if (::fstat(memfd, &info) != 0) {
+            ::close(memfd);
+            disconnect();
+            detail::throw_errno("fstat");
+        }
+        m_mapping_size = static_cast<size_t>(info.st_size);
+        void* mapping = ::mmap(nullptr, m_mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+        ::close(memfd);
+        if (mapping == MAP_FAILED) {
+            disconnect();
+            detail::throw_errno("mmap");
+        }
+
+        m_ring = static_cast<RingHeader*>(mapping);
+        m_data = static_cast<unsigned char*>(mapping) + RingHeader::DATA_OFFSET;
+        if (m_ring->magic != RingHeader::MAGIC || m_ring->version != RingHeader::VERSION
+            || m_ring->capacity + RingHeader::DATA_OFFSET > m_mapping_size) {
+            disconnect();
+            throw std::runtime_error("bpr::randd: incompatible ring");
+        }
+    }
+
+    void disconnect() noexcept {
+        if (m_ring) {
+            ::munmap(m_ring, m_mapping_size);
+            m_ring = nullptr;
+            m_data = nullptr;
+        }
+        if (m_socket >= 0) {
+            ::close(m_socket);
+            m_socket = -1;
+        }
+    }
+
+    void reconnect() noexcept {
+        // After a fork the ring belongs to the parent: drop it without touching it
+        disconnect();
+        try {
+            connect();
+        } catch (...) {
+            std::abort();
+        }
+    }
+
+    void wait_for_data(uint64_t tail) noexcept {
+        const uint32_t seq = m_ring->data_seq.load(std::memory_order_acquire);
+        m_ring->consumer_waiting.store(1, std::memory_order_seq_cst);
+        if (m_ring->head.load(std::memory_order_seq_cst) == tail) {
+            // Bounded wait, so that a daemon restart does not block the consumer forever
+            const timespec timeout{ 1, 0 };
+            detail::futex_wait(m_ring->data_seq, seq, &timeout);
+            if (m_ring->head.load(std::memory_order_acquire) == tail && !daemon_alive()) {
+                m_ring->consumer_waiting.store(0, std::memory_order_relaxed);
+                reconnect();
+                return;
+            }
+        }
+        m_ring->consumer_waiting.store(0, std::memory_order_relaxed);
+    }
+
+    bool daemon_alive() const noexcept {
+        pollfd fd{ m_socket, POLLRDHUP, 0 };
+        return ::poll(&fd, 1, 0) == 0;
+    }
+
+private:
+    std::string m_path;
+    int m_socket = -1;
+    RingHeader* m_ring = nullptr;
+    unsigned char* m_data = nullptr;
+    size_t m_mapping_size = 0;
+    uint32_t m_generation = 0;
+};
+
+/**
+ * @class Server
+ * @brief The `bpr_randd` service: creates one ring per connected client and keeps it full.
+ *
+ * The daemon holds a master `BufferedChaCha20` seeded from `std::random_device`. Each client gets
+ * its own `BufferedChaCha20` keyed from the master, so rings are independent, and the keys of both
+ * generators are renewed after every refill: output already handed out cannot be recomputed from
+ * the memory of the daemon. A thread per client refills its ring whenever at least a quarter of
+ * it is free, directly in shared memory.
+ */
+class Server
+{
+public:
+    /**
+     * @param socket_path Path of the listening unix socket, replaced if it already exists.
+     * @param ring_bytes Capacity of each client ring, rounded up to a multiple of 4096.
+     */
+    explicit Server(std::string socket_path = default_socket_path(), size_t ring_bytes = 1 << 20)
+        : m_path(std::move(socket_path)), m_ring_bytes(std::max<size_t>((ring_bytes + 4095) / 4096 * 4096, 4096))
+    {
+        std::random_device rd;
+        m_master = std::make_unique<csprng::BufferedChaCha20>(rd);
+
+        m_listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (m_listener < 0) detail::throw_errno("socket");
+
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, m_path.c_str(), sizeof(address.sun_path) - 1);
+        ::unlink(m_path.c_str());
+        if (::bind(m_listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+            || ::listen(m_listener, SOMAXCONN) != 0) {
+            const int error = errno;
+            ::close(m_listener);
+            throw std::system_error(error, std::generic_category(), "bpr::randd: cannot listen on " + m_path);
+        }
+        ::chmod(m_path.c_str(), 0666);
+    }
+
+    ~Server() {
+        stop();
+        for (auto& worker : m_workers) {
+            worker.thread.join();
+        }
+        ::close(m_listener);
+        ::unlink(m_path.c_str());
+    }
+
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    /**
+     * @brief Accepts clients until `stop()` is called.
+     */
+    void run() {
+        while (!m_stopped.load(std::memory_order_relaxed)) {
+            const int client = ::accept4(m_listener, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                if (m_stopped.load(std::memory_order_relaxed)) break;
+                detail::throw_errno("accept");
+            }
+            try {
+                serve(client);
+            } catch (const std::exception&) {
+                // A client that cannot be served must not bring the daemon down
+                ::close(client);
+            }
+        }
+    }
+
+    /**
+     * @brief Stops `run()` and the refill threads. Async-signal-safe.
+     */
+    void stop() noexcept {
+        m_stopped.store(true, std::memory_order_relaxed);
+        ::shutdown(m_listener, SHUT_RDWR);
+    }
+
+private:
+    void serve(int client) {
+        const size_t mapping_size = RingHeader::DATA_OFFSET + m_ring_bytes;
+        const int memfd = static_cast<int>(::syscall(SYS_memfd_create, "bpr_randd", MFD_CLOEXEC));
+        if (memfd < 0) detail::throw_errno("memfd_create");
+        if (::ftruncate(memfd, static_cast<off_t>(mapping_size)) != 0) {
+            ::close(memfd);
+            detail::throw_errno("ftruncate");
+        }
+        void* mapping = ::mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(memfd);
+            detail::throw_errno("mmap");
+        }
+
+        RingHeader* ring = new (mapping) RingHeader{};
+        ring->magic = RingHeader::MAGIC;
+        ring->version = RingHeader::VERSION;
+        ring->capacity = m_ring_bytes;
+        unsigned char* data = static_cast<unsigned char*>(mapping) + RingHeader::DATA_OFFSET;
+
+        std::array<uint32_t, 8> key;
+        {
+            std::lock_guard<std::mutex> lock(m_master_mutex);
+            for (size_t i = 0; i < key.size(); i += 2) {
+                const uint64_t word = m_master->next();
+                key[i] = static_cast<uint32_t>(word);
+                key[i + 1] = static_cast<uint32_t>(word >> 32);
+            }
+        }
+        auto engine = std::make_shared<csprng::BufferedChaCha20>(key);
+        secure_zero(key.data(), sizeof(key));
+
+        // Fill the ring before handing it out, so that the first reads never wait
+        produce(*ring, data, *engine);
+
+        char byte = 0;
+        iovec io{ &byte, 1 };
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+        msghdr message{};
+        message.msg_iov = &io;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        cmsghdr* header = CMSG_FIRSTHDR(&message);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type = SCM_RIGHTS;
+        header->cmsg_len = CMSG_LEN(sizeof(int));
+        std::memcpy(CMSG_DATA(header), &memfd, sizeof(int));
+
+        const bool sent = ::sendmsg(client, &message, MSG_NOSIGNAL) == 1;
+        ::close(memfd);
+        if (!sent) {
+            ::munmap(mapping, mapping_size);
+            detail::throw_errno("sendmsg");
+        }
+
+        reap_workers();
+        auto done = std::make_shared<std::atomic<bool>>(false);
+        std::thread thread([this, client, ring, data, mapping_size, engine, done] {
+            refill_loop(client, *ring, data, *engine);
+            ::munmap(ring, mapping_size);
+            ::close(client);
+            done->store(true, std::memory_order_release);
+        });
+        m_workers.push_back(Worker{ std::move(thread), std::move(done) });
+    }
+
+    /**
+     * @brief Joins the threads of the clients that disconnected.
+     */
+    void reap_workers() {
+        auto finished = std::partition(m_workers.begin(), m_workers.end(), [](const Worker& worker) {
+            return !worker.done->load(std::memory_order_acquire);
+        });
+        for (auto it = finished; it != m_workers.end(); ++it) {
+            it->thread.join();
+        }
+        m_workers.erase(finished, m_workers.end());
+    }
+
+    /**
+     * @brief Fills all the free space of the ring.
+     */
+    static void produce(RingHeader& ring, unsigned char* data, csprng::BufferedChaCha20& engine) noexcept {
+        const uint64_t capacity = ring.capacity;
+        uint64_t head = ring.head.load(std::memory_order_relaxed);
+        const uint64_t free = capacity - (head - ring.tail.load(std::memory_order_acquire));
+
+        // Head and capacity are multiples of 8, so both segments are whole words
+        uint64_t remaining = free & ~uint64_t(7);
+        while (remaining > 0) {
+            const uint64_t offset = head % capacity;
+            const uint64_t n = std::min(remaining, capacity - offset);
+            engine.fill(reinterpret_cast<uint64_t*>(data + offset), static_cast<size_t>(n / 8));
+            head += n;
+            remaining -= n;
+        }
+
+        ring.head.store(head, std::memory_order_seq_cst);
+        if (ring.consumer_waiting.load(std::memory_order_seq_cst)) {
+            ring.data_seq.fetch_add(1, std::memory_order_release);
+            detail::futex_wake(ring.data_seq);
+        }
+    }
+
+    void refill_loop(int client, RingHeader& ring, unsigned char* data, csprng::BufferedChaCha20& engine) noexcept {
+        const uint64_t low_water = ring.capacity / 4;
+        while (!m_stopped.load(std::memory_order_relaxed)) {
+            const uint64_t used = ring.head.load(std::memory_order_relaxed) - ring.tail.load(std::memory_order_acquire);
+            if (ring.capacity - used >= low_water) {
+                produce(ring, data, engine);
+                continue;
+            }
+
+            const uint32_t seq = ring.space_seq.load(std::memory_order_acquire);
+            ring.producer_waiting.store(1, std::memory_order_seq_cst);
+            const uint64_t tail = ring.tail.load(std::memory_order_seq_cst);
+            if (ring.capacity - (ring.head.load(std::memory_order_relaxed) - tail) < low_water) {
+                // Wake up regularly to notice clients that went away
+                const timespec timeout{ 0, 200000000 };
+                detail::futex_wait(ring.space_seq, seq, &timeout);
+            }
+            ring.producer_waiting.store(0, std::memory_order_relaxed);
+
+            pollfd fd{ client, POLLRDHUP, 0 };
+            if (::poll(&fd, 1, 0) != 0) break;
+        }
+    }
+
+private:
+    struct Worker
+    {
+        std::thread thread;
+        std::shared_ptr<std::atomic<bool>> done;
+    };
+
+    std::string m_path;
+    size_t m_ring_bytes;
+    int m_listener = -1;
+    std::atomic<bool> m_stopped{ false };
+    std::unique_ptr<csprng::BufferedChaCha20> m_master;
+    std::mutex m_master_mutex;
+    std::vector<Worker> m_workers;
+};
+
+}} // namespace bpr::randd
+
+#endif // BPR_RANDD_HPP
@@ -0,0 +1,1089 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_REPRODUCIBLE_HPP
+#define BPR_REPRODUCIBLE_HPP
+
+#include "generator.hpp"
+#include "engine.hpp"
+#include "utils.hpp"
+
+#include <type_traits>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+namespace bpr::repro {
+
+/**
+ * Distributions whose output is bit-for-bit identical on every platform and compiler that follows
+ * IEEE 754 arithmetic.
+ *
+ * The distributions of `distributions.hpp` call libm (`log`, `exp`, `sin`...), whose results
+ * differ between implementations, and their arithmetic can be contracted into FMA instructions
+ * depending on the target. The functions of this namespace only use integer operations and the
+ * basic floating-point operations (+, -, *, /, which IEEE 754 rounds correctly, so every
+ * conforming platform gets the same bits), and they keep the compiler from fusing a product
+ * with a sum. They require IEEE 754 binary64 doubles without excess precision
+ * (`FLT_EVAL_METHOD == 0`, which excludes x87-only builds), and none of the flags that let the
+ * compiler break IEEE semantics: `-ffast-math`, `-fassociative-math`, `-ffinite-math-only`, or
+ * their equivalents such as `/fp:fast` with MSVC. Other flags (optimization level, `-march`,
+ * `-ffp-contract`) do not change the results.
+ *
+ * Stream contract: value k is a pure function of the k-th 64-bit word of the engine. When a
+ * sample needs more randomness (a rejection, the tail of a ziggurat), it takes it from a
+ * SplitMix64 sequence seeded with its own word, never from the engine. Therefore:
+ * - `normal(e)` consumes exactly one engine word, like every other function here.
+ * - The bulk `fill_*` functions consume one word per value and give exactly the values of
+ *   the same number of scalar calls, whatever the tile size or the vector instructions used.
+ *   This assumes that `fill()` returns the words of `next()`, as for every PRNG of the library;
+ *   the bulk paths of `ChaCha20` and `BufferedChaCha20` return the raw keystream instead.
+ * - The `to_*` functions map words from any source (a counter-based generator, a network
+ *   packet...) to values, so lockstep peers only need to agree on the words.
+ *
+ * Normal and exponential values use 256-layer ziggurats whose acceptance tests compare 52-bit
+ * integers with integer tables; the tables are hexadecimal literals, not computed at run time.
+ */
+
+namespace detail {
+
+/**
+ * @brief Returns `x` unchanged, but hides its origin from the optimizer.
+ *
+ * A product passed through this barrier cannot be fused with a following addition into an
+ * FMA instruction, which would round once instead of twice.
+ */
+inline double fp_barrier(double x) noexcept
+{
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2_MATH__)))
+    __asm__("" : "+x"(x));
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+    __asm__("" : "+w"(x));
+#else
+    volatile double v = x;
+    x = v;
+#endif
+    return x;
+}
+
+/**
+ * @brief Forces the values of an array to be stored before the next loop reads them.
+ *
+ * Bulk kernels compute products and sums in separate loops around this barrier, which keeps
+ * them unfused while both loops are still vectorized.
+ */
+inline void memory_barrier(const void* data) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __asm__ __volatile__("" : : "r"(data) : "memory");
+#else
+    volatile const void* p = data;
+    (void)p;
+#endif
+}
+
+/**
+ * @brief Correctly rounded product that cannot be fused with a following sum.
+ */
+inline double mul(double a, double b) noexcept
+{
+    return fp_barrier(a * b);
+}
+
+inline double from_bits(uint64_t bits) noexcept
+{
+    double x;
+    std::memcpy(&x, &bits, sizeof x);
+    return x;
+}
+
+inline uint64_t to_bits(double x) noexcept
+{
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof bits);
+    return bits;
+}
+
+/**
+ * @brief Exact conversion of an integer below 2^52 to double, by bit construction.
+ */
+inline double from_u52(uint64_t j) noexcept
+{
+    return from_bits(0x4330000000000000ull | j) - 0x1p52;
+}
+
+/**
+ * @brief Double in (0, 1) from the 53 high bits of a word: an odd multiple of 2^-53, exactly.
+ */
+inline double unit_open(uint64_t word) noexcept
+{
+    return static_cast<double>((word >> 11) | 1) * 0x1p-53;
+}
+
+/**
+ * @brief Seed of the SplitMix64 sequence that supplies the extra randomness of the value of `word`.
+ */
+constexpr uint64_t extra_seed(uint64_t word) noexcept
+{
+    return splitmix64(word ^ 0x6a09e667f3bcc909ull);
+}
+
+/**
+ * @brief Natural logarithm of a positive normal double, with basic operations only (fdlibm's algorithm).
+ *
+ * The argument is split as `2^k * (1 + f)` with `1 + f` in [sqrt(2)/2, sqrt(2)), and
+ * `log(1 + f)` is evaluated with the minimax polynomial of fdlibm, within 1 ulp.
+ */
+inline double log(double x) noexcept
+{
+    constexpr double LN2_HI = 0x1.62e42feep-1;
+    constexpr double LN2_LO = 0x1.a39ef35793c76p-33;
+    constexpr double LG1 = 0x1.5555555555593p-1, LG2 = 0x1.999999997fa04p-2, LG3 = 0x1.2492494229359p-2;
+    constexpr double LG4 = 0x1.c71c51d8e78afp-3, LG5 = 0x1.7466496cb03dep-3, LG6 = 0x1.39a09d078c69fp-3;
+    constexpr double LG7 = 0x1.2f112df3e5244p-3;
+
+    uint64_t bits = to_bits(x);
+    int64_t k = static_cast<int64_t>(bits >> 52) - 1023;
+    bits &= 0x000FFFFFFFFFFFFFull;
+    // Bring the mantissa into [sqrt(2)/2, sqrt(2))
+    if (bits > 0x6A09E667F3BCDull) {
+        bits |= 0x3FE0000000000000ull;
+        ++k;
+    } else {
+        bits |= 0x3FF0000000000000ull;
+    }
+    const double f = from_bits(bits) - 1.0;
+    const double dk = static_cast<double>(k);
+
+    const double s = f / (2.0 + f);
+    const double z = mul(s, s);
+    const double w = mul(z, z);
+    const double t1 = mul(w, mul(w, mul(w, LG6) + LG4) + LG2);
+    const double t2 = mul(z, mul(w, mul(w, mul(w, LG7) + LG5) + LG3) + LG1);
+    const double r = t2 + t1;
+    const double hfsq = mul(mul(0.5, f), f);
+    return mul(dk, LN2_HI) - ((hfsq - (mul(s, hfsq + r) + mul(dk, LN2_LO))) - f);
+}
+
+/**
+ * @brief Exponential of `x` in [-700, 700], with basic operations only (fdlibm's algorithm).
+ *
+ * `x = k * ln(2) + r` with |r| <= ln(2) / 2, `exp(r)` from a rational approximation within 1 ulp,
+ * and the result scaled by 2^k by bit construction.
+ */
+inline double exp(double x) noexcept
+{
+    constexpr double LN2_HI = 0x1.62e42feep-1;
+    constexpr double LN2_LO = 0x1.a39ef35793c76p-33;
+    constexpr double INV_LN2 = 0x1.71547652b82fep0;
+    constexpr double P1 = 0x1.555555555553ep-3, P2 = -0x1.6c16c16bebd93p-9, P3 = 0x1.1566aaf25de2cp-14;
+    constexpr double P4 = -0x1.bbd41c5d26bf1p-20, P5 = 0x1.6376972bea4d0p-25;
+
+    const double kf = mul(x, INV_LN2) + (x < 0.0 ? -0.5 : 0.5);
+    const int64_t k = static_cast<int64_t>(kf);
+    const double dk = static_cast<double>(k);
+    const double hi = x - mul(dk, LN2_HI);
+    const double lo = mul(dk, LN2_LO);
+    const double r = hi - lo;
+
+    const double t = mul(r, r);
+    const double c = r - mul(t, mul(t, mul(t, mul(t, mul(t, P5) + P4) + P3) + P2) + P1);
+    const double y = 1.0 - ((lo - mul(r, c) / (2.0 - c)) - hi);
+    return mul(y, from_bits(static_cast<uint64_t>(k + 1023) << 52));
+}
+
+
+/**
+ * @brief Number of 64-bit words generated per tile by the bulk kernels.
+ */
+inline constexpr size_t TILE_WORDS = 256;
+
+/**
+ * @brief Ziggurat tables (Marsaglia and Tsang) of 256 layers for the half-normal density `exp(-x^2 / 2)`.
+ *
+ * Layer i has width `NORMAL_W[i] * 2^52` and the density at its right edge is `NORMAL_F[i]`; a
+ * 52-bit magnitude `j` drawn in layer i lies under the density whenever `j < NORMAL_K[i]`.
+ * Layer 0 is the base strip, whose rejected part is the tail beyond `NORMAL_R`.
+ */
+inline constexpr double NORMAL_R = 0x1.d3bb48209ad33p+1;
+
+inline constexpr uint64_t NORMAL_K[256] = {
+    0xef33d8025bc39, 0x0000000000000, 0xc08be98f2acaa, 0xda354faba4236,
+    0xe51f67ec049b5, 0xeb255e9d2fa41, 0xeef4b817e221c, 0xf19470af9cc80,
+    0xf37ed61ff712f, 0xf4f469560df95, 0xf61a5e41b6be3, 0xf707a75536926,
+    0xf7cb2ec281ec3, 0xf86f10c6337d8, 0xf8fa657830a7d, 0xf9724c74db926,
+    0xf9da907dbe051, 0xfa360f581e82e, 0xfa86fde5b3bbf, 0xfacf160d34659,
+    0xfb0fb6718ac00, 0xfb49f8d5368f8, 0xfb7ec2366f3bd, 0xfbaece9a1db42,
+    0xfbdab9d0402f5, 0xfc03060ff6415, 0xfc28210379aaa, 0xfc4a67ae254c2,
+    0xfc6a2977ae7a3, 0xfc87aa928908b, 0xfca325e4bd8d4, 0xfcbcce9021dc6,
+    0xfcd4d12f834c6, 0xfceb54d8fe7e7, 0xfd007bf1dc4c6, 0xfd1464dd6c0ba,
+    0xfd272a8e2f060, 0xfd38e4ff0c565, 0xfd49a9990b0f2, 0xfd598b8920bf9,
+    0xfd689c08e96bd, 0xfd76ea9c8e52a, 0xfd848547b0606, 0xfd9178bad29cb,
+    0xfd9dd07a7ab31, 0xfda9970105c08, 0xfdb4d5dc02bb8, 0xfdbf95c5bfa83,
+    0xfdc9debb99848, 0xfdd3b8118707f, 0xfddd288342d86, 0xfde6364369d6f,
+    0xfdeee708d4f6d, 0xfdf7401a6b25e, 0xfdff46599eb80, 0xfe06fe4bc2343,
+    0xfe0e6c225a0b8, 0xfe1593c28b6ba, 0xfe1c78cbc3e15, 0xfe231e9db1b32,
+    0xfe29885da1a27, 0xfe2fb8fb54027, 0xfe35b33558bf6, 0xfe3b799cffee1,
+    0xfe410e99eac3f, 0xfe46746d475ff, 0xfe4bad34c082f, 0xfe50baed29401,
+    0xfe559f74ebb5c, 0xfe5a5c8e410ff, 0xfe5ef3e13857d, 0xfe6366fd90f74,
+    0xfe67b75c6d47c, 0xfe6be661e10b4, 0xfe6ff55e5f402, 0xfe73e5900a617,
+    0xfe77b823e9d56, 0xfe7b6e3706fc3, 0xfe7f08d77416b, 0xfe8289053efb9,
+    0xfe85efb35166d, 0xfe893dc84079b, 0xfe8c741f0cdf7, 0xfe8f9387d4e36,
+    0xfe929cc879a62, 0xfe95909d38833, 0xfe986fb9399ee, 0xfe9b3ac7147b7,
+    0xfe9df2694b62a, 0xfea0973abe5d4, 0xfea329cf16600, 0xfea5aab32948c,
+    0xfea81a6d5737c, 0xfeaa797de1c56, 0xfeacc85f3d889, 0xfeaf07865e5a9,
+    0xfeb13762feb82, 0xfeb3585fe29bd, 0xfeb56ae316229, 0xfeb76f4e28470,
+    0xfeb965fe61f8d, 0xfebb4f4cf9cf9, 0xfebd2b8f4494f, 0xfebefb16e2dbf,
+    0xfec0be31ebd6c, 0xfec2752b1599a, 0xfec42049daf5b, 0xfec5bfd29f121,
+    0xfec75406cee81, 0xfec8dd2500c42, 0xfeca5b6911ea1, 0xfecbcf0c42790,
+    0xfecd38454faa9, 0xfece97488c84a, 0xfecfec47f914f, 0xfed13773584c1,
+    0xfed278f84489e, 0xfed3b10242ee8, 0xfed4dfbad580b, 0xfed605498c37c,
+    0xfed721d414f89, 0xfed8357e4a924, 0xfed9406a42c6d, 0xfeda42b85b6a9,
+    0xfedb3c8746a5a, 0xfedc2df4165fa, 0xfedd171a46dfc, 0xfeddf813c8a7d,
+    0xfeded0f90992c, 0xfedfa1e0fd3c1, 0xfee06ae124b73, 0xfee12c0d959b5,
+    0xfee1e57900690, 0xfee29734b64d6, 0xfee34150ae46f, 0xfee3e3db89af0,
+    0xfee47ee2982a8, 0xfee51271db03c, 0xfee59e9407ef7, 0xfee623528b3e5,
+    0xfee6a0b5897a9, 0xfee716c3e0733, 0xfee7858327b3b, 0xfee7ecf7b0674,
+    0xfee84d2484a6e, 0xfee8a60b662ff, 0xfee8f7accc80f, 0xfee94207e2598,
+    0xfee9851a829aa, 0xfee9c0e13481a, 0xfee9f557273b4, 0xfeea22762cc70,
+    0xfeea4836b426d, 0xfeea668fc2d34, 0xfeea7d76ed6bd, 0xfeea8ce04f9ce,
+    0xfeea94be83300, 0xfeea9502963d4, 0xfeea8d9c00723, 0xfeea7e789761a,
+    0xfeea678481cec, 0xfeea48aa29e4a, 0xfeea21d22e4a2, 0xfee9f2e351fed,
+    0xfee9bbc26aef8, 0xfee97c524f2ad, 0xfee93473c0a03, 0xfee8e405574e0,
+    0xfee88ae369c44, 0xfee828e7f3dc9, 0xfee7bdea7b854, 0xfee749bff37cb,
+    0xfee6cc3a9bd2c, 0xfee64529e004d, 0xfee5b45a32857, 0xfee51994e5785,
+    0xfee474a00069e, 0xfee3c53e12c1e, 0xfee30b2e02aa7, 0xfee2462ad81d4,
+    0xfee175eb83c2a, 0xfee09a22a1417, 0xfedfb27e3499c, 0xfedebea76213e,
+    0xfeddbe422044f, 0xfedcb0ece39a5, 0xfedb964042cc6, 0xfeda6dce9389c,
+    0xfed937237e95f, 0xfed7f1c38a80a, 0xfed69d2b9bffe, 0xfed538d06add3,
+    0xfed3c41dea3f7, 0xfed23e76a2fac, 0xfed0a732fe617, 0xfecefda07fe08,
+    0xfecd4100eb78c, 0xfecb708956e89, 0xfec98b6123096, 0xfec790a0da94e,
+    0xfec57f50f31d4, 0xfec356686c938, 0xfec114cb4b30b, 0xfebeb948e6fa7,
+    0xfebc429a0b668, 0xfeb9af5ee0cb3, 0xfeb6fe1c98519, 0xfeb42d3ad1f75,
+    0xfeb13b00b2d23, 0xfeae2591a02c0, 0xfeaaeae99222d, 0xfea788d8ee2fe,
+    0xfea3fcffd73bc, 0xfea044c8dd9ce, 0xfe9c5d62f5612, 0xfe9843ba9477a,
+    0xfe93f471d4700, 0xfe8f6bd76c5ad, 0xfe8aa5dc4e8bd, 0xfe859e07ab1c1,
+    0xfe804f690a917, 0xfe7ab48823396, 0xfe74c751f6a7c, 0xfe6e8102aa1d9,
+    0xfe67da0b6abaf, 0xfe60c9f383055, 0xfe5947338f718, 0xfe51470977256,
+    0xfe48bd436f42d, 0xfe3f9bffd1e0d, 0xfe35d35eeb171, 0xfe2b5122fe4d2,
+    0xfe2000399552b, 0xfe13c827882e8, 0xfe068c4ee6783, 0xfdf82b02b717d,
+    0xfde87c57efe7c, 0xfdd7509c63bce, 0xfdc46e529bee3, 0xfdaf8f82e0252,
+    0xfd985e1b2ba43, 0xfd7e6ef48ced0, 0xfd613adbd64d6, 0xfd40149e2efda,
+    0xfd1a1a7b4c772, 0xfcee204761f61, 0xfcba8d85e1171, 0xfc7d26ecd2cde,
+    0xfc32b2f1e22a1, 0xfbd6581c0b7e7, 0xfb606c40053d6, 0xfac40582a2805,
+    0xf9e971e014510, 0xf89fa48a41d49, 0xf66c5f7f02f1a, 0xf1a5a4b331a0a
+};
+
+inline constexpr double NORMAL_W[256] = {
+    0x1.f493b78164498p-51, 0x1.b8d0be3d69918p-55, 0x1.250af3c200a69p-54,
+    0x1.57cb9383ae550p-54, 0x1.801fce827fac5p-54, 0x1.a230c2e46389ep-54,
+    0x1.c004d2f328d93p-54, 0x1.dac2f5a6f3120p-54, 0x1.f32482d4807a6p-54,
+    0x1.04d32278c832ep-53, 0x1.0f5053b004b4ep-53, 0x1.192a6973f450ap-53,
+    0x1.227a28f78456ap-53, 0x1.2b52e38621b30p-53, 0x1.33c3fc055e9edp-53,
+    0x1.3bd9ec1a11c06p-53, 0x1.439ef8dfe170ap-53, 0x1.4b1bb363c898dp-53,
+    0x1.5257562196c1cp-53, 0x1.59580a70673c9p-53, 0x1.60231cfd82f9bp-53,
+    0x1.66bd261a2377ep-53, 0x1.6d2a291feca73p-53, 0x1.736dad345c6b6p-53,
+    0x1.798ad10b200f0p-53, 0x1.7f845ad45d397p-53, 0x1.855cc5341f023p-53,
+    0x1.8b1649e7a632cp-53, 0x1.90b2ea94dc2a8p-53, 0x1.96347822b1818p-53,
+    0x1.9b9c98e37c43bp-53, 0x1.a0eccdca3ab98p-53, 0x1.a62676d76d6f5p-53,
+    0x1.ab4ad6e0f24bap-53, 0x1.b05b16d127fd5p-53, 0x1.b5584874191dap-53,
+    0x1.ba4368e51bb30p-53, 0x1.bf1d62abea23bp-53, 0x1.c3e70f95872e0p-53,
+    0x1.c8a13a531630bp-53, 0x1.cd4c9fe7151cap-53, 0x1.d1e9f0e7fe5f7p-53,
+    0x1.d679d29e3510dp-53, 0x1.dafce0022edeep-53, 0x1.df73aa9f0ae8dp-53,
+    0x1.e3debb5d2292dp-53, 0x1.e83e93379ad08p-53, 0x1.ec93abdf8c395p-53,
+    0x1.f0de784efa595p-53, 0x1.f51f654d83c88p-53, 0x1.f956d9e87202bp-53,
+    0x1.fd8537df97991p-53, 0x1.00d56e041db89p-52, 0x1.02e40f5393759p-52,
+    0x1.04eea9e164ed4p-52, 0x1.06f565b7249f9p-52, 0x1.08f8690719efdp-52,
+    0x1.0af7d84bc0d06p-52, 0x1.0cf3d664b796dp-52, 0x1.0eec84b15b64dp-52,
+    0x1.10e203294c4bdp-52, 0x1.12d470730bf74p-52, 0x1.14c3e9f8e41d8p-52,
+    0x1.16b08bfc3d191p-52, 0x1.189a71a788c7ep-52, 0x1.1a81b51ee20a3p-52,
+    0x1.1c666f8f7deb3p-52, 0x1.1e48b93e088dcp-52, 0x1.2028a99405610p-52,
+    0x1.2206572c47d17p-52, 0x1.23e1d7de97a07p-52, 0x1.25bb40ca92399p-52,
+    0x1.2792a661d8bcdp-52, 0x1.29681c7199017p-52, 0x1.2b3bb62b7e880p-52,
+    0x1.2d0d862e172a1p-52, 0x1.2edd9e8cb647fp-52, 0x1.30ac10d6e0469p-52,
+    0x1.3278ee1f4755fp-52, 0x1.3444470261b6ap-52, 0x1.360e2baca1034p-52,
+    0x1.37d6abe05165dp-52, 0x1.399dd6fb270e9p-52, 0x1.3b63bbfb7fc17p-52,
+    0x1.3d2869855dd80p-52, 0x1.3eebede721aacp-52, 0x1.40ae571e05f24p-52,
+    0x1.426fb2da63591p-52, 0x1.44300e83bf25ap-52, 0x1.45ef773ca8993p-52,
+    0x1.47adf9e6685eap-52, 0x1.496ba3248525ep-52, 0x1.4b287f6020506p-52,
+    0x1.4ce49acb2d5fdp-52, 0x1.4ea0016386a9cp-52, 0x1.505abef5e1a6dp-52,
+    0x1.5214df20a50d8p-52, 0x1.53ce6d56a2c3dp-52, 0x1.558774e1b7925p-52,
+    0x1.574000e552644p-52, 0x1.58f81c60e4c4cp-52, 0x1.5aafd2323e2fbp-52,
+    0x1.5c672d17d3b48p-52, 0x1.5e1e37b2f5545p-52, 0x1.5fd4fc89f270fp-52,
+    0x1.618b860a2e8ffp-52, 0x1.6341de8a27a41p-52, 0x1.64f8104b6f00cp-52,
+    0x1.66ae257c960d3p-52, 0x1.6864283b0fbf7p-52, 0x1.6a1a229507dcfp-52,
+    0x1.6bd01e8b30f36p-52, 0x1.6d86261289f28p-52, 0x1.6f3c43161c483p-52,
+    0x1.70f27f78b3573p-52, 0x1.72a8e5168e1a6p-52, 0x1.745f7dc70bc13p-52,
+    0x1.7616535e540adp-52, 0x1.77cd6faefc22dp-52, 0x1.7984dc8ba8bcbp-52,
+    0x1.7b3ca3c8ae294p-52, 0x1.7cf4cf3daf1d9p-52, 0x1.7ead68c73ae15p-52,
+    0x1.80667a486b99ep-52, 0x1.82200dac85645p-52, 0x1.83da2ce896f32p-52,
+    0x1.8594e1fd1c628p-52, 0x1.875036f7a4f7ep-52, 0x1.890c35f47c831p-52,
+    0x1.8ac8e92059192p-52, 0x1.8c865aba0de35p-52, 0x1.8e44951443c0ap-52,
+    0x1.9003a297387bcp-52, 0x1.91c38dc2855bcp-52, 0x1.9384612eeddb8p-52,
+    0x1.954627903758cp-52, 0x1.9708ebb70a936p-52, 0x1.98ccb892dfdbfp-52,
+    0x1.9a919933f6d92p-52, 0x1.9c5798cd5ad43p-52, 0x1.9e1ec2b6f486dp-52,
+    0x1.9fe7226faa6eap-52, 0x1.a1b0c39f90b75p-52, 0x1.a37bb21a29d81p-52,
+    0x1.a547f9e0b90efp-52, 0x1.a715a724a7f4dp-52, 0x1.a8e4c64a00726p-52,
+    0x1.aab563e9fc731p-52, 0x1.ac878cd5acc36p-52, 0x1.ae5b4e18b89dep-52,
+    0x1.b030b4fc37800p-52, 0x1.b207cf09a6f7ep-52, 0x1.b3e0aa0dfe361p-52,
+    0x1.b5bb541ce14a1p-52, 0x1.b797db93f6101p-52, 0x1.b9764f1e5cf51p-52,
+    0x1.bb56bdb84fdbep-52, 0x1.bd3936b2e992ep-52, 0x1.bf1dc9b81874ap-52,
+    0x1.c10486cebefa2p-52, 0x1.c2ed7e5f05369p-52, 0x1.c4d8c136de693p-52,
+    0x1.c6c6608ec60b5p-52, 0x1.c8b66e0eb8000p-52, 0x1.caa8fbd367ccdp-52,
+    0x1.cc9e1c73bb0eap-52, 0x1.ce95e3068bacap-52, 0x1.d0906328b6a39p-52,
+    0x1.d28db1037ca23p-52, 0x1.d48de1533a181p-52, 0x1.d691096e7cc94p-52,
+    0x1.d8973f4d7d74dp-52, 0x1.daa0999204a4dp-52, 0x1.dcad2f8fc2520p-52,
+    0x1.debd195520a7ep-52, 0x1.e0d06fb49ae98p-52, 0x1.e2e74c4ea23a7p-52,
+    0x1.e501c99c1ae6fp-52, 0x1.e72002f97db41p-52, 0x1.e94214b2a9c5cp-52,
+    0x1.eb681c0f74c90p-52, 0x1.ed923761084f7p-52, 0x1.efc086101ca9bp-52,
+    0x1.f1f328ac23146p-52, 0x1.f42a40fb72bc7p-52, 0x1.f665f20c8dff6p-52,
+    0x1.f8a6604897644p-52, 0x1.faebb187101b4p-52, 0x1.fd360d22fc6aep-52,
+    0x1.ff859c118d567p-52, 0x1.00ed447d3903dp-51, 0x1.021a8028fb929p-51,
+    0x1.034a983a8f2a6p-51, 0x1.047da4e3ee5dbp-51, 0x1.05b3bf6ada3acp-51,
+    0x1.06ed023a716b0p-51, 0x1.082988f631e79p-51, 0x1.0969708e892d0p-51,
+    0x1.0aacd7571b15ap-51, 0x1.0bf3dd1eec4f7p-51, 0x1.0d3ea34aa2df9p-51,
+    0x1.0e8d4cf115675p-51, 0x1.0fdffefa690b2p-51, 0x1.1136e04206156p-51,
+    0x1.129219bbb4e64p-51, 0x1.13f1d69c3fab5p-51, 0x1.1556448601f9dp-51,
+    0x1.16bf93b9de06ep-51, 0x1.182df74d203f5p-51, 0x1.19a1a564edd5ap-51,
+    0x1.1b1ad777f2157p-51, 0x1.1c99ca9719877p-51, 0x1.1e1ebfbe4a036p-51,
+    0x1.1fa9fc2e2cb18p-51, 0x1.213bc9d04beb3p-51, 0x1.22d477a6fc63bp-51,
+    0x1.24745a4ac8e8bp-51, 0x1.261bcc7764b62p-51, 0x1.27cb2faa84bcbp-51,
+    0x1.2982ecd770131p-51, 0x1.2b4375329fd27p-51, 0x1.2d0d43196ce88p-51,
+    0x1.2ee0db1a96c02p-51, 0x1.30becd256a217p-51, 0x1.32a7b5e6897e9p-51,
+    0x1.349c405ae0606p-51, 0x1.369d27a339bc1p-51, 0x1.38ab3925634a9p-51,
+    0x1.3ac7570ae7cb8p-51, 0x1.3cf27b316f883p-51, 0x1.3f2dbaa60e871p-51,
+    0x1.417a49cb9d9f6p-51, 0x1.43d98155452d1p-51, 0x1.464ce44a72e74p-51,
+    0x1.48d62759c383dp-51, 0x1.4b7739d6b4eccp-51, 0x1.4e3250dcd7dccp-51,
+    0x1.5109f53e9a131p-51, 0x1.54011523a7359p-51, 0x1.571b1a94ad95ap-51,
+    0x1.5a5c08b718342p-51, 0x1.5dc8a243ac693p-51, 0x1.61669cf86140fp-51,
+    0x1.653ce7b0060dfp-51, 0x1.69540be9fdbedp-51, 0x1.6db6b8d09d896p-51,
+    0x1.72728f05f70d7p-51, 0x1.779955608fd5bp-51, 0x1.7d42df4d6c5c3p-51,
+    0x1.839030529e9c6p-51, 0x1.8ab0fbfaa7412p-51, 0x1.92ee0946f3d1ap-51,
+    0x1.9cbee014050dfp-51, 0x1.a8fdc7894718cp-51, 0x1.b981f3878f995p-51,
+    0x1.d3bb48209ad33p-51
+};
+
+inline constexpr double NORMAL_F[256] = {
+    0x1.0000000000000p+0, 0x1.f446ac97c0265p-1, 0x1.eb7545b6e5a2dp-1,
+    0x1.e3f11e0296bb2p-1, 0x1.dd36fa70635f9p-1, 0x1.d70920658fa12p-1,
+    0x1.d144978a24289p-1, 0x1.cbd33a8a84602p-1, 0x1.c6a5eceaa82b8p-1,
+    0x1.c1b1cd9efb947p-1, 0x1.bceeb4ee2d08dp-1, 0x1.b85653a90e040p-1,
+    0x1.b3e3a8235bfdap-1, 0x1.af92a3f6dc413p-1, 0x1.ab5fef17af9c6p-1,
+    0x1.a748bd5519883p-1, 0x1.a34aafdf6780cp-1, 0x1.9f63bee65e399p-1,
+    0x1.9b9228d24c563p-1, 0x1.97d4657623514p-1, 0x1.94291c21c3052p-1,
+    0x1.908f1bd322352p-1, 0x1.8d0554fe6b8dcp-1, 0x1.898ad48bb899ap-1,
+    0x1.861ebfc3863d6p-1, 0x1.82c050f577355p-1, 0x1.7f6ed4b218395p-1,
+    0x1.7c29a779d0627p-1, 0x1.78f033ca14bc9p-1, 0x1.75c1f0771708dp-1,
+    0x1.729e5f44002a7p-1, 0x1.6f850baeb0dfbp-1, 0x1.6c7589e63eb25p-1,
+    0x1.696f75e51c96bp-1, 0x1.667272a936f1ep-1, 0x1.637e2985595dfp-1,
+    0x1.609249880ae0ap-1, 0x1.5dae86f4b84fep-1, 0x1.5ad29acc8e01cp-1,
+    0x1.57fe4264d0f30p-1, 0x1.55313f08e1e03p-1, 0x1.526b55a65eabbp-1,
+    0x1.4fac4e8213283p-1, 0x1.4cf3f4f49c91ep-1, 0x1.4a42172dccb23p-1,
+    0x1.479685fdfc714p-1, 0x1.44f114a49abddp-1, 0x1.425198a35d3b3p-1,
+    0x1.3fb7e9958cdc7p-1, 0x1.3d23e10afa266p-1, 0x1.3a955a6633c57p-1,
+    0x1.380c32bda6eadp-1, 0x1.358848bf5bd57p-1, 0x1.33097c970a541p-1,
+    0x1.308fafd64a29fp-1, 0x1.2e1ac55eaa449p-1, 0x1.2baaa14d7fc57p-1,
+    0x1.293f28e9432dbp-1, 0x1.26d8429056971p-1, 0x1.2475d5a913eccp-1,
+    0x1.2217ca9305a04p-1, 0x1.1fbe0a992f702p-1, 0x1.1d687fe54f920p-1,
+    0x1.1b17157402fa1p-1, 0x1.18c9b709b99bdp-1, 0x1.168051286962ap-1,
+    0x1.143ad105f04d3p-1, 0x1.11f924831795cp-1, 0x1.0fbb3a232b228p-1,
+    0x1.0d81010419aaap-1, 0x1.0b4a68d7130b1p-1, 0x1.091761d99b381p-1,
+    0x1.06e7dccf09138p-1, 0x1.04bbcafa69335p-1, 0x1.02931e18bd539p-1,
+    0x1.006dc85b91cdep-1, 0x1.fc9778c7c5ff1p-2, 0x1.f859da7a9a13dp-2,
+    0x1.f4229cb301990p-2, 0x1.eff1a717f2c62p-2, 0x1.ebc6e20bdba59p-2,
+    0x1.e7a236a4f5d07p-2, 0x1.e3838ea603307p-2, 0x1.df6ad4776cfd2p-2,
+    0x1.db57f320beac8p-2, 0x1.d74ad6427709cp-2, 0x1.d3436a102a142p-2,
+    0x1.cf419b4aeea8ep-2, 0x1.cb45573c135cbp-2, 0x1.c74e8bb0163b2p-2,
+    0x1.c35d26f1db70fp-2, 0x1.bf7117c61f2dep-2, 0x1.bb8a4d671f4cdp-2,
+    0x1.b7a8b780798d0p-2, 0x1.b3cc462b3b5fcp-2, 0x1.aff4e9ea20806p-2,
+    0x1.ac2293a5fdbd7p-2, 0x1.a85534aa55844p-2, 0x1.a48cbea213e9ep-2,
+    0x1.a0c923947011ep-2, 0x1.9d0a55e1f0f53p-2, 0x1.9950484193ad3p-2,
+    0x1.959aedbe1183bp-2, 0x1.91ea39b344260p-2, 0x1.8e3e1fcba6703p-2,
+    0x1.8a9693fdf061cp-2, 0x1.86f38a8accdf4p-2, 0x1.8354f7faa7fc5p-2,
+    0x1.7fbad11b949adp-2, 0x1.7c250aff48400p-2, 0x1.78939af92c0f3p-2,
+    0x1.7506769c81eafp-2, 0x1.717d93ba9cccdp-2, 0x1.6df8e8612b6ecp-2,
+    0x1.6a786ad894727p-2, 0x1.66fc11a2633afp-2, 0x1.6383d377c4babp-2,
+    0x1.600fa74813828p-2, 0x1.5c9f843772671p-2, 0x1.5933619d751bcp-2,
+    0x1.55cb3703d62d1p-2, 0x1.5266fc2539c94p-2, 0x1.4f06a8ebfcd13p-2,
+    0x1.4baa35710fafep-2, 0x1.485199fadc80dp-2, 0x1.44fccefc38117p-2,
+    0x1.41abcd135d515p-2, 0x1.3e5e8d08f2cbbp-2, 0x1.3b1507cf19c77p-2,
+    0x1.37cf368086b2cp-2, 0x1.348d125fa283fp-2, 0x1.314e94d5b4bbep-2,
+    0x1.2e13b77215be5p-2, 0x1.2adc73e96934ep-2, 0x1.27a8c414e0385p-2,
+    0x1.2478a1f182fe8p-2, 0x1.214c079f81cf7p-2, 0x1.1e22ef618d06bp-2,
+    0x1.1afd539c33ea1p-2, 0x1.17db2ed54a239p-2, 0x1.14bc7bb353ab8p-2,
+    0x1.11a134fcf6f75p-2, 0x1.0e8955987541ap-2, 0x1.0b74d88b28c36p-2,
+    0x1.0863b8f908b9bp-2, 0x1.0555f22433149p-2, 0x1.024b7f6c7baf9p-2,
+    0x1.fe88b89e01ed8p-3, 0x1.f88108cb8bb6bp-3, 0x1.f27fe6cea202ap-3,
+    0x1.ec854a4ca21c2p-3, 0x1.e6912b228c089p-3, 0x1.e0a381645f35fp-3,
+    0x1.dabc455c81015p-3, 0x1.d4db6f8b2cf92p-3, 0x1.cf00f8a5eec4bp-3,
+    0x1.c92cd99725a10p-3, 0x1.c35f0b7d91641p-3, 0x1.bd9787abe8fdep-3,
+    0x1.b7d647a87a72bp-3, 0x1.b21b452cd4505p-3, 0x1.ac667a2578a1bp-3,
+    0x1.a6b7e0b1996e0p-3, 0x1.a10f7322decf1p-3, 0x1.9b6d2bfd36b63p-3,
+    0x1.95d105f6ae788p-3, 0x1.903afbf756425p-3, 0x1.8aab09192e973p-3,
+    0x1.852128a8200b0p-3, 0x1.7f9d5621fd650p-3, 0x1.7a1f8d3690665p-3,
+    0x1.74a7c9c7b1751p-3, 0x1.6f3607e96a72fp-3, 0x1.69ca43e2250e8p-3,
+    0x1.64647a2ae4e9cp-3, 0x1.5f04a76f8df6fp-3, 0x1.59aac88f3775cp-3,
+    0x1.5456da9c8c09dp-3, 0x1.4f08dade376a4p-3, 0x1.49c0c6cf6238ep-3,
+    0x1.447e9c203c9b4p-3, 0x1.3f4258b698410p-3, 0x1.3a0bfaae928d4p-3,
+    0x1.34db805b4fafap-3, 0x1.2fb0e847c7863p-3, 0x1.2a8c3137a53a6p-3,
+    0x1.256d5a283a9d2p-3, 0x1.20546251885e5p-3, 0x1.1b4149275c58ap-3,
+    0x1.16340e5a87443p-3, 0x1.112cb1da2b434p-3, 0x1.0c2b33d524dd1p-3,
+    0x1.072f94bb9023dp-3, 0x1.0239d5406be88p-3, 0x1.fa93ecb6ba232p-4,
+    0x1.f0bff29528b67p-4, 0x1.e6f7bf29b1feap-4, 0x1.dd3b561776082p-4,
+    0x1.d38abb9be0731p-4, 0x1.c9e5f493be6bdp-4, 0x1.c04d0680b802cp-4,
+    0x1.b6bff78f34fb7p-4, 0x1.ad3ece9cb6128p-4, 0x1.a3c9933eacaf5p-4,
+    0x1.9a604dc9dc0fep-4, 0x1.9103075a50413p-4, 0x1.87b1c9dbf893ep-4,
+    0x1.7e6ca013f4e4dp-4, 0x1.753395aaa6d7fp-4, 0x1.6c06b7369a3e7p-4,
+    0x1.62e612485a445p-4, 0x1.59d1b5774bb6bp-4, 0x1.50c9b06fa7e17p-4,
+    0x1.47ce1401b7223p-4, 0x1.3edef2326e83cp-4, 0x1.35fc5e4d989d0p-4,
+    0x1.2d266cf9b7a28p-4, 0x1.245d344dd5460p-4, 0x1.1ba0cbe97ce08p-4,
+    0x1.12f14d0f259e6p-4, 0x1.0a4ed2c15d631p-4, 0x1.01b979e31226fp-4,
+    0x1.f262c2b6ce583p-5, 0x1.e16d547b2c47cp-5, 0x1.d092efeae600ap-5,
+    0x1.bfd3e0f289491p-5, 0x1.af3079038c597p-5, 0x1.9ea90f929b758p-5,
+    0x1.8e3e02a691375p-5, 0x1.7defb77af80c9p-5, 0x1.6dbe9b3992600p-5,
+    0x1.5dab23cf2ff69p-5, 0x1.4db5d0e1174f2p-5, 0x1.3ddf2ce993869p-5,
+    0x1.2e27ce83e3a4fp-5, 0x1.1e9059f1fac92p-5, 0x1.0f1982e96be0fp-5,
+    0x1.ff881d7191a2cp-6, 0x1.e121adb82f964p-6, 0x1.c301983cd6ea9p-6,
+    0x1.a529f4e234a42p-6, 0x1.879d1b6011823p-6, 0x1.6a5daf40c0f87p-6,
+    0x1.4d6eaf2fbf966p-6, 0x1.30d388daba032p-6, 0x1.1490334606b67p-6,
+    0x1.f152a4f734696p-7, 0x1.ba48d274febdcp-7, 0x1.841040d8df3cap-7,
+    0x1.4eb96421b129fp-7, 0x1.1a5922995660bp-7, 0x1.ce160f8ecbd47p-8,
+    0x1.69ea8d90cf658p-8, 0x1.08a1f03b0d9d6p-8, 0x1.55f9f43c1d644p-9,
+    0x1.4a605b6b9f70fp-10
+};
+
+/**
+ * @brief Ziggurat tables of 256 layers for the exponential density `exp(-x)`, laid out like the normal ones.
+ */
+inline constexpr double EXPONENTIAL_R = 0x1.ec9d9297ebb83p+2;
+
+inline constexpr uint64_t EXPONENTIAL_K[256] = {
+    0xe290a13924be2, 0x0000000000000, 0x9beadebce1892, 0xc377ac71f9df8,
+    0xd4ddb9907584d, 0xde893fb8ca239, 0xe4a8e87c43289, 0xe8dff16ae1cb8,
+    0xebf2deab58c59, 0xee49a6e8b9637, 0xf0204efd64ee4, 0xf19bdb8ea3c1a,
+    0xf2d458bbe5bd0, 0xf3da104b78236, 0xf4b86d784571e, 0xf577ad8a7784f,
+    0xf61de83da32ab, 0xf6afb7843cce6, 0xf730a57372b44, 0xf7a37651b0e67,
+    0xf80a5bb6eea51, 0xf867189d3cb5a, 0xf8bb1b4f8fbbd, 0xf9079062292b8,
+    0xf94d70ca8d43a, 0xf98d8c7dcaa9a, 0xf9c8928abe083, 0xf9ff175b734a6,
+    0xfa319996bc47d, 0xfa6085f8e9d08, 0xfa8c3a62e1991, 0xfab5084e1f660,
+    0xfadb36c84ccca, 0xfaff041086847, 0xfb20a6ea22bb8, 0xfb404fb42cb3d,
+    0xfb5e295158173, 0xfb7a59e99727a, 0xfb95038c8789c, 0xfbae44ba684ec,
+    0xfbc638d822e60, 0xfbdcf89209ffa, 0xfbf29a303cfc5, 0xfc0731df1089c,
+    0xfc1ad1ed6c8b1, 0xfc2d8b02b5c89, 0xfc3f6c4d92131, 0xfc5083ac9ba7e,
+    0xfc60ddd1e9cd6, 0xfc7086622e825, 0xfc7f881009f0b, 0xfc8decb41ac71,
+    0xfc9bbd623d7eb, 0xfca9027c5b26d, 0xfcb5c3c319c4a, 0xfcc20864b4448,
+    0xfccdd70a35d40, 0xfcd935e34bf80, 0xfce42ab0db8bd, 0xfceebace7ec02,
+    0xfcf8eb3b0d0e7, 0xfd02c0a049b60, 0xfd0c3f59d199d, 0xfd156b7b5e27e,
+    0xfd1e48d670341, 0xfd26daff73551, 0xfd2f2552684bf, 0xfd372af7233c1,
+    0xfd3eeee528f62, 0xfd4673e73543b, 0xfd4dbc9e72ff8, 0xfd54cb856dc2c,
+    0xfd5ba2f2c4118, 0xfd62451ba02c2, 0xfd68b415fcff5, 0xfd6ef1dabc161,
+    0xfd75004790eb6, 0xfd7ae120c583f, 0xfd809612dbd09, 0xfd8620b40effa,
+    0xfd8b8285b78fe, 0xfd90bcf594b1c, 0xfd95d15efd425, 0xfd9ac10bfa70c,
+    0xfd9f8d364df06, 0xfda437086566b, 0xfda8bf9e3c9ff, 0xfdad28062fed5,
+    0xfdb17141bff2d, 0xfdb59c4648085, 0xfdb9a9fda83cc, 0xfdbd9b46e3ed4,
+    0xfdc170f6b5d05, 0xfdc52bd81a3fb, 0xfdc8ccacd07ba, 0xfdcc542dd3902,
+    0xfdcfc30bcb793, 0xfdd319ef77143, 0xfdd6597a0f60b, 0xfdd98245a48a2,
+    0xfddc94e575272, 0xfddf91e64014e, 0xfde279ce914cb, 0xfde54d1f0a06a,
+    0xfde80c52a47d0, 0xfdeab7def394e, 0xfded50345eb36, 0xfdefd5be59fa1,
+    0xfdf248e39b26f, 0xfdf4aa064b4b0, 0xfdf6f98435894, 0xfdf937b6f30ba,
+    0xfdfb64f414571, 0xfdfd818d48262, 0xfdff8dd07fed9, 0xfe018a08122c4,
+    0xfe03767adaa5a, 0xfe05536c58a14, 0xfe07211ccb4c5, 0xfe08dfc94c532,
+    0xfe0a8fabe8ca1, 0xfe0c30fbb87a6, 0xfe0dc3ecf3a5a, 0xfe0f48b107521,
+    0xfe10bf76a82ef, 0xfe122869e4200, 0xfe1383b4327e1, 0xfe14d17c83188,
+    0xfe1611e74c023, 0xfe1745169635a, 0xfe186b2a09177, 0xfe19843ef4e07,
+    0xfe1a90705bf64, 0xfe1b8fd6fb37c, 0xfe1c828951443, 0xfe1d689ba4bfd,
+    0xfe1e4220099a4, 0xfe1f0f26655a0, 0xfe1fcfbc726d4, 0xfe2083edc2830,
+    0xfe212bc3bfeb4, 0xfe21c745adfe3, 0xfe225678a8895, 0xfe22d95fa23f4,
+    0xfe234ffb62282, 0xfe23ba4a800d9, 0xfe2418495fddd, 0xfe2469f22bffb,
+    0xfe24af3cce90e, 0xfe24e81ee9858, 0xfe25148bcda1a, 0xfe253474703fe,
+    0xfe2547c75fdc6, 0xfe254e70b754f, 0xfe25485a0fd1b, 0xfe25356a71450,
+    0xfe2515864173b, 0xfe24e88f316f1, 0xfe24ae64296fa, 0xfe2466e132f60,
+    0xfe2411df611bd, 0xfe23af34b6f73, 0xfe233eb40bf41, 0xfe22c02cee01c,
+    0xfe22336b81711, 0xfe2198385e5cd, 0xfe20ee586b707, 0xfe20358cb5dfb,
+    0xfe1f6d92465b1, 0xfe1e9621f2c9f, 0xfe1daef02c8da, 0xfe1cb7accb0a6,
+    0xfe1bb002d22ca, 0xfe1a9798349b9, 0xfe196e0d9140d, 0xfe1832fdebc44,
+    0xfe16e5fe5f932, 0xfe15869dccfd0, 0xfe1414647fe78, 0xfe128ed3cf8b2,
+    0xfe10f565b69cf, 0xfe0f478c633ab, 0xfe0d84b1bdd9e, 0xfe0bac36e6687,
+    0xfe09bd73a6b5c, 0xfe07b7b5d920b, 0xfe059a40c26d2, 0xfe03644c5d7f8,
+    0xfe011504979b2, 0xfdfeab887b95d, 0xfdfc26e94a448, 0xfdf986297e306,
+    0xfdf6c83bb8663, 0xfdf3ec0193eee, 0xfdf0f04a5d30a, 0xfdedd3d1aa204,
+    0xfdea953dcfc13, 0xfde7331e3100d, 0xfde3abe9626f2, 0xfddffdfb1dbd5,
+    0xfddc2791ff351, 0xfdd826cd068c7, 0xfdd3f9a8d3856, 0xfdcf9dfc95b0d,
+    0xfdcb1176a55fe, 0xfdc65198ba50c, 0xfdc15bb3b2daa, 0xfdbc2ce2dc4ae,
+    0xfdb6c206aaaca, 0xfdb117becb4a1, 0xfdab2a6379bf1, 0xfda4f5fdfb4e9,
+    0xfd9e76401f3a3, 0xfd97a67a9ce20, 0xfd9081922142a, 0xfd8901f2d4b02,
+    0xfd812182170e1, 0xfd78d98e23cd3, 0xfd7022bb3f083, 0xfd66f4edf96b9,
+    0xfd5d473200305, 0xfd530f9ccff94, 0xfd48432b7b351, 0xfd3cd59a8469e,
+    0xfd30b9368f909, 0xfd23dea45f500, 0xfd16349e2e04a, 0xfd07a7a3ef98b,
+    0xfcf8219b5df05, 0xfce7895bcfcde, 0xfcd5c220ad5e2, 0xfcc2aadbc17dc,
+    0xfcae1d5e81fbd, 0xfc97ed4e778f9, 0xfc7fe6d4d720e, 0xfc65ccf39c2fc,
+    0xfc4957623cb04, 0xfc2a2fc826dc8, 0xfc07ee19b01cd, 0xfbe213c1cf493,
+    0xfbb8051ac1567, 0xfb890078d120e, 0xfb5411a5b9a96, 0xfb18000547133,
+    0xfad334827f1e3, 0xfa839276708b9, 0xfa263b32e37ed, 0xf9b72d1c52cd2,
+    0xf930a1a281a04, 0xf889f023d820a, 0xf7b577d2be5f3, 0xf69c650c40a8f,
+    0xf51530f0916d9, 0xf2cb0e3c5933e, 0xeeefb15d605d8, 0xe6da6ecf27460
+};
+
+inline constexpr double EXPONENTIAL_W[256] = {
+    0x1.164ec94bf5dc3p-49, 0x1.0589d8b5d408fp-56, 0x1.ad6b2495b4cc6p-56,
+    0x1.19335a95b8d8ep-55, 0x1.522e6e54a2a4ep-55, 0x1.85090fbc27a5ep-55,
+    0x1.b38d1ef79b7aep-55, 0x1.decd8b76dbd7bp-55, 0x1.03bf049c65c2dp-54,
+    0x1.170db24d6f662p-54, 0x1.2980290da2625p-54, 0x1.3b388fe3d6ebdp-54,
+    0x1.4c515c60bfe16p-54, 0x1.5cdf89d024ab7p-54, 0x1.6cf40f0a72bb2p-54,
+    0x1.7c9cdda17d00ep-54, 0x1.8be5954d36063p-54, 0x1.9ad80552237c7p-54,
+    0x1.a97c8be5d51f8p-54, 0x1.b7da5dddda3b9p-54, 0x1.c5f7bd78c3f7fp-54,
+    0x1.d3da24df17c2dp-54, 0x1.e186678f17352p-54, 0x1.ef00ccf5f4fa3p-54,
+    0x1.fc4d25d683201p-54, 0x1.04b76ed6a7553p-53, 0x1.0b348479b80f7p-53,
+    0x1.119f38749f5aap-53, 0x1.17f8ceb4bdf9bp-53, 0x1.1e426e93e49e1p-53,
+    0x1.247d26538ff28p-53, 0x1.2aa9ee1236804p-53, 0x1.30c9aa526da45p-53,
+    0x1.36dd2e26d81fbp-53, 0x1.3ce53d121629ap-53, 0x1.42e28ca706742p-53,
+    0x1.48d5c5f35e70cp-53, 0x1.4ebf86bcd0b8dp-53, 0x1.54a0629786f47p-53,
+    0x1.5a78e3db8bef6p-53, 0x1.60498c7dd2ec8p-53, 0x1.6612d6d0c68dap-53,
+    0x1.6bd5362faa93ep-53, 0x1.71911797990b5p-53, 0x1.7746e2307796dp-53,
+    0x1.7cf6f7c7e816cp-53, 0x1.82a1b53fed593p-53, 0x1.884772f2be1e5p-53,
+    0x1.8de8850d0c523p-53, 0x1.93853bdfda23dp-53, 0x1.991de42ad1332p-53,
+    0x1.9eb2c75ff03b8p-53, 0x1.a4442be148844p-53, 0x1.a9d255396d25bp-53,
+    0x1.af5d844f224c2p-53, 0x1.b4e5f794c9795p-53, 0x1.ba6beb33f8f83p-53,
+    0x1.bfef99359fe92p-53, 0x1.c57139a70d298p-53, 0x1.caf102bc25ad4p-53,
+    0x1.d06f28ef0e6f4p-53, 0x1.d5ebdf1d86b87p-53, 0x1.db6756a429050p-53,
+    0x1.e0e1bf77c31f8p-53, 0x1.e65b483cf103ep-53, 0x1.ebd41e5e21b5dp-53,
+    0x1.f14c6e2029499p-53, 0x1.f6c462b57feb0p-53, 0x1.fc3c26504a99cp-53,
+    0x1.00d9f119a3cd6p-52, 0x1.0395df60db15fp-52, 0x1.0651f1c7276f5p-52,
+    0x1.090e3bb4b0070p-52, 0x1.0bcad03710135p-52, 0x1.0e87c207a2f64p-52,
+    0x1.114523917ac13p-52, 0x1.140306f707dbcp-52, 0x1.16c17e1777ff9p-52,
+    0x1.19809a93d2394p-52, 0x1.1c406dd3d5281p-52, 0x1.1f01090a9c4e0p-52,
+    0x1.21c27d3b10e04p-52, 0x1.2484db3c2a329p-52, 0x1.274833bd0189fp-52,
+    0x1.2a0c9748bcda9p-52, 0x1.2cd2164a53b5dp-52, 0x1.2f98c11031720p-52,
+    0x1.3260a7cfb7611p-52, 0x1.3529daa8a1ba0p-52, 0x1.37f469a851aefp-52,
+    0x1.3ac064ccfeffcp-52, 0x1.3d8ddc08d336ep-52, 0x1.405cdf44f09c4p-52,
+    0x1.432d7e6466cd0p-52, 0x1.45ffc94716ca7p-52, 0x1.48d3cfcc883c4p-52,
+    0x1.4ba9a1d6b18a5p-52, 0x1.4e814f4cb45ebp-52, 0x1.515ae81d900fcp-52,
+    0x1.54367c42cb5f9p-52, 0x1.57141bc316f27p-52, 0x1.59f3d6b4e9cfap-52,
+    0x1.5cd5bd4119336p-52, 0x1.5fb9dfa56cf28p-52, 0x1.62a04e3731a2fp-52,
+    0x1.65891965c9b8ep-52, 0x1.687451bd3ebf0p-52, 0x1.6b6207e8d3ce1p-52,
+    0x1.6e524cb59a609p-52, 0x1.714531150a9fcp-52, 0x1.743ac61fa041dp-52,
+    0x1.77331d177d131p-52, 0x1.7a2e476b1240cp-52, 0x1.7d2c56b7d17f9p-52,
+    0x1.802d5ccce7278p-52, 0x1.83316badfe62bp-52, 0x1.86389596108e8p-52,
+    0x1.8942ecfa40f55p-52, 0x1.8c50848cc6095p-52, 0x1.8f616f3fe1514p-52,
+    0x1.9275c048e73e2p-52, 0x1.958d8b235828bp-52, 0x1.98a8e3940bbf5p-52,
+    0x1.9bc7ddac7035ep-52, 0x1.9eea8dcdde952p-52, 0x1.a21108ad0592ep-52,
+    0x1.a53b63556c691p-52, 0x1.a869b32d0f310p-52, 0x1.ab9c0df81657bp-52,
+    0x1.aed289dcaad00p-52, 0x1.b20d3d66e8bb6p-52, 0x1.b54c3f8cf2543p-52,
+    0x1.b88fa7b324fb7p-52, 0x1.bbd78db072612p-52, 0x1.bf2409d2dfd87p-52,
+    0x1.c27534e42e02fp-52, 0x1.c5cb282eab1a7p-52, 0x1.c925fd82323fep-52,
+    0x1.cc85cf395a56ep-52, 0x1.cfeab83ed7182p-52, 0x1.d354d4130f2b0p-52,
+    0x1.d6c43ed1ea401p-52, 0x1.da391538da50cp-52, 0x1.ddb374ad23581p-52,
+    0x1.e1337b426509dp-52, 0x1.e4b947c16a454p-52, 0x1.e844f9af42381p-52,
+    0x1.ebd6b154a767ap-52, 0x1.ef6e8fc5b9169p-52, 0x1.f30cb6ea0bc81p-52,
+    0x1.f6b1498515ed1p-52, 0x1.fa5c6b3efe1e6p-52, 0x1.fe0e40add09d9p-52,
+    0x1.00e377af911d5p-51, 0x1.02c34ef11391bp-51, 0x1.04a6b9e9224a3p-51,
+    0x1.068dccf1126dbp-51, 0x1.08789cf3aad0fp-51, 0x1.0a673f733c81ap-51,
+    0x1.0c59ca9009470p-51, 0x1.0e50550efcfb8p-51, 0x1.104af660befcfp-51,
+    0x1.1249c6a92154bp-51, 0x1.144cdec6f3a2cp-51, 0x1.1654585c404c1p-51,
+    0x1.18604dd6fae9ep-51, 0x1.1a70da7a27821p-51, 0x1.1c861a6782a5bp-51,
+    0x1.1ea02aa9b3371p-51, 0x1.20bf293f0f4a2p-51, 0x1.22e33524fe550p-51,
+    0x1.250c6e6403bbap-51, 0x1.273af61c7daa6p-51, 0x1.296eee942532bp-51,
+    0x1.2ba87b445db50p-51, 0x1.2de7c0e962d70p-51, 0x1.302ce59265964p-51,
+    0x1.327810b2aa7cfp-51, 0x1.34c96b33bc965p-51, 0x1.37211f88ca856p-51,
+    0x1.397f59c345143p-51, 0x1.3be447a8d8b83p-51, 0x1.3e5018caddecfp-51,
+    0x1.40c2fe9f5eeadp-51, 0x1.433d2c9bd42f8p-51, 0x1.45bed851bc92cp-51,
+    0x1.4848398d39432p-51, 0x1.4ad98a75da14cp-51, 0x1.4d7307b1cb127p-51,
+    0x1.5014f08b99508p-51, 0x1.52bf871acaab1p-51, 0x1.5573106f8a759p-51,
+    0x1.582fd4c1b4460p-51, 0x1.5af61fa38e106p-51, 0x1.5dc640388bd9cp-51,
+    0x1.60a0897081877p-51, 0x1.63855247b2e93p-51, 0x1.6674f60c3f431p-51,
+    0x1.696fd4a9748eep-51, 0x1.6c7652f9a7b1ep-51, 0x1.6f88db1f42507p-51,
+    0x1.72a7dce5cd218p-51, 0x1.75d3ce2bd71c3p-51, 0x1.790d2b56b71f9p-51,
+    0x1.7c5477d1476d3p-51, 0x1.7faa3e96e1412p-51, 0x1.830f12cc0bec3p-51,
+    0x1.8683906687341p-51, 0x1.8a085ce695baap-51, 0x1.8d9e2823b3695p-51,
+    0x1.9145ad2f37543p-51, 0x1.94ffb34fc2a0dp-51, 0x1.98cd0f18d1ad7p-51,
+    0x1.9caea3a24d9e9p-51, 0x1.a0a563e49f177p-51, 0x1.a4b2543e84c3ap-51,
+    0x1.a8d68c2ad86e8p-51, 0x1.ad13382d845c3p-51, 0x1.b1699c003b608p-51,
+    0x1.b5db15091ea0ep-51, 0x1.ba691d276da5dp-51, 0x1.bf154de4bef76p-51,
+    0x1.c3e1641c2e0a6p-51, 0x1.c8cf442c8c8f3p-51, 0x1.cde0fecf2a97fp-51,
+    0x1.d318d6b2738c5p-51, 0x1.d87946fec3becp-51, 0x1.de050af4ef19fp-51,
+    0x1.e3bf26e190960p-51, 0x1.e9aaf2af383c1p-51, 0x1.efcc26750ea4ap-51,
+    0x1.f626e9791f7a7p-51, 0x1.fcbfe43f6c6e6p-51, 0x1.01ce2b362ec2ep-50,
+    0x1.056118bf58eefp-50, 0x1.091c1cdcba54ep-50, 0x1.0d031785d48a0p-50,
+    0x1.111a8034392a6p-50, 0x1.156786775442ap-50, 0x1.19f03bcb3c2d6p-50,
+    0x1.1ebbca0c9fa7cp-50, 0x1.23d2bb659919fp-50, 0x1.293f5ae49aaa5p-50,
+    0x1.2f0e38a4411f0p-50, 0x1.354ee27ccf75dp-50, 0x1.3c14ec7c8b860p-50,
+    0x1.4379766e41361p-50, 0x1.4b9d7cd4751d0p-50, 0x1.54ad83ccf73f5p-50,
+    0x1.5ee7ae17313d2p-50, 0x1.6aa676d4bbf72p-50, 0x1.78750d6eac62fp-50,
+    0x1.8939fe6f2ed19p-50, 0x1.9e9dc0d487b85p-50, 0x1.bc39e51da71fcp-50,
+    0x1.ec9d9297ebb83p-50
+};
+
+inline constexpr double EXPONENTIAL_F[256] = {
+    0x1.0000000000000p+0, 0x1.e0545e5881147p-1, 0x1.cd0a65081fffcp-1,
+    0x1.be5007beb7b31p-1, 0x1.b210f0ee67f32p-1, 0x1.a76baa562faeep-1,
+    0x1.9de9715556da1p-1, 0x1.95431c455aa3fp-1, 0x1.8d4a376d3d235p-1,
+    0x1.85de87806c5bdp-1, 0x1.7ee8a2d24312bp-1, 0x1.7856e9b09d483p-1,
+    0x1.721bb5ba94b67p-1, 0x1.6c2c3498418cap-1, 0x1.667fa6d4f5c0ap-1,
+    0x1.610edc1a7af6ap-1, 0x1.5bd3d694cac79p-1, 0x1.56c9882da8777p-1,
+    0x1.51eba1578899ep-1, 0x1.4d366c151f8b2p-1, 0x1.48a6afb8ee06cp-1,
+    0x1.44399afa8e128p-1, 0x1.3fecb2bb18b82p-1, 0x1.3bbdc44e1d116p-1,
+    0x1.37aada708dddcp-1, 0x1.33b23450e631bp-1, 0x1.2fd23e345da61p-1,
+    0x1.2c098b61f4f27p-1, 0x1.2856d111132c0p-1, 0x1.24b8e228c50a6p-1,
+    0x1.212eaba813eccp-1, 0x1.1db7319877b8dp-1, 0x1.1a518c71e3b29p-1,
+    0x1.16fce6dce6ff2p-1, 0x1.13b87bc33169fp-1, 0x1.108394a1cc390p-1,
+    0x1.0d5d8812b1e2ep-1, 0x1.0a45b8854d02dp-1, 0x1.073b931ee3b80p-1,
+    0x1.043e8ebd2654bp-1, 0x1.014e2b160f327p-1, 0x1.fcd3dfe21457cp-2,
+    0x1.f722d8ebfc600p-2, 0x1.f1886d1eb4253p-2, 0x1.ec03d4b969d96p-2,
+    0x1.e6945367dd357p-2, 0x1.e139375e13802p-2, 0x1.dbf1d88a72112p-2,
+    0x1.d6bd97db9ed80p-2, 0x1.d19bde97e1a11p-2, 0x1.cc8c1dc40e098p-2,
+    0x1.c78dcd983fb66p-2, 0x1.c2a06d00ea588p-2, 0x1.bdc3812aeeebbp-2,
+    0x1.b8f6951990b8ep-2, 0x1.b439394548075p-2, 0x1.af8b03428ef65p-2,
+    0x1.aaeb8d6fdf6ebp-2, 0x1.a65a76aa30145p-2, 0x1.a1d76207521f9p-2,
+    0x1.9d61f695a3797p-2, 0x1.98f9df2097badp-2, 0x1.949ec9f9a8115p-2,
+    0x1.905068c545d09p-2, 0x1.8c0e704b75d3ep-2, 0x1.87d8984bc3f90p-2,
+    0x1.83ae9b544613dp-2, 0x1.7f90369b6ce5dp-2, 0x1.7b7d29dc68022p-2,
+    0x1.77753735e72e7p-2, 0x1.7378230b08deep-2, 0x1.6f85b3e649ea1p-2,
+    0x1.6b9db25e4e99fp-2, 0x1.67bfe8fc60da1p-2, 0x1.63ec2424827e7p-2,
+    0x1.602231fef5879p-2, 0x1.5c61e2631ee6fp-2, 0x1.58ab06c3aa9f1p-2,
+    0x1.54fd721bda3e9p-2, 0x1.5158f8dde89f7p-2, 0x1.4dbd70e26f920p-2,
+    0x1.4a2ab158bdad4p-2, 0x1.46a092b80beefp-2, 0x1.431eeeb1841e2p-2,
+    0x1.3fa5a0230a14fp-2, 0x1.3c34830abb285p-2, 0x1.38cb747b17defp-2,
+    0x1.356a528fcd0ddp-2, 0x1.3210fc6312436p-2, 0x1.2ebf520394271p-2,
+    0x1.2b75346ae2263p-2, 0x1.2832857457628p-2, 0x1.24f727d4776fdp-2,
+    0x1.21c2ff10b7effp-2, 0x1.1e95ef77b09dap-2, 0x1.1b6fde19abc59p-2,
+    0x1.1850b0c191981p-2, 0x1.15384dee291eep-2, 0x1.12269ccba9fb9p-2,
+    0x1.0f1b852d9a66bp-2, 0x1.0c16ef88f5332p-2, 0x1.0918c4ee93e12p-2,
+    0x1.0620ef05d90d1p-2, 0x1.032f580797c2bp-2, 0x1.0043eab934769p-2,
+    0x1.fabd24cff9351p-3, 0x1.f4fe75c963e7bp-3, 0x1.ef4ba0fe8e098p-3,
+    0x1.e9a48005940efp-3, 0x1.e408ed62f83a4p-3, 0x1.de78c48224f37p-3,
+    0x1.d8f3e1ae3eeb6p-3, 0x1.d37a220b431fap-3, 0x1.ce0b638f6d09bp-3,
+    0x1.c8a784fce17ffp-3, 0x1.c34e65db9afecp-3, 0x1.bdffe67394433p-3,
+    0x1.b8bbe7c72e4a3p-3, 0x1.b3824b8dcef3cp-3, 0x1.ae52f42eb5b0ap-3,
+    0x1.a92dc4bc03c47p-3, 0x1.a412a0edf5cbap-3, 0x1.9f016d1e4c510p-3,
+    0x1.99fa0e43e1621p-3, 0x1.94fc69ee6929fp-3, 0x1.900866425bb78p-3,
+    0x1.8b1de9f5062d3p-3, 0x1.863cdc48c1af8p-3, 0x1.816525094e7e4p-3,
+    0x1.7c96ac8851badp-3, 0x1.77d15b99f46fdp-3, 0x1.73151b91a2838p-3,
+    0x1.6e61d63ee84e9p-3, 0x1.69b775ea6da26p-3, 0x1.6515e5530d1a9p-3,
+    0x1.607d0fab06a2ep-3, 0x1.5bece0954c2b2p-3, 0x1.57654422e78f1p-3,
+    0x1.52e626d078c46p-3, 0x1.4e6f7583cb6f7p-3, 0x1.4a011d8983093p-3,
+    0x1.459b0c92dccc3p-3, 0x1.413d30b386a97p-3, 0x1.3ce7785f8a903p-3,
+    0x1.3899d2694d5c7p-3, 0x1.34542dffa0cadp-3, 0x1.30167aabe7d6cp-3,
+    0x1.2be0a8504cf32p-3, 0x1.27b2a7260993ep-3, 0x1.238c67bbbe876p-3,
+    0x1.1f6ddaf3dca63p-3, 0x1.1b56f2031d665p-3, 0x1.17479e6f0ae77p-3,
+    0x1.133fd20c9712ep-3, 0x1.0f3f7efec171fp-3, 0x1.0b4697b54b62fp-3,
+    0x1.07550eeb7a5bfp-3, 0x1.036ad7a6e7f04p-3, 0x1.ff0fca6cbea8bp-4,
+    0x1.f758566190412p-4, 0x1.efaf3ae83c339p-4, 0x1.e8146048eb9c9p-4,
+    0x1.e087af561baf8p-4, 0x1.d909116ad9396p-4, 0x1.d198706914dd5p-4,
+    0x1.ca35b6b80fd56p-4, 0x1.c2e0cf42e10adp-4, 0x1.bb99a5771268cp-4,
+    0x1.b460254356546p-4, 0x1.ad343b1655464p-4, 0x1.a615d3dd938b6p-4,
+    0x1.9f04dd046f428p-4, 0x1.9801447336b70p-4, 0x1.910af88e574bap-4,
+    0x1.8a21e835a533dp-4, 0x1.834602c3bc4bbp-4, 0x1.7c77380d7a6f5p-4,
+    0x1.75b5786193c21p-4, 0x1.6f00b488416b8p-4, 0x1.6858ddc30b621p-4,
+    0x1.61bde5ccadef8p-4, 0x1.5b2fbed91bb40p-4, 0x1.54ae5b959d037p-4,
+    0x1.4e39af290d929p-4, 0x1.47d1ad343985cp-4, 0x1.417649d25b10fp-4,
+    0x1.3b277999b9f9fp-4, 0x1.34e5319c6e718p-4, 0x1.2eaf676948dd1p-4,
+    0x1.2886110ce0571p-4, 0x1.22692512c9d8dp-4, 0x1.1c589a86fa342p-4,
+    0x1.165468f755395p-4, 0x1.105c88756ca53p-4, 0x1.0a70f19871b3fp-4,
+    0x1.04919d7f5c81ap-4, 0x1.fd7d0ba69967cp-5, 0x1.f1ef49944e838p-5,
+    0x1.e679ea52eb2e7p-5, 0x1.db1ce49315810p-5, 0x1.cfd83031e7949p-5,
+    0x1.c4abc640721e8p-5, 0x1.b997a10bed984p-5, 0x1.ae9bbc26a8083p-5,
+    0x1.a3b81471bf138p-5, 0x1.98eca827b7c4dp-5, 0x1.8e3976e80776ep-5,
+    0x1.839e81c3a396dp-5, 0x1.791bcb4ab08a0p-5, 0x1.6eb1579b6af53p-5,
+    0x1.645f2c726a043p-5, 0x1.5a25513c5d2cdp-5, 0x1.5003cf296c5eep-5,
+    0x1.45fab14266b1bp-5, 0x1.3c0a047ff1901p-5, 0x1.3231d7e3f14b1p-5,
+    0x1.28723c956c00fp-5, 0x1.1ecb45ff312d7p-5, 0x1.153d09f19b3a5p-5,
+    0x1.0bc7a0c7cd654p-5, 0x1.026b2590dfaf0p-5, 0x1.f24f6c7af9895p-6,
+    0x1.dffae7a51746dp-6, 0x1.cdd9054331b0fp-6, 0x1.bbea150fa5871p-6,
+    0x1.aa2e6e6924e9cp-6, 0x1.98a670f132a49p-6, 0x1.8752853ec9968p-6,
+    0x1.76331da87fc96p-6, 0x1.6548b72a24077p-6, 0x1.5493da6ab0250p-6,
+    0x1.44151ce87f0bdp-6, 0x1.33cd225315d82p-6, 0x1.23bc9e1b93a30p-6,
+    0x1.13e4554725f5dp-6, 0x1.04452091e02eep-6, 0x1.e9bfdde89c7cep-7,
+    0x1.cb6b9146e275ap-7, 0x1.ad8fa5542c92dp-7, 0x1.902ea688fa7bbp-7,
+    0x1.734b6e6aa74f7p-7, 0x1.56e930be416ccp-7, 0x1.3b0b8c1516f63p-7,
+    0x1.1fb69edb37672p-7, 0x1.04ef2295fd7fbp-7, 0x1.d5751fa745dcdp-8,
+    0x1.a23e9d497483bp-8, 0x1.7049f37ec3627p-8, 0x1.3fa97cee32301p-8,
+    0x1.1073d69574045p-8, 0x1.c58b381cd4b11p-9, 0x1.6d888f3a1fefep-9,
+    0x1.1946ba8e1a326p-9, 0x1.92bb5540c3e26p-10, 0x1.fb20af78dfcb7p-11,
+    0x1.dc31c329f0b48p-12
+};
+
+} // namespace detail
+
+/**
+ * @brief Maps a word to a double in [0, 1), or a float if T is float, by exact bit construction.
+ *
+ * The 52 high bits of the word (23 for a float) become the mantissa of a number in [1, 2), and
+ * 1 is subtracted, which is exact.
+ */
+template <typename T = double>
+T to_uniform(uint64_t word) noexcept
+{
+    static_assert(std::is_same_v<T, double> || std::is_same_v<T, float>, "T must be float or double");
+
+    if constexpr (std::is_same_v<T, double>) {
+        return detail::from_bits(0x3FF0000000000000ull | (word >> 12)) - 1.0;
+    } else {
+        const uint32_t bits = 0x3F800000u | static_cast<uint32_t>(word >> 41);
+        float x;
+        std::memcpy(&x, &bits, sizeof x);
+        return x - 1.0f;
+    }
+}
+
+/**
+ * @brief Maps a word to a value in [min, max) as `min + (max - min) * u`.
+ *
+ * The product and the sum are each rounded once. As with any such formula, rounding can give
+ * exactly `max` when the range is much larger than `min`.
+ */
+template <typename T>
+T to_uniform(uint64_t word, T min, T max) noexcept
+{
+    static_assert(std::is_same_v<T, double> || std::is_same_v<T, float>, "T must be float or double");
+
+    const double product = detail::mul(static_cast<double>(max) - static_cast<double>(min), to_uniform<double>(word));
+    return static_cast<T>(static_cast<double>(min) + product);
+}
+
+/**
+ * @brief Maps a word to an integer in [min, max] with integer arithmetic only, without bias.
+ *
+ * Lemire's multiply-shift reduction; the rare rejected words are replaced by words of the
+ * SplitMix64 sequence seeded with the word.
+ */
+template <typename T>
+T to_uniform_int(uint64_t word, T min, T max) noexcept
+{
+    static_assert(std::is_integral_v<T> && sizeof(T) <= 8, "T must be an integral type of at most 64 bits");
+
+    using U = std::make_unsigned_t<T>;
+    const uint64_t range = static_cast<uint64_t>(static_cast<U>(static_cast<U>(max) - static_cast<U>(min))) + 1;
+    // A range of zero is the whole 64-bit range
+    if (range == 0) return static_cast<T>(word);
+
+    uint64_t lo = 0;
+    uint64_t hi = mul128(word, range, lo);
+    if (lo < range) {
+        const uint64_t threshold = (0 - range) % range;
+        const uint64_t seed = detail::extra_seed(word);
+        for (uint64_t c = 0; lo < threshold; ++c) {
+            hi = mul128(splitmix64_at(seed, c), range, lo);
+        }
+    }
+    return static_cast<T>(static_cast<U>(min) + static_cast<U>(hi));
+}
+
+/**
+ * @brief Maps a word to a standard normal value with the ziggurat method.
+ *
+ * Bits 0-7 of the word select the layer, bit 8 the sign and bits 12-63 the 52-bit magnitude.
+ * About 98.5% of the words are accepted by one integer comparison and give the value with a
+ * single multiplication; the others go through the wedge or tail tests of the layer, with
+ * `detail::exp()` and `detail::log()` and the extra words of the SplitMix64 sequence seeded
+ * with the word.
+ */
+inline double to_normal(uint64_t word) noexcept
+{
+    using namespace detail;
+    uint64_t w = word;
+    uint64_t seed = 0, c = 0;
+
+    for (;;) {
+        const size_t i = w & 0xFF;
+        const uint64_t j = w >> 12;
+        const uint64_t sign = (w & 0x100) << 55;
+        const double x = from_u52(j) * NORMAL_W[i];
+        if (j < NORMAL_K[i]) {
+            return from_bits(to_bits(x) | sign);
+        }
+
+        if (c == 0) seed = extra_seed(word);
+        if (i == 0) {
+            // Tail beyond R (Marsaglia): R + a with a of density exp(-R a) exp(-a^2 / 2)
+            double a, b;
+            do {
+                a = -log(unit_open(splitmix64_at(seed, c++))) / NORMAL_R;
+                b = -log(unit_open(splitmix64_at(seed, c++)));
+            } while (b + b < a * a);
+            return from_bits(to_bits(NORMAL_R + a) | sign);
+        }
+
+        // Wedge between the layer and the one above it
+        const double u = to_uniform<double>(splitmix64_at(seed, c++));
+        if (NORMAL_F[i] + mul(u, NORMAL_F[i - 1] - NORMAL_F[i]) < exp(-0.5 * x * x)) {
+            return from_bits(to_bits(x) | sign);
+        }
+        w = splitmix64_at(seed, c++);
+    }
+}
+
+/**
+ * @brief Maps a word to a standard exponential value with the ziggurat method.
+ *
+ * Bits 0-7 of the word select the layer and bits 12-63 the 52-bit magnitude; about 97.8% of the
+ * words are accepted by one integer comparison.
+ */
+inline double to_exponential(uint64_t word) noexcept
+{
+    using namespace detail;
+    uint64_t w = word;
+    uint64_t seed = 0, c = 0;
+
+    for (;;) {
+        const size_t i = w & 0xFF;
+        const uint64_t j = w >> 12;
+        const double x = from_u52(j) * EXPONENTIAL_W[i];
+        if (j < EXPONENTIAL_K[i]) {
+            return x;
+        }
+
+        if (c == 0) seed = extra_seed(word);
+        if (i == 0) {
+            // The exponential distribution is memoryless: the tail is R plus an exponential value
+            return EXPONENTIAL_R - log(unit_open(splitmix64_at(seed, c++)));
+        }
+
+        const double u = to_uniform<double>(splitmix64_at(seed, c++));
+        if (EXPONENTIAL_F[i] + mul(u, EXPONENTIAL_F[i - 1] - EXPONENTIAL_F[i]) < exp(-x)) {
+            return x;
+        }
+        w = splitmix64_at(seed, c++);
+    }
+}
+
+/**
+ * @brief Generates a reproducible uniform value in [0, 1) from one engine word.
+ */
+template <typename T = double, typename Engine>
+T uniform(Engine& e) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+    return to_uniform<T>(e.next());
+}
+
+/**
+ * @brief Generates a reproducible uniform value in [min, max) from one engine word.
+ */
+template <typename T, typename Engine>
+T uniform(Engine& e, T min, T max) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+    return to_uniform(e.next(), min, max);
+}
+
+/**
+ * @brief Generates a reproducible integer in [min, max] from one engine word.
+ */
+template <typename T, typename Engine>
+T uniform_int(Engine& e, T min, T max) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+    return to_uniform_int(e.next(), min, max);
+}
+
+/**
+ * @brief Generates a reproducible normal value, `mean + stddev * z`, from one engine word.
+ */
+template <typename T = double, typename Engine>
+T normal(Engine& e, T mean = T(0), T stddev = T(1)) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+    static_assert(std::is_floating_point_v<T>, "T must be a floating point");
+
+    const double product = detail::mul(static_cast<double>(stddev), to_normal(e.next()));
+    return static_cast<T>(static_cast<double>(mean) + product);
+}
+
+/**
+ * @brief Generates a reproducible exponential value, `z / rate`, from one engine word.
+ */
+template <typename T = double, typename Engine>
+T exponential(Engine& e, T rate = T(1)) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+    static_assert(std::is_floating_point_v<T>, "T must be a floating point");
+
+    return static_cast<T>(to_exponential(e.next()) / static_cast<double>(rate));
+}
+
+/**
+ * @brief Fills a buffer with the values of `count` calls to `uniform<T>(e)`.
+ *
+ * The conversion loop only uses integer operations and one subtraction, and is vectorized.
+ */
+template <typename T, typename Engine>
+void fill_uniform(Engine& e, T* out, size_t count) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+    static_assert(std::is_same_v<T, double> || std::is_same_v<T, float>, "T must be float or double");
+
+    constexpr size_t TILE = detail::TILE_WORDS;
+    uint64_t tile[TILE];
+
+    for (size_t i = 0; i < count; i += TILE) {
+        const size_t n = std::min(count - i, TILE);
+        fill(e, tile, n);
+        for (size_t k = 0; k < n; ++k) {
+            out[i + k] = to_uniform<T>(tile[k]);
+        }
+    }
+}
+
+/**
+ * @brief Fills a buffer with the values of `count` calls to `uniform<T>(e, min, max)`.
+ *
+ * The products and the sums are computed in two vectorized loops, so they cannot be fused.
+ */
+template <typename T, typename Engine>
+void fill_uniform(Engine& e, T* out, size_t count, T min, T max) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+    static_assert(std::is_same_v<T, double> || std::is_same_v<T, float>, "T must be float or double");
+
+    constexpr size_t TILE = detail::TILE_WORDS;
+    uint64_t tile[TILE];
+    double value[TILE];
+    const double width = static_cast<double>(max) - static_cast<double>(min);
+
+    for (size_t i = 0; i < count; i += TILE) {
+        const size_t n = std::min(count - i, TILE);
+        fill(e, tile, n);
+        for (size_t k = 0; k < n; ++k) {
+            value[k] = width * to_uniform<double>(tile[k]);
+        }
+        detail::memory_barrier(value);
+        for (size_t k = 0; k < n; ++k) {
+            out[i + k] = static_cast<T>(static_cast<double>(min) + value[k]);
+        }
+    }
+}
+
+/**
+ * @brief Fills a buffer with the values of `count` calls to `normal<T>(e, mean, stddev)`.
+ *
+ * The fast path of the ziggurat (table lookups, an integer comparison and a multiplication) runs
+ * over the whole tile in a loop without branches that the compiler vectorizes with gathers, and
+ * flags the rejected words, which are then recomputed by `to_normal()`. The output is therefore
+ * exactly that of the scalar function.
+ */
+template <typename T, typename Engine>
+void fill_normal(Engine& e, T* out, size_t count, T mean = T(0), T stddev = T(1)) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+    static_assert(std::is_floating_point_v<T>, "T must be a floating point");
+
+    constexpr size_t TILE = detail::TILE_WORDS;
+    uint64_t tile[TILE];
+    double value[TILE];
+    uint64_t rejected[TILE];
+    const double scale = static_cast<double>(stddev);
+    const double offset = static_cast<double>(mean);
+
+    for (size_t i = 0; i < count; i += TILE) {
+        const size_t n = std::min(count - i, TILE);
+        fill(e, tile, n);
+
+        for (size_t k = 0; k < n; ++k) {
+            const uint64_t w = tile[k];
+            const uint64_t j = w >> 12;
+            const double x = detail::from_u52(j) * detail::NORMAL_W[w & 0xFF];
+            value[k] = scale * detail::from_bits(detail::to_bits(x) | ((w & 0x100) << 55));
+            rejected[k] = j >= detail::NORMAL_K[w & 0xFF];
+        }
+        for (size_t k = 0; k < n; ++k) {
+            if (rejected[k]) value[k] = scale * to_normal(tile[k]);
+        }
+
+        detail::memory_barrier(value);
+        for (size_t k = 0; k < n; ++k) {
+            out[i + k] = static_cast<T>(offset + value[k]);
+        }
+    }
+}
+
+/**
+ * @brief Fills a buffer with the values of `count` calls to `exponential<T>(e, rate)`.
+ *
+ * Same structure as `fill_normal()`: a vectorized fast path over the tile, then the rejected
+ * words through `to_exponential()`.
+ */
+template <typename T, typename Engine>
+void fill_exponential(Engine& e, T* out, size_t count, T rate = T(1)) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+    static_assert(std::is_floating_point_v<T>, "T must be a floating point");
+
+    constexpr size_t TILE = detail::TILE_WORDS;
+    uint64_t tile[TILE];
+    double value[TILE];
+    uint64_t rejected[TILE];
+    const double divisor = static_cast<double>(rate);
+
+    for (size_t i = 0; i < count; i += TILE) {
+        const size_t n = std::min(count - i, TILE);
+        fill(e, tile, n);
+
+        for (size_t k = 0; k < n; ++k) {
+            const uint64_t w = tile[k];
+            const uint64_t j = w >> 12;
+            value[k] = detail::from_u52(j) * detail::EXPONENTIAL_W[w & 0xFF];
+            rejected[k] = j >= detail::EXPONENTIAL_K[w & 0xFF];
+        }
+        for (size_t k = 0; k < n; ++k) {
+            if (rejected[k]) value[k] = to_exponential(tile[k]);
+        }
+
+        for (size_t k = 0; k < n; ++k) {
+            out[i + k] = static_cast<T>(value[k] / divisor);
+        }
+    }
+}
+
+/**
+ * @brief Fills a buffer with the values of `count` calls to `uniform_int<T>(e, min, max)`.
+ */
+template <typename T, typename Engine>
+void fill_uniform_int(Engine& e, T* out, size_t count, T min, T max) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+    constexpr size_t TILE = detail::TILE_WORDS;
+    uint64_t tile[TILE];
+
+    for (size_t i = 0; i < count; i += TILE) {
+        const size_t n = std::min(count - i, TILE);
+        fill(e, tile, n);
+        for (size_t k = 0; k < n; ++k) {
+            out[i + k] = to_uniform_int(tile[k], min, max);
+        }
+    }
+}
+
+} // namespace bpr::repro
+
+#endif // BPR_REPRODUCIBLE_HPP
@@ -0,0 +1,319 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_RESAMPLING_HPP
+#define BPR_RESAMPLING_HPP
+
+#include "distributions.hpp"
+#include "generator.hpp"
+#include "parallel.hpp"
+#include "engine.hpp"
+#include "utils.hpp"
+#include "prng.hpp"
+
+#include <type_traits>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <cmath>
+
+namespace bpr {
+
+/**
+ * Resampling of weighted particle sets, as used by particle filters and sequential Monte Carlo.
+ *
+ * Every function draws `m` ancestor indices from `n` particles with non-negative weights (they do
+ * not need to be normalized, but their sum must be positive), so that particle `i` is selected
+ * `weights[i] / sum(weights) * m` times in expectation. Systematic and stratified resampling
+ * return the ancestors in increasing order. Residual resampling returns the deterministic copies
+ * in increasing order, followed by the remainder drawn from the residual weights, also in
+ * increasing order. Metropolis resampling returns them in no particular order.
+ */
+
+namespace detail {
+
+/**
+ * @brief Scatter step of `expand_counts()` for particles `first .. first + count - 1`.
+ *
+ * `cumulative[k]` is the cumulative count of particle `first + k`, and `start` the cumulative
+ * count of the particle before `first` on entry, of the last particle on return. Tiles of counts
+ * can be scattered one after the other, so the counts never need to be stored whole.
+ */
+template <typename Index>
+inline void scatter_counts(const size_t* cumulative, size_t first, size_t count, size_t& start, Index* ancestors, size_t m) noexcept
+{
+    for (size_t k = 0; k < count; ++k) {
+        if (start < m) ancestors[start] = static_cast<Index>(first + k);
+        start = cumulative[k];
+    }
+}
+
+/**
+ * @brief Fills the positions left between the scattered indices with a running maximum.
+ */
+template <typename Index>
+inline void fill_running_max(Index* ancestors, size_t m) noexcept
+{
+    Index current = 0;
+    for (size_t j = 0; j < m; ++j) {
+        current = std::max(current, ancestors[j]);
+        ancestors[j] = current;
+    }
+}
+
+/**
+ * @brief Writes `ancestors[k[i-1]] .. ancestors[k[i] - 1] = i` from the cumulative counts `k`.
+ *
+ * Each selected particle writes its index at the first of its positions, and a running maximum
+ * then fills the other positions, so no branch depends on the number of copies.
+ */
+template <typename Index>
+inline void expand_counts(const size_t* cumulative, size_t n, Index* ancestors) noexcept
+{
+    const size_t m = n ? cumulative[n - 1] : 0;
+    std::fill(ancestors, ancestors + m, static_cast<Index>(0));
+
+    size_t start = 0;
+    scatter_counts(cumulative, 0, n, start, ancestors, m);
+    fill_running_max(ancestors, m);
+}
+
+} // namespace detail
+
+/**
+ * @brief Systematic resampling: one uniform `u` in [0, 1), and the m points `(j + u) / m` of the cumulative weights.
+ *
+ * With prefix sums `C`, the number of points below `C[i]` is `ceil(C[i] * m / total - u)`, so the
+ * counts of all particles are computed without any search or branch, in loops that the compiler
+ * vectorizes, and the ancestors are written by a scatter and a running maximum. This is the usual
+ * default for particle filters: it has the lowest variance of the schemes here and costs a single
+ * random word.
+ *
+ * @param e The random engine.
+ * @param weights The weights of the particles.
+ * @param n The number of particles.
+ * @param ancestors Receives the m indices of the selected particles.
+ * @param m The number of particles to draw.
+ */
+template <typename Engine, typename Weight, typename Index>
+void systematic_resample(Engine& e, const Weight* weights, size_t n, Index* ancestors, size_t m)
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+    static_assert(std::is_integral_v<Index>, "Index must be an integral type");
+    if (n == 0 || m == 0) return;
+
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        total += static_cast<double>(weights[i]);
+    }
+
+    const double u = detail::unit_closed_open<double>(e.next());
+    const double scale = static_cast<double>(m) / total;
+    const double limit = static_cast<double>(m);
+
+    // The counts of each tile are scattered before the next tile is computed, so nothing is
+    // allocated whatever the number of particles
+    std::fill(ancestors, ancestors + m, static_cast<Index>(0));
+
+    constexpr size_t TILE = detail::DISTRIBUTION_TILE_WORDS;
+    double prefix[TILE];
+    size_t cumulative[TILE];
+    double running = 0.0;
+    size_t start = 0;
+
+    for (size_t first = 0; first < n; first += TILE) {
+        const size_t count = std::min(n - first, TILE);
+        for (size_t k = 0; k < count; ++k) {
+            running += static_cast<double>(weights[first + k]);
+            prefix[k] = running;
+        }
+        for (size_t k = 0; k < count; ++k) {
+            cumulative[k] = static_cast<size_t>(std::min(limit, std::max(0.0, std::ceil(prefix[k] * scale - u))));
+        }
+        detail::scatter_counts(cumulative, first, count, start, ancestors, m);
+    }
+
+    detail::fill_running_max(ancestors, m);
+}
+
+/**
+ * @brief Stratified resampling: point `j` is `(j + u_j) / m` of the cumulative weights, with one uniform per stratum.
+ *
+ * The uniforms are generated in tiles through the bulk path of the engine, and the sorted points
+ * are merged with the prefix sums in a single linear scan.
+ */
+template <typename Engine, typename Weight, typename Index>
+void stratified_resample(Engine& e, const Weight* weights, size_t n, Index* ancestors, size_t m)
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+    static_assert(std::is_integral_v<Index>, "Index must be an integral type");
+    if (n == 0 || m == 0) return;
+
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        total += static_cast<double>(weights[i]);
+    }
+
+    constexpr size_t TILE = detail::DISTRIBUTION_TILE_WORDS;
+    uint64_t tile[TILE];
+    const double step = total / static_cast<double>(m);
+
+    size_t i = 0;
+    double cumulative = static_cast<double>(weights[0]);
+    for (size_t j = 0; j < m; j += TILE) {
+        const size_t count = std::min(m - j, TILE);
+        fill(e, tile, count);
+        for (size_t k = 0; k < count; ++k) {
+            const double point = (static_cast<double>(j + k) + detail::unit_closed_open<double>(tile[k])) * step;
+            while (cumulative <= point && i + 1 < n) {
+                cumulative += static_cast<double>(weights[++i]);
+            }
+            ancestors[j + k] = static_cast<Index>(i);
+        }
+    }
+}
+
+/**
+ * @brief Residual resampling: `floor(m * w_i)` deterministic copies, and the remainder drawn multinomially from the residual weights.
+ *
+ * The remaining R draws use R sorted uniforms, generated in O(R) as normalized cumulative sums of
+ * exponential variables, merged with the prefix sums of the residual weights in one linear scan,
+ * instead of R binary searches.
+ */
+template <typename Engine, typename Weight, typename Index>
+void residual_resample(Engine& e, const Weight* weights, size_t n, Index* ancestors, size_t m)
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+    static_assert(std::is_integral_v<Index>, "Index must be an integral type");
+    if (n == 0 || m == 0) return;
+
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        total += static_cast<double>(weights[i]);
+    }
+
+    // Deterministic copies, and residual weights in [0, 1)
+    const double scale = static_cast<double>(m) / total;
+    std::vector<double> residual(n);
+    std::vector<size_t> cumulative(n);
+    size_t copies = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const double expected = static_cast<double>(weights[i]) * scale;
+        const double whole = std::floor(expected);
+        residual[i] = expected - whole;
+        copies += static_cast<size_t>(whole);
+        cumulative[i] = copies;
+    }
+
+    // Rounding errors can only make the copies overshoot by a few units
+    copies = std::min(copies, m);
+    for (size_t i = 0; i < n; ++i) {
+        cumulative[i] = std::min(cumulative[i], m);
+    }
+    detail::expand_counts(cumulative.data(), n, ancestors);
+
+    const size_t remainder = m - copies;
+    if (remainder == 0) return;
+
+    // Sorted uniforms: S_k / S_(R+1), with S the cumulative sums of R + 1 exponential variables
+    std::vector<double> points(remainder + 1);
+    fill_exponential(e, points.data(), remainder + 1);
+    for (size_t k = 1; k <= remainder; ++k) {
+        points[k] += points[k - 1];
+    }
+
+    double residual_total = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        residual_total += residual[i];
+    }
+
+    const double to_residual = residual_total / points[remainder];
+    size_t i = 0;
+    double prefix = residual[0];
+    for (size_t k = 0; k < remainder; ++k) {
+        const double point = points[k] * to_residual;
+        while (prefix <= point && i + 1 < n) {
+            prefix += residual[++i];
+        }
+        ancestors[copies + k] = static_cast<Index>(i);
+    }
+}
+
+/**
+ * @brief Metropolis resampling (Murray, Lee and Jacob): no prefix sum, no collective operation, parallel over the ancestors.
+ *
+ * Each ancestor runs its own Metropolis chain over the particle indices, started at its own index
+ * modulo n: `iterations` times, a particle `l` is proposed uniformly and accepted with probability
+ * `min(1, w_l / w_k)`. One 64-bit word gives both the proposal (high half of the product with n)
+ * and the acceptance test (low half). Blocks of ancestors advance in lockstep, one iteration for
+ * the whole block at a time, so the weight loads of independent chains overlap. Block `b` draws
+ * from `stream_seed(seed, b)`, so the result does not depend on the number of threads.
+ *
+ * The result is biased when `iterations` is too small: the chains need about
+ * `log(epsilon) / log(1 - mean(w) / max(w))` iterations to reach a bias of epsilon.
+ */
+template <typename Engine = prng::Xoshiro256ss, typename Weight, typename Index>
+void metropolis_resample(uint64_t seed, const Weight* weights, size_t n, Index* ancestors, size_t m,
+                         size_t iterations, unsigned thread_count = 0)
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+    static_assert(std::is_integral_v<Index>, "Index must be an integral type");
+    if (n == 0 || m == 0) return;
+
+    constexpr size_t BLOCK = detail::DISTRIBUTION_TILE_WORDS;
+    constexpr double two_32 = 4294967296.0;
+    const size_t blocks = (m + BLOCK - 1) / BLOCK;
+
+    parallel_for(blocks, [&](size_t block, unsigned) {
+        Engine e(stream_seed(seed, block));
+        const size_t first = block * BLOCK;
+        const size_t count = std::min(BLOCK, m - first);
+
+        uint64_t tile[BLOCK];
+        size_t current[BLOCK];
+        for (size_t k = 0; k < count; ++k) {
+            current[k] = (first + k) % n;
+        }
+
+        for (size_t it = 0; it < iterations; ++it) {
+            fill(e, tile, count);
+            for (size_t k = 0; k < count; ++k) {
+                uint64_t lo;
+                const size_t proposal = static_cast<size_t>(mul128(tile[k], n, lo));
+                // Accept when u * w_k < w_l, u uniform in [0, 1) from the low half
+                const double u = static_cast<double>(lo >> 32);
+                const bool accept = u * static_cast<double>(weights[current[k]]) < static_cast<double>(weights[proposal]) * two_32;
+                current[k] = accept ? proposal : current[k];
+            }
+        }
+
+        for (size_t k = 0; k < count; ++k) {
+            ancestors[first + k] = static_cast<Index>(current[k]);
+        }
+    }, thread_count);
+}
+
+} // namespace bpr
+
+#endif // BPR_RESAMPLING_HPP
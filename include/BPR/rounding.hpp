@@ -0,0 +1,323 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_ROUNDING_HPP
+#define BPR_ROUNDING_HPP
+
+#include "generator.hpp"
+#include "parallel.hpp"
+#include "engine.hpp"
+#include "utils.hpp"
+#include "prng.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cmath>
+
+namespace bpr {
+
+namespace detail {
+
+/**
+ * @brief Number of 64-bit words of random bits generated per tile by the rounding kernels.
+ *
+ * A tile rounds 1024 elements with 16 random bits each, or 2048 elements with 8 bits each.
+ */
+inline constexpr size_t ROUNDING_TILE_WORDS = 256;
+
+inline uint32_t float_bits(float x) noexcept
+{
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+inline float bits_float(uint32_t bits) noexcept
+{
+    float x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+/**
+ * @brief Stochastically rounds the fp32 value of `bits` to a small float format, returning its encoding.
+ *
+ * The 24-bit significand is shifted right by the number of bits the target cannot hold (more for
+ * subnormal targets) after adding a random offset below the dropped part, so the value is rounded
+ * up with probability equal to the dropped fraction. Only the R random bits available are used,
+ * left-aligned under the dropped part: the expected result is within 2^-R ulp of the input, and
+ * inputs below 2^-R of the smallest subnormal flush to zero. Because the exponent field follows
+ * the mantissa, a carry out of the mantissa correctly increments the exponent, and a subnormal
+ * rounded up to the smallest normal gets the right encoding.
+ *
+ * @tparam M Mantissa bits of the target.
+ * @tparam E Exponent bits of the target.
+ * @tparam HasInf Whether the all-ones exponent encodes infinities (fp16, e5m2) or finite values (e4m3).
+ * @tparam R Number of random bits in `random`.
+ */
+template <int M, int E, bool HasInf, int R>
+inline uint32_t round_minifloat(uint32_t bits, uint32_t random) noexcept
+{
+    constexpr int BIAS = (1 << (E - 1)) - 1;
+    constexpr int EMIN = 1 - BIAS;
+    constexpr int EMAX = HasInf ? BIAS : BIAS + 1;
+    // Largest finite encoding (without sign), and the NaN encoding
+    constexpr uint32_t MAX_FINITE = HasInf ? ((((1u << E) - 2) << M) | ((1u << M) - 1)) : ((1u << (E + M)) - 2);
+    constexpr uint32_t INF = HasInf ? (((1u << E) - 1) << M) : MAX_FINITE;
+    constexpr uint32_t NAN_BITS = HasInf ? (INF | (1u << (M - 1))) : ((1u << (E + M)) - 1);
+
+    const uint32_t sign = (bits >> 31) << (E + M);
+    const int exponent = static_cast<int>((bits >> 23) & 0xFF) - 127;
+    const uint64_t significand = (bits & 0x7FFFFF) | (exponent > -127 ? 0x800000u : 0u);
+
+    // Bits dropped from the significand: more for subnormal targets, all of them for tiny values
+    const int shift = std::min(23 - M + std::max(0, EMIN - exponent), 40);
+    const uint64_t offset = shift >= R ? static_cast<uint64_t>(random) << (shift - R) : static_cast<uint64_t>(random) >> (R - shift);
+    const uint32_t rounded = static_cast<uint32_t>((significand + offset) >> shift);
+
+    uint32_t encoded;
+    if (exponent >= EMIN) {
+        // Normal: the implicit bit of `rounded` becomes part of the biased exponent
+        encoded = (static_cast<uint32_t>(exponent + BIAS) << M) + rounded - (1u << M);
+    } else {
+        // Subnormal: `rounded` is the encoding, 1 << M being the smallest normal
+        encoded = rounded;
+    }
+
+    if (exponent > EMAX || encoded > MAX_FINITE) encoded = INF;
+    if (exponent == 128) encoded = (bits & 0x7FFFFF) ? NAN_BITS : INF;
+    return sign | encoded;
+}
+
+} // namespace detail
+
+/**
+ * @brief Storage type of bfloat16 values: the 16 high bits of an fp32 value.
+ *
+ * Arrays of `bfloat16` have the layout of the `uint16_t` arrays written by `stochastic_round_bf16()`.
+ */
+struct bfloat16
+{
+    uint16_t bits;
+};
+
+/**
+ * @brief Rounds an fp32 value to the nearest bfloat16 (ties to even).
+ */
+inline bfloat16 to_bfloat16(float x) noexcept
+{
+    const uint32_t bits = detail::float_bits(x);
+    if ((bits & 0x7FFFFFFF) > 0x7F800000) {
+        return { static_cast<uint16_t>((bits >> 16) | 0x0040) };
+    }
+    return { static_cast<uint16_t>((bits + 0x7FFF + ((bits >> 16) & 1)) >> 16) };
+}
+
+/**
+ * @brief Converts a bfloat16 value to fp32, exactly.
+ */
+inline float to_float(bfloat16 x) noexcept
+{
+    return detail::bits_float(static_cast<uint32_t>(x.bits) << 16);
+}
+
+/**
+ * @brief Rounds fp32 values to bfloat16 stochastically.
+ *
+ * A value is rounded up with probability equal to the fraction dropped, so the rounding is
+ * unbiased: `E[round(x)] = x`. Each element uses 16 random bits (four per engine word), generated
+ * in tiles through the bulk path of the engine and added to the 16 bits that bfloat16 drops; the
+ * kernel is a few integer operations per element without branches, which compilers vectorize.
+ * NaNs are kept (as quiet NaNs), and values that round beyond the largest bfloat16 become infinite.
+ *
+ * @param e The random engine providing the rounding bits.
+ * @param in The fp32 values.
+ * @param out Receives the bfloat16 encodings.
+ * @param count The number of values.
+ */
+template <typename Engine>
+void stochastic_round_bf16(Engine& e, const float* in, uint16_t* out, size_t count) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+    constexpr size_t TILE = detail::ROUNDING_TILE_WORDS * 4;
+    uint64_t words[detail::ROUNDING_TILE_WORDS];
+    uint16_t random[TILE];
+
+    for (size_t i = 0; i < count; i += TILE) {
+        const size_t n = std::min(count - i, TILE);
+        fill(e, words, (n + 3) / 4);
+        std::memcpy(random, words, n * sizeof(uint16_t));
+
+        for (size_t k = 0; k < n; ++k) {
+            const uint32_t bits = detail::float_bits(in[i + k]);
+            const bool nan = (bits & 0x7FFFFFFF) > 0x7F800000;
+            const uint16_t rounded = static_cast<uint16_t>((bits + random[k]) >> 16);
+            out[i + k] = nan ? static_cast<uint16_t>((bits >> 16) | 0x0040) : rounded;
+        }
+    }
+}
+
+/**
+ * @brief Rounds fp32 values to IEEE half precision (fp16) stochastically, with 16 random bits per element.
+ *
+ * Subnormal results are rounded stochastically too; values that round beyond 65504 become infinite.
+ */
+template <typename Engine>
+void stochastic_round_fp16(Engine& e, const float* in, uint16_t* out, size_t count) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+    constexpr size_t TILE = detail::ROUNDING_TILE_WORDS * 4;
+    uint64_t words[detail::ROUNDING_TILE_WORDS];
+    uint16_t random[TILE];
+
+    for (size_t i = 0; i < count; i += TILE) {
+        const size_t n = std::min(count - i, TILE);
+        fill(e, words, (n + 3) / 4);
+        std::memcpy(random, words, n * sizeof(uint16_t));
+
+        for (size_t k = 0; k < n; ++k) {
+            out[i + k] = static_cast<uint16_t>(
+                detail::round_minifloat<10, 5, true, 16>(detail::float_bits(in[i + k]), random[k]));
+        }
+    }
+}
+
+/**
+ * @brief Rounds fp32 values to 8-bit E4M3 floats stochastically, with 8 random bits per element.
+ *
+ * E4M3 has no infinity: values that round beyond 448 saturate to +/-448 (the OCP "satfinite"
+ * behavior), NaNs map to the E4M3 NaN encoding.
+ */
+template <typename Engine>
+void stochastic_round_fp8_e4m3(Engine& e, const float* in, uint8_t* out, size_t count) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+    constexpr size_t TILE = detail::ROUNDING_TILE_WORDS * 8;
+    uint64_t words[detail::ROUNDING_TILE_WORDS];
+    uint8_t random[TILE];
+
+    for (size_t i = 0; i < count; i += TILE) {
+        const size_t n = std::min(count - i, TILE);
+        fill(e, words, (n + 7) / 8);
+        std::memcpy(random, words, n);
+
+        for (size_t k = 0; k < n; ++k) {
+            out[i + k] = static_cast<uint8_t>(
+                detail::round_minifloat<3, 4, false, 8>(detail::float_bits(in[i + k]), random[k]));
+        }
+    }
+}
+
+/**
+ * @brief Rounds fp32 values to 8-bit E5M2 floats stochastically, with 8 random bits per element.
+ *
+ * Values that round beyond 57344 become infinite.
+ */
+template <typename Engine>
+void stochastic_round_fp8_e5m2(Engine& e, const float* in, uint8_t* out, size_t count) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+    constexpr size_t TILE = detail::ROUNDING_TILE_WORDS * 8;
+    uint64_t words[detail::ROUNDING_TILE_WORDS];
+    uint8_t random[TILE];
+
+    for (size_t i = 0; i < count; i += TILE) {
+        const size_t n = std::min(count - i, TILE);
+        fill(e, words, (n + 7) / 8);
+        std::memcpy(random, words, n);
+
+        for (size_t k = 0; k < n; ++k) {
+            out[i + k] = static_cast<uint8_t>(
+                detail::round_minifloat<2, 5, true, 8>(detail::float_bits(in[i + k]), random[k]));
+        }
+    }
+}
+
+/**
+ * @brief Quantizes fp32 values to int8 with stochastic rounding: `q = clamp(floor(x / scale + u), -128, 127)`.
+ *
+ * `u` is uniform in [0, 1) with a resolution of 2^-16 (16 random bits per element), so the
+ * expected value of `q * scale` is `x` within the representable range.
+ *
+ * @param scale The quantization step.
+ */
+template <typename Engine>
+void stochastic_quantize_int8(Engine& e, const float* in, int8_t* out, size_t count, float scale) noexcept
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+    constexpr size_t TILE = detail::ROUNDING_TILE_WORDS * 4;
+    constexpr float inv_2_16 = 1.0f / 65536.0f;
+    uint64_t words[detail::ROUNDING_TILE_WORDS];
+    uint16_t random[TILE];
+    const float inv_scale = 1.0f / scale;
+
+    for (size_t i = 0; i < count; i += TILE) {
+        const size_t n = std::min(count - i, TILE);
+        fill(e, words, (n + 3) / 4);
+        std::memcpy(random, words, n * sizeof(uint16_t));
+
+        for (size_t k = 0; k < n; ++k) {
+            const float v = std::floor(in[i + k] * inv_scale + static_cast<float>(random[k]) * inv_2_16);
+            out[i + k] = static_cast<int8_t>(std::min(127.0f, std::max(-128.0f, v)));
+        }
+    }
+}
+
+/**
+ * @brief Runs a rounding kernel over [0, count) in parallel, with reproducible random bits.
+ *
+ * The range is split into chunks of `chunk_size` elements; chunk `c` is processed by
+ * `kernel(engine, begin, end)` with an engine seeded with `stream_seed(seed, c)`, so the output
+ * does not depend on the number of threads. This is how arrays of billions of elements are
+ * converted at memory bandwidth.
+ *
+ * @example
+ * ```cpp
+ * bpr::parallel_stochastic_round(seed, n, [&](auto& e, size_t begin, size_t end) {
+ *     bpr::stochastic_round_bf16(e, in + begin, out + begin, end - begin);
+ * });
+ * ```
+ */
+template <typename Engine = prng::Xoshiro256ss, typename Kernel>
+void parallel_stochastic_round(uint64_t seed, size_t count, Kernel&& kernel,
+                               unsigned thread_count = 0, size_t chunk_size = size_t(1) << 20)
+{
+    const size_t chunks = (count + chunk_size - 1) / chunk_size;
+    parallel_for(chunks, [&](size_t chunk, unsigned) {
+        Engine e(stream_seed(seed, chunk));
+        const size_t begin = chunk * chunk_size;
+        kernel(e, begin, std::min(count, begin + chunk_size));
+    }, thread_count);
+}
+
+} // namespace bpr
+
+#endif // BPR_ROUNDING_HPP
@@ -0,0 +1,328 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_SAMPLING_HPP
+#define BPR_SAMPLING_HPP
+
+#include "distributions.hpp"
+#include "engine.hpp"
+#include "utils.hpp"
+
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace bpr {
+
+namespace detail {
+
+/**
+ * @brief One column of an alias table: the probability to keep the column, and the outcome returned otherwise.
+ *
+ * The threshold and the alias are stored side by side so that a sample touches a single cache line.
+ */
+template <typename Index>
+struct AliasEntry
+{
+    uint32_t threshold = UINT32_MAX;    ///< Probability to keep the column, scaled to 2^32
+    Index alias = 0;                    ///< Outcome returned otherwise
+};
+
+/**
+ * @brief Builds the alias table of `count` non-negative weights into `entries` (Vose's algorithm, O(count)).
+ *
+ * Aliases are indices in [0, count). If all weights are zero, the distribution is uniform. The
+ * scratch vectors are reused between calls by callers building many tables.
+ */
+template <typename Index, typename Weight>
+void build_alias(const Weight* weights, size_t count, AliasEntry<Index>* entries,
+                 std::vector<double>& scaled, std::vector<Index>& small, std::vector<Index>& large)
+{
+    constexpr uint32_t FULL = UINT32_MAX;
+
+    double total = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        total += static_cast<double>(weights[i]);
+    }
+
+    // Scaled probabilities, whose mean is 1
+    scaled.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        scaled[i] = total > 0.0 ? static_cast<double>(weights[i]) * count / total : 1.0;
+    }
+
+    // Vose's algorithm: pair each under-full column with an over-full one
+    small.clear();
+    large.clear();
+    for (size_t i = 0; i < count; ++i) {
+        (scaled[i] < 1.0 ? small : large).push_back(static_cast<Index>(i));
+    }
+
+    while (!small.empty() && !large.empty()) {
+        const Index s = small.back(); small.pop_back();
+        const Index l = large.back();
+        const double threshold = scaled[s] * 4294967296.0;
+        entries[s].threshold = threshold >= 4294967295.0 ? FULL : static_cast<uint32_t>(threshold);
+        entries[s].alias = l;
+        scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+        if (scaled[l] < 1.0) {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+
+    // Columns left over are full up to rounding errors
+    for (Index i : large) {
+        entries[i].threshold = FULL;
+        entries[i].alias = i;
+    }
+    for (Index i : small) {
+        entries[i].threshold = FULL;
+        entries[i].alias = i;
+    }
+}
+
+/**
+ * @brief Maps a uniform 64-bit word to an outcome of the alias table `entries` of `count` columns.
+ *
+ * The high half of the 128-bit product `word * count` selects a column uniformly (Lemire's
+ * reduction); the low half, which is uniformly distributed given the column, is compared with
+ * the threshold of the column to choose between the column and its alias.
+ */
+template <typename Index>
+inline size_t alias_sample(const AliasEntry<Index>* entries, size_t count, uint64_t word) noexcept
+{
+    uint64_t lo = 0;
+    const uint64_t column = mul128(word, count, lo);
+    const AliasEntry<Index>& entry = entries[column];
+    return static_cast<uint32_t>(lo >> 32) < entry.threshold ? column : entry.alias;
+}
+
+} // namespace detail
+
+/**
+ * @class AliasTable
+ * @brief Samples indices from a fixed discrete distribution in constant time (Walker/Vose alias method).
+ *
+ * The table is built once in O(n) from non-negative weights. Each sample then costs a single
+ * 64-bit engine output and a single memory access:
+ * - The high half of the 128-bit product `word * n` selects a column uniformly (Lemire's reduction).
+ * - The low half, which is uniformly distributed given the column, is compared with the 32-bit
+ *   acceptance threshold of the column to choose between the column and its alias.
+ *
+ * The acceptance threshold and the alias of a column are stored side by side so that a sample
+ * touches only one cache line.
+ *
+ * @tparam Index The unsigned integer type used to store indices. `uint32_t` keeps an entry at 8 bytes.
+ *
+ * @example
+ * ```cpp
+ * bpr::AliasTable<> table(std::vector<double>{ 0.5, 0.25, 0.25 });
+ * size_t index = table(engine);    // 0 with probability 1/2
+ * ```
+ */
+template <typename Index = uint32_t>
+class AliasTable
+{
+public:
+    static_assert(std::is_unsigned_v<Index>, "Index must be an unsigned integer");
+
+    AliasTable() = default;
+
+    /**
+     * @brief Builds the table from `count` non-negative weights (they do not need to be normalized).
+     *
+     * If all weights are zero, the distribution is uniform.
+     */
+    template <typename Weight>
+    AliasTable(const Weight* weights, size_t count)
+        : m_entries(count)
+    {
+        if (count == 0) return;
+
+        std::vector<double> scaled;
+        std::vector<Index> small, large;
+        small.reserve(count);
+        large.reserve(count);
+        detail::build_alias(weights, count, m_entries.data(), scaled, small, large);
+    }
+
+    /**
+     * @brief Builds the table from a vector of non-negative weights.
+     */
+    template <typename Weight>
+    explicit AliasTable(const std::vector<Weight>& weights)
+        : AliasTable(weights.data(), weights.size())
+    { }
+
+    /**
+     * @brief Draws an index in [0, size()) with probability proportional to its weight.
+     */
+    template <typename Engine>
+    size_t operator()(Engine& e) const noexcept {
+        return sample(e.next());
+    }
+
+    /**
+     * @brief Maps a uniform 64-bit word to an index, for callers that generate words in bulk.
+     */
+    size_t sample(uint64_t word) const noexcept {
+        return detail::alias_sample(m_entries.data(), m_entries.size(), word);
+    }
+
+    /**
+     * @brief Returns the number of outcomes of the distribution.
+     */
+    size_t size() const noexcept {
+        return m_entries.size();
+    }
+
+private:
+    std::vector<detail::AliasEntry<Index>> m_entries;
+};
+
+/**
+ * @class SumTree
+ * @brief Samples indices from a discrete distribution whose weights change between draws.
+ *
+ * The weights are the leaves of a complete binary tree in which every inner node holds the sum of
+ * its two children, stored as an implicit heap (children of node `k` at `2k` and `2k + 1`). Changing
+ * a weight and drawing an index both cost O(log n): a draw scales a uniform value by the total
+ * weight and descends from the root, going right when the value exceeds the sum on the left.
+ * Updates recompute each ancestor from its two children instead of adding a difference, so the
+ * sums never drift however many updates are made.
+ *
+ * @tparam Weight The floating-point type of the weights.
+ *
+ * @example
+ * ```cpp
+ * bpr::SumTree<> tree(std::vector<double>{ 1.0, 2.0, 1.0 });
+ * tree.set(2, 5.0);
+ * size_t index = tree(engine);     // 2 with probability 5/8
+ * ```
+ */
+template <typename Weight = double>
+class SumTree
+{
+public:
+    static_assert(std::is_floating_point_v<Weight>, "Weight must be a floating point");
+
+    SumTree() = default;
+
+    /**
+     * @brief Creates a tree of `count` outcomes whose weights are all zero.
+     */
+    explicit SumTree(size_t count)
+        : m_count(count)
+    {
+        while (m_leaves < count) m_leaves <<= 1;
+        m_nodes.assign(2 * m_leaves, Weight(0));
+    }
+
+    /**
+     * @brief Creates a tree from `count` non-negative weights, in O(count).
+     */
+    template <typename T>
+    SumTree(const T* weights, size_t count)
+        : SumTree(count)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            m_nodes[m_leaves + i] = static_cast<Weight>(weights[i]);
+        }
+        for (size_t k = m_leaves - 1; k > 0; --k) {
+            m_nodes[k] = m_nodes[2 * k] + m_nodes[2 * k + 1];
+        }
+    }
+
+    /**
+     * @brief Creates a tree from a vector of non-negative weights.
+     */
+    template <typename T>
+    explicit SumTree(const std::vector<T>& weights)
+        : SumTree(weights.data(), weights.size())
+    { }
+
+    /**
+     * @brief Sets the weight of outcome `index` to the non-negative value `weight`.
+     */
+    void set(size_t index, Weight weight) noexcept {
+        size_t k = m_leaves + index;
+        m_nodes[k] = weight;
+        for (k >>= 1; k > 0; k >>= 1) {
+            m_nodes[k] = m_nodes[2 * k] + m_nodes[2 * k + 1];
+        }
+    }
+
+    /**
+     * @brief Returns the weight of outcome `index`.
+     */
+    Weight weight(size_t index) const noexcept {
+        return m_nodes[m_leaves + index];
+    }
+
+    /**
+     * @brief Returns the sum of all weights.
+     */
+    Weight total() const noexcept {
+        return m_nodes[1];
+    }
+
+    /**
+     * @brief Draws an index in [0, size()) with probability proportional to its weight.
+     *
+     * The total weight must be positive.
+     */
+    template <typename Engine>
+    size_t operator()(Engine& e) const noexcept {
+        return sample(e.next());
+    }
+
+    /**
+     * @brief Maps a uniform 64-bit word to an index, for callers that generate words in bulk.
+     */
+    size_t sample(uint64_t word) const noexcept {
+        Weight u = static_cast<Weight>(detail::unit_closed_open<double>(word)) * m_nodes[1];
+        size_t k = 1;
+        while (k < m_leaves) {
+            const Weight left = m_nodes[2 * k];
+            // Rounding can leave u just above the sum of a subtree: never descend into an empty one
+            const bool right = u >= left && m_nodes[2 * k + 1] > Weight(0);
+            u -= right ? left : Weight(0);
+            k = 2 * k + right;
+        }
+        return k - m_leaves;
+    }
+
+    /**
+     * @brief Returns the number of outcomes of the distribution.
+     */
+    size_t size() const noexcept {
+        return m_count;
+    }
+
+private:
+    std::vector<Weight> m_nodes = std::vector<Weight>(2, Weight(0));
+    size_t m_leaves = 1;
+    size_t m_count = 0;
+};
+
+} // namespace bpr
+
+#endif // BPR_SAMPLING_HPP
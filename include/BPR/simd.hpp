@@ -0,0 +1,143 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_SIMD_HPP
+#define BPR_SIMD_HPP
+
+#include "utils.hpp"
+
+#include <cstdint>
+#include <cstddef>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#   define BPR_HAS_X86_SIMD 1
+#   define BPR_TARGET(isa) __attribute__((target(isa)))
+#else
+#   define BPR_HAS_X86_SIMD 0
+#endif
+
+/*
+ * The kernels and the dispatch are defined in `simd_impl.hpp`, which includes `<immintrin.h>`
+ * and makes most of the parse time of the headers using this one. By default they are inline and
+ * included here. With `BPR_SEPARATE_COMPILATION` defined in every translation unit, this header
+ * only declares them, and `src/bpr.cpp` must be compiled and linked once to define them.
+ */
+#if defined(BPR_SEPARATE_COMPILATION)
+#   define BPR_SIMD_DECL
+#else
+#   define BPR_SIMD_DECL inline
+#endif
+
+namespace bpr::simd {
+
+/**
+ * SIMD kernels of the multi-lane engines, with runtime selection of the instruction set.
+ *
+ * Stream-layout contract. The output of an engine is defined by its scalar reference, never by
+ * the instructions that compute it, so a seed gives the same words on every host whatever
+ * backend is selected:
+ * - Single-stream engines (`Xoshiro256ss`, PCG32...): `fill(out, n)` returns the words of `n`
+ *   calls to `next()`.
+ * - Multi-lane engines fix their number of logical lanes in their type, independently of the
+ *   register width: word `L * i + l` of `Xoshiro256ssX8` (L = 8) is output `i` of lane `l`, and
+ *   lane `l` is `Xoshiro256ss(stream_seed(seed, l))`. SSE2 computes the 8 lanes as 4 registers
+ *   of 2, AVX2 as 2 of 4 and AVX-512 as 1 of 8. `fill()` returns the words of `next()`: a
+ *   partial round is buffered, never discarded.
+ * - Counter-mode block generators: block `b` of a fill uses counter `c + b`, and word `k` of
+ *   that block is `out[8 * b + k] = x[2k] | x[2k + 1] << 32`, the block computed by
+ *   `ChaCha20::next512()`, however many blocks a backend computes at once.
+ * - The distributions of `bpr::repro` map word k to value k, so they inherit this layout.
+ *
+ * Every backend is checked against the scalar references by `tools/bpr_verify`, which also
+ * prints a digest of the streams to compare between hosts. The x86 backends are available with
+ * GCC and Clang on x86-64; other targets use the `Generic` kernels, which give the same words.
+ */
+
+/**
+ * @brief Instruction set used by the kernels.
+ */
+enum class Backend : uint8_t
+{
+    Generic,    ///< Portable C++ over lane arrays, which the compiler may vectorize for the build target
+    SSE2,       ///< 128-bit vectors, available on every x86-64 CPU
+    AVX2,       ///< 256-bit vectors
+    AVX512      ///< 512-bit vectors (AVX-512F)
+};
+
+/**
+ * @brief Returns the name of a backend, e.g. "avx2".
+ */
+inline const char* name(Backend backend) noexcept
+{
+    switch (backend) {
+        case Backend::SSE2:     return "sse2";
+        case Backend::AVX2:     return "avx2";
+        case Backend::AVX512:   return "avx512";
+        default:                return "generic";
+    }
+}
+
+/**
+ * @brief Returns true if this build and the CPU it runs on can use the backend.
+ */
+BPR_SIMD_DECL bool supported(Backend backend) noexcept;
+
+/**
+ * @brief Returns the widest backend supported by the CPU.
+ */
+BPR_SIMD_DECL Backend best_backend() noexcept;
+
+/**
+ * @brief Returns the backend used by the engines, `best_backend()` unless changed by `set_backend()`.
+ */
+BPR_SIMD_DECL Backend backend() noexcept;
+
+/**
+ * @brief Selects the backend used by the engines of every thread.
+ *
+ * The output of the engines does not depend on it; this is meant for verification and
+ * benchmarks. Does nothing and returns false if the backend is not supported.
+ */
+BPR_SIMD_DECL bool set_backend(Backend backend) noexcept;
+
+/**
+ * @brief Computes `blocks` consecutive ChaCha20 blocks, starting at the counter of `state`.
+ *
+ * `state` is the 16-word ChaCha20 state (constants, key, 64-bit counter in words 12 and 13,
+ * nonce), which is not modified. Block `b` is written to `out[8 * b] .. out[8 * b + 7]`.
+ * Backends compute 4 (Generic, SSE2), 8 (AVX2) or 16 (AVX-512) blocks at a time, and the
+ * remaining blocks with the generic kernel.
+ */
+BPR_SIMD_DECL void chacha20_blocks(const uint32_t* state, uint64_t* out, size_t blocks, Backend backend = simd::backend()) noexcept;
+
+/**
+ * @brief Advances 8 Xoshiro256** lanes by `rounds` steps, writing `8 * rounds` words.
+ *
+ * `state` holds word j of lane l at `state[8 * j + l]`, and output `i` of lane `l` is written to
+ * `out[8 * i + l]`.
+ */
+BPR_SIMD_DECL void xoshiro256ss_x8(uint64_t* state, uint64_t* out, size_t rounds, Backend backend = simd::backend()) noexcept;
+
+} // namespace bpr::simd
+
+#if !defined(BPR_SEPARATE_COMPILATION) || defined(BPR_IMPLEMENTATION)
+#   include "simd_impl.hpp"
+#endif
+
+#endif // BPR_SIMD_HPP
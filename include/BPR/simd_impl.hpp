@@ -0,0 +1,459 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_SIMD_IMPL_HPP
+#define BPR_SIMD_IMPL_HPP
+
+#include "simd.hpp"
+
+#include <cstring>
+#include <atomic>
+
+#if BPR_HAS_X86_SIMD
+#   include <immintrin.h>
+#endif
+
+namespace bpr::simd {
+
+// Definitions of the functions declared in `simd.hpp`, inline unless `BPR_SEPARATE_COMPILATION`
+
+BPR_SIMD_DECL bool supported(Backend backend) noexcept
+{
+#if BPR_HAS_X86_SIMD
+    __builtin_cpu_init();
+    switch (backend) {
+        case Backend::Generic:  return true;
+        case Backend::SSE2:     return true;
+        case Backend::AVX2:     return __builtin_cpu_supports("avx2");
+        case Backend::AVX512:   return __builtin_cpu_supports("avx512f");
+    }
+    return false;
+#else
+    return backend == Backend::Generic;
+#endif
+}
+
+BPR_SIMD_DECL Backend best_backend() noexcept
+{
+    const Backend widest_first[] = { Backend::AVX512, Backend::AVX2, Backend::SSE2 };
+    for (Backend backend : widest_first) {
+        if (supported(backend)) return backend;
+    }
+    return Backend::Generic;
+}
+
+namespace detail {
+
+inline std::atomic<Backend>& active_backend() noexcept
+{
+    static std::atomic<Backend> backend{ best_backend() };
+    return backend;
+}
+
+} // namespace detail
+
+BPR_SIMD_DECL Backend backend() noexcept
+{
+    return detail::active_backend().load(std::memory_order_relaxed);
+}
+
+BPR_SIMD_DECL bool set_backend(Backend backend) noexcept
+{
+    if (!supported(backend)) return false;
+    detail::active_backend().store(backend, std::memory_order_relaxed);
+    return true;
+}
+
+namespace detail {
+
+/**
+ * @brief Writes `blocks` ChaCha20 blocks held as `x[word][lane]` in the layout of the contract.
+ */
+template <size_t L>
+inline void chacha20_store(const uint32_t (&x)[16][L], uint64_t* out, size_t blocks) noexcept
+{
+    for (size_t l = 0; l < blocks; ++l) {
+        for (size_t k = 0; k < 8; ++k) {
+            out[8 * l + k] = static_cast<uint64_t>(x[2 * k][l]) | (static_cast<uint64_t>(x[2 * k + 1][l]) << 32);
+        }
+    }
+}
+
+/**
+ * @brief Computes up to 4 blocks from `counter` with portable code over lane arrays.
+ */
+inline void chacha20_generic(const uint32_t* state, uint64_t counter, uint64_t* out, size_t blocks) noexcept
+{
+    constexpr size_t L = 4;
+
+    // x[j][lane] is word j of the block of counter + lane
+    uint32_t input[16][L], x[16][L];
+    for (size_t j = 0; j < 16; ++j) {
+        for (size_t l = 0; l < L; ++l) {
+            input[j][l] = state[j];
+        }
+    }
+    for (size_t l = 0; l < L; ++l) {
+        input[12][l] = static_cast<uint32_t>(counter + l);
+        input[13][l] = static_cast<uint32_t>((counter + l) >> 32);
+    }
+    std::memcpy(x, input, sizeof(x));
+
+    auto qr = [&](int a, int b, int c, int d) {
+        for (size_t l = 0; l < L; ++l) {
+            x[a][l] += x[b][l]; x[d][l] ^= x[a][l]; x[d][l] = rotl(x[d][l], 16);
+            x[c][l] += x[d][l]; x[b][l] ^= x[c][l]; x[b][l] = rotl(x[b][l], 12);
+            x[a][l] += x[b][l]; x[d][l] ^= x[a][l]; x[d][l] = rotl(x[d][l], 8);
+            x[c][l] += x[d][l]; x[b][l] ^= x[c][l]; x[b][l] = rotl(x[b][l], 7);
+        }
+    };
+
+    // 20 rounds (10 double rounds)
+    for (int i = 0; i < 10; ++i) {
+        qr(0, 4, 8, 12); qr(1, 5, 9, 13); qr(2, 6, 10, 14); qr(3, 7, 11, 15);
+        qr(0, 5, 10, 15); qr(1, 6, 11, 12); qr(2, 7, 8, 13); qr(3, 4, 9, 14);
+    }
+
+    for (size_t j = 0; j < 16; ++j) {
+        for (size_t l = 0; l < L; ++l) {
+            x[j][l] += input[j][l];
+        }
+    }
+    chacha20_store(x, out, blocks < L ? blocks : L);
+}
+
+/**
+ * @brief Advances 8 Xoshiro256** lanes held as `state[word * 8 + lane]` by `rounds` steps.
+ */
+inline void xoshiro256ss_x8_generic(uint64_t* state, uint64_t* out, size_t rounds) noexcept
+{
+    constexpr size_t L = 8;
+    uint64_t s0[L], s1[L], s2[L], s3[L];
+    std::memcpy(s0, state, sizeof(s0));
+    std::memcpy(s1, state + L, sizeof(s1));
+    std::memcpy(s2, state + 2 * L, sizeof(s2));
+    std::memcpy(s3, state + 3 * L, sizeof(s3));
+
+    for (size_t r = 0; r < rounds; ++r) {
+        for (size_t l = 0; l < L; ++l) {
+            out[r * L + l] = rotl(s1[l] * 5, 7) * 9;
+            const uint64_t t = s1[l] << 17;
+            s2[l] ^= s0[l];
+            s3[l] ^= s1[l];
+            s1[l] ^= s2[l];
+            s0[l] ^= s3[l];
+            s2[l] ^= t;
+            s3[l] = rotl(s3[l], 45);
+        }
+    }
+
+    std::memcpy(state, s0, sizeof(s0));
+    std::memcpy(state + L, s1, sizeof(s1));
+    std::memcpy(state + 2 * L, s2, sizeof(s2));
+    std::memcpy(state + 3 * L, s3, sizeof(s3));
+}
+
+#if BPR_HAS_X86_SIMD
+
+// SSE2 ------------------------------------------------------------------------------------------
+
+template <int K>
+BPR_TARGET("sse2") inline __m128i rotl32_sse2(__m128i v) noexcept
+{
+    return _mm_or_si128(_mm_slli_epi32(v, K), _mm_srli_epi32(v, 32 - K));
+}
+
+BPR_TARGET("sse2") inline void qr_sse2(__m128i& a, __m128i& b, __m128i& c, __m128i& d) noexcept
+{
+    a = _mm_add_epi32(a, b); d = rotl32_sse2<16>(_mm_xor_si128(d, a));
+    c = _mm_add_epi32(c, d); b = rotl32_sse2<12>(_mm_xor_si128(b, c));
+    a = _mm_add_epi32(a, b); d = rotl32_sse2<8>(_mm_xor_si128(d, a));
+    c = _mm_add_epi32(c, d); b = rotl32_sse2<7>(_mm_xor_si128(b, c));
+}
+
+BPR_TARGET("sse2") inline void chacha20_sse2(const uint32_t* state, uint64_t counter, uint64_t* out) noexcept
+{
+    constexpr size_t L = 4;
+    __m128i input[16], x[16];
+    for (size_t j = 0; j < 16; ++j) {
+        input[j] = _mm_set1_epi32(static_cast<int>(state[j]));
+    }
+    alignas(16) uint32_t lo[L], hi[L];
+    for (size_t l = 0; l < L; ++l) {
+        lo[l] = static_cast<uint32_t>(counter + l);
+        hi[l] = static_cast<uint32_t>((counter + l) >> 32);
+    }
+    input[12] = _mm_load_si128(reinterpret_cast<const __m128i*>(lo));
+    input[13] = _mm_load_si128(reinterpret_cast<const __m128i*>(hi));
+    for (size_t j = 0; j < 16; ++j) x[j] = input[j];
+
+    for (int i = 0; i < 10; ++i) {
+        qr_sse2(x[0], x[4], x[8], x[12]); qr_sse2(x[1], x[5], x[9], x[13]);
+        qr_sse2(x[2], x[6], x[10], x[14]); qr_sse2(x[3], x[7], x[11], x[15]);
+        qr_sse2(x[0], x[5], x[10], x[15]); qr_sse2(x[1], x[6], x[11], x[12]);
+        qr_sse2(x[2], x[7], x[8], x[13]); qr_sse2(x[3], x[4], x[9], x[14]);
+    }
+
+    alignas(16) uint32_t words[16][L];
+    for (size_t j = 0; j < 16; ++j) {
+        _mm_store_si128(reinterpret_cast<__m128i*>(words[j]), _mm_add_epi32(x[j], input[j]));
+    }
+    chacha20_store(words, out, L);
+}
+
+BPR_TARGET("sse2") inline void xoshiro256ss_x8_sse2(uint64_t* state, uint64_t* out, size_t rounds) noexcept
+{
+    __m128i s0[4], s1[4], s2[4], s3[4];
+    for (size_t v = 0; v < 4; ++v) {
+        s0[v] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 2 * v));
+        s1[v] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 8 + 2 * v));
+        s2[v] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 16 + 2 * v));
+        s3[v] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 24 + 2 * v));
+    }
+
+    for (size_t r = 0; r < rounds; ++r) {
+        for (size_t v = 0; v < 4; ++v) {
+            // rotl(s1 * 5, 7) * 9, with the products as shifts and additions
+            const __m128i m5 = _mm_add_epi64(s1[v], _mm_slli_epi64(s1[v], 2));
+            const __m128i rot = _mm_or_si128(_mm_slli_epi64(m5, 7), _mm_srli_epi64(m5, 57));
+            const __m128i result = _mm_add_epi64(rot, _mm_slli_epi64(rot, 3));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + r * 8 + 2 * v), result);
+
+            const __m128i t = _mm_slli_epi64(s1[v], 17);
+            s2[v] = _mm_xor_si128(s2[v], s0[v]);
+            s3[v] = _mm_xor_si128(s3[v], s1[v]);
+            s1[v] = _mm_xor_si128(s1[v], s2[v]);
+            s0[v] = _mm_xor_si128(s0[v], s3[v]);
+            s2[v] = _mm_xor_si128(s2[v], t);
+            s3[v] = _mm_or_si128(_mm_slli_epi64(s3[v], 45), _mm_srli_epi64(s3[v], 19));
+        }
+    }
+
+    for (size_t v = 0; v < 4; ++v) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 2 * v), s0[v]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 8 + 2 * v), s1[v]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 16 + 2 * v), s2[v]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 24 + 2 * v), s3[v]);
+    }
+}
+
+// AVX2 ------------------------------------------------------------------------------------------
+
+BPR_TARGET("avx2") inline void qr_avx2(__m256i& a, __m256i& b, __m256i& c, __m256i& d) noexcept
+{
+    // Rotations by 16 and 8 move whole bytes, a single shuffle each
+    const __m256i rot16 = _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+                                           2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+    const __m256i rot8 = _mm256_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,
+                                          3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+    a = _mm256_add_epi32(a, b); d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), rot16);
+    c = _mm256_add_epi32(c, d); b = _mm256_xor_si256(b, c);
+    b = _mm256_or_si256(_mm256_slli_epi32(b, 12), _mm256_srli_epi32(b, 20));
+    a = _mm256_add_epi32(a, b); d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), rot8);
+    c = _mm256_add_epi32(c, d); b = _mm256_xor_si256(b, c);
+    b = _mm256_or_si256(_mm256_slli_epi32(b, 7), _mm256_srli_epi32(b, 25));
+}
+
+BPR_TARGET("avx2") inline void chacha20_avx2(const uint32_t* state, uint64_t counter, uint64_t* out) noexcept
+{
+    constexpr size_t L = 8;
+    __m256i input[16], x[16];
+    for (size_t j = 0; j < 16; ++j) {
+        input[j] = _mm256_set1_epi32(static_cast<int>(state[j]));
+    }
+    alignas(32) uint32_t lo[L], hi[L];
+    for (size_t l = 0; l < L; ++l) {
+        lo[l] = static_cast<uint32_t>(counter + l);
+        hi[l] = static_cast<uint32_t>((counter + l) >> 32);
+    }
+    input[12] = _mm256_load_si256(reinterpret_cast<const __m256i*>(lo));
+    input[13] = _mm256_load_si256(reinterpret_cast<const __m256i*>(hi));
+    for (size_t j = 0; j < 16; ++j) x[j] = input[j];
+
+    for (int i = 0; i < 10; ++i) {
+        qr_avx2(x[0], x[4], x[8], x[12]); qr_avx2(x[1], x[5], x[9], x[13]);
+        qr_avx2(x[2], x[6], x[10], x[14]); qr_avx2(x[3], x[7], x[11], x[15]);
+        qr_avx2(x[0], x[5], x[10], x[15]); qr_avx2(x[1], x[6], x[11], x[12]);
+        qr_avx2(x[2], x[7], x[8], x[13]); qr_avx2(x[3], x[4], x[9], x[14]);
+    }
+
+    alignas(32) uint32_t words[16][L];
+    for (size_t j = 0; j < 16; ++j) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(words[j]), _mm256_add_epi32(x[j], input[j]));
+    }
+    chacha20_store(words, out, L);
+}
+
+BPR_TARGET("avx2") inline void xoshiro256ss_x8_avx2(uint64_t* state, uint64_t* out, size_t rounds) noexcept
+{
+    __m256i s0[2], s1[2], s2[2], s3[2];
+    for (size_t v = 0; v < 2; ++v) {
+        s0[v] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state + 4 * v));
+        s1[v] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state + 8 + 4 * v));
+        s2[v] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state + 16 + 4 * v));
+        s3[v] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state + 24 + 4 * v));
+    }
+
+    for (size_t r = 0; r < rounds; ++r) {
+        for (size_t v = 0; v < 2; ++v) {
+            const __m256i m5 = _mm256_add_epi64(s1[v], _mm256_slli_epi64(s1[v], 2));
+            const __m256i rot = _mm256_or_si256(_mm256_slli_epi64(m5, 7), _mm256_srli_epi64(m5, 57));
+            const __m256i result = _mm256_add_epi64(rot, _mm256_slli_epi64(rot, 3));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + r * 8 + 4 * v), result);
+
+            const __m256i t = _mm256_slli_epi64(s1[v], 17);
+            s2[v] = _mm256_xor_si256(s2[v], s0[v]);
+            s3[v] = _mm256_xor_si256(s3[v], s1[v]);
+            s1[v] = _mm256_xor_si256(s1[v], s2[v]);
+            s0[v] = _mm256_xor_si256(s0[v], s3[v]);
+            s2[v] = _mm256_xor_si256(s2[v], t);
+            s3[v] = _mm256_or_si256(_mm256_slli_epi64(s3[v], 45), _mm256_srli_epi64(s3[v], 19));
+        }
+    }
+
+    for (size_t v = 0; v < 2; ++v) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(state + 4 * v), s0[v]);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(state + 8 + 4 * v), s1[v]);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(state + 16 + 4 * v), s2[v]);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(state + 24 + 4 * v), s3[v]);
+    }
+}
+
+// AVX-512 ---------------------------------------------------------------------------------------
+
+// The zero-masking forms of the shifts and rotations are used because GCC warns about the
+// undefined source register of the unmasked forms in functions with a target attribute
+
+BPR_TARGET("avx512f") inline void qr_avx512(__m512i& a, __m512i& b, __m512i& c, __m512i& d) noexcept
+{
+    const __mmask16 all = 0xFFFF;
+    a = _mm512_add_epi32(a, b); d = _mm512_maskz_rol_epi32(all, _mm512_xor_si512(d, a), 16);
+    c = _mm512_add_epi32(c, d); b = _mm512_maskz_rol_epi32(all, _mm512_xor_si512(b, c), 12);
+    a = _mm512_add_epi32(a, b); d = _mm512_maskz_rol_epi32(all, _mm512_xor_si512(d, a), 8);
+    c = _mm512_add_epi32(c, d); b = _mm512_maskz_rol_epi32(all, _mm512_xor_si512(b, c), 7);
+}
+
+BPR_TARGET("avx512f") inline void chacha20_avx512(const uint32_t* state, uint64_t counter, uint64_t* out) noexcept
+{
+    constexpr size_t L = 16;
+    __m512i input[16], x[16];
+    for (size_t j = 0; j < 16; ++j) {
+        input[j] = _mm512_set1_epi32(static_cast<int>(state[j]));
+    }
+    alignas(64) uint32_t lo[L], hi[L];
+    for (size_t l = 0; l < L; ++l) {
+        lo[l] = static_cast<uint32_t>(counter + l);
+        hi[l] = static_cast<uint32_t>((counter + l) >> 32);
+    }
+    input[12] = _mm512_load_si512(lo);
+    input[13] = _mm512_load_si512(hi);
+    for (size_t j = 0; j < 16; ++j) x[j] = input[j];
+
+    for (int i = 0; i < 10; ++i) {
+        qr_avx512(x[0], x[4], x[8], x[12]); qr_avx512(x[1], x[5], x[9], x[13]);
+        qr_avx512(x[2], x[6], x[10], x[14]); qr_avx512(x[3], x[7], x[11], x[15]);
+        qr_avx512(x[0], x[5], x[10], x[15]); qr_avx512(x[1], x[6], x[11], x[12]);
+        qr_avx512(x[2], x[7], x[8], x[13]); qr_avx512(x[3], x[4], x[9], x[14]);
+    }
+
+    alignas(64) uint32_t words[16][L];
+    for (size_t j = 0; j < 16; ++j) {
+        _mm512_store_si512(words[j], _mm512_add_epi32(x[j], input[j]));
+    }
+    chacha20_store(words, out, L);
+}
+
+BPR_TARGET("avx512f") inline void xoshiro256ss_x8_avx512(uint64_t* state, uint64_t* out, size_t rounds) noexcept
+{
+    __m512i s0 = _mm512_loadu_si512(state);
+    __m512i s1 = _mm512_loadu_si512(state + 8);
+    __m512i s2 = _mm512_loadu_si512(state + 16);
+    __m512i s3 = _mm512_loadu_si512(state + 24);
+
+    const __mmask8 all = 0xFF;
+    for (size_t r = 0; r < rounds; ++r) {
+        const __m512i m5 = _mm512_add_epi64(s1, _mm512_maskz_slli_epi64(all, s1, 2));
+        const __m512i rot = _mm512_maskz_rol_epi64(all, m5, 7);
+        _mm512_storeu_si512(out + r * 8, _mm512_add_epi64(rot, _mm512_maskz_slli_epi64(all, rot, 3)));
+
+        const __m512i t = _mm512_maskz_slli_epi64(all, s1, 17);
+        s2 = _mm512_xor_si512(s2, s0);
+        s3 = _mm512_xor_si512(s3, s1);
+        s1 = _mm512_xor_si512(s1, s2);
+        s0 = _mm512_xor_si512(s0, s3);
+        s2 = _mm512_xor_si512(s2, t);
+        s3 = _mm512_maskz_rol_epi64(all, s3, 45);
+    }
+
+    _mm512_storeu_si512(state, s0);
+    _mm512_storeu_si512(state + 8, s1);
+    _mm512_storeu_si512(state + 16, s2);
+    _mm512_storeu_si512(state + 24, s3);
+}
+
+#endif // BPR_HAS_X86_SIMD
+
+} // namespace detail
+
+BPR_SIMD_DECL void chacha20_blocks(const uint32_t* state, uint64_t* out, size_t blocks, Backend backend) noexcept
+{
+    uint64_t counter = (static_cast<uint64_t>(state[13]) << 32) | state[12];
+    size_t b = 0;
+
+#if BPR_HAS_X86_SIMD
+    switch (backend) {
+        case Backend::AVX512:
+            for (; blocks - b >= 16; b += 16, counter += 16) detail::chacha20_avx512(state, counter, out + 8 * b);
+            break;
+        case Backend::AVX2:
+            for (; blocks - b >= 8; b += 8, counter += 8) detail::chacha20_avx2(state, counter, out + 8 * b);
+            break;
+        case Backend::SSE2:
+            for (; blocks - b >= 4; b += 4, counter += 4) detail::chacha20_sse2(state, counter, out + 8 * b);
+            break;
+        default:
+            break;
+    }
+#else
+    (void)backend;
+#endif
+
+    for (; b < blocks; b += 4, counter += 4) {
+        detail::chacha20_generic(state, counter, out + 8 * b, blocks - b);
+    }
+}
+
+BPR_SIMD_DECL void xoshiro256ss_x8(uint64_t* state, uint64_t* out, size_t rounds, Backend backend) noexcept
+{
+#if BPR_HAS_X86_SIMD
+    switch (backend) {
+        case Backend::AVX512:   detail::xoshiro256ss_x8_avx512(state, out, rounds); return;
+        case Backend::AVX2:     detail::xoshiro256ss_x8_avx2(state, out, rounds); return;
+        case Backend::SSE2:     detail::xoshiro256ss_x8_sse2(state, out, rounds); return;
+        default:                break;
+    }
+#else
+    (void)backend;
+#endif
+    detail::xoshiro256ss_x8_generic(state, out, rounds);
+}
+
+} // namespace bpr::simd
+
+#endif // BPR_SIMD_IMPL_HPP
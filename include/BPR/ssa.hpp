@@ -0,0 +1,751 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_SSA_HPP
+#define BPR_SSA_HPP
+
+#include "distributions.hpp"
+#include "generator.hpp"
+#include "sampling.hpp"
+#include "parallel.hpp"
+#include "engine.hpp"
+#include "utils.hpp"
+#include "prng.hpp"
+
+#include <initializer_list>
+#include <type_traits>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <cmath>
+
+namespace bpr::ssa {
+
+/**
+ * Stochastic simulation of well-mixed chemical reaction networks (Gillespie's algorithm).
+ *
+ * A `Network` lists the reactions between species with mass-action kinetics. Three simulators
+ * advance a state (one population per species) through time:
+ * - `DirectMethod`: Gillespie's direct method, with a sum tree of the propensities, so that a step
+ *   costs O(log R) plus the update of the reactions that depend on the one that fired.
+ * - `NextReactionMethod`: Gibson and Bruck's next reaction method, with the absolute firing times
+ *   of the reactions in an indexed priority queue; it draws a single random value per step.
+ * - `TauLeaping`: Poisson tau-leaping with the step size selection of Cao, Gillespie and Petzold,
+ *   which fires many reactions per step and falls back to exact steps when they would be few.
+ *
+ * `run_trajectories()` runs many independent trajectories of the same network in parallel, each
+ * one on its own stream, so the results do not depend on the number of threads.
+ */
+
+/**
+ * @brief A species taking part in a reaction, with its stoichiometric coefficient.
+ */
+struct Term
+{
+    uint32_t species;       ///< Index of the species, in [0, species_count)
+    uint32_t count = 1;     ///< Number of molecules consumed or produced
+};
+
+/**
+ * @class Network
+ * @brief A chemical reaction network with mass-action kinetics.
+ *
+ * The propensity of a reaction of stochastic rate constant `c` is `c` times the number of distinct
+ * combinations of its reactant molecules: `c * x` for `X -> ...`, `c * x * y` for `X + Y -> ...`
+ * and `c * x * (x - 1) / 2` for `2X -> ...`. The network also records which propensities depend
+ * on the species changed by each reaction, so simulators only recompute those after a step.
+ *
+ * @example
+ * ```cpp
+ * bpr::ssa::Network network(2);                          // species 0: mRNA, 1: protein
+ * network.add_reaction(10.0, {}, { { 0 } });             // 0 -> mRNA
+ * network.add_reaction(1.0, { { 0 } }, {});              // mRNA -> 0
+ * network.add_reaction(5.0, { { 0 } }, { { 0 }, { 1 } });   // mRNA -> mRNA + protein
+ * network.add_reaction(0.1, { { 1 } }, {});              // protein -> 0
+ * ```
+ */
+class Network
+{
+public:
+    /**
+     * @brief Creates a network of `species_count` species and no reaction.
+     */
+    explicit Network(size_t species_count)
+        : m_species_count(species_count), m_readers(species_count), m_writers(species_count)
+    {
+        m_reactant_offsets.push_back(0);
+        m_change_offsets.push_back(0);
+    }
+
+    /**
+     * @brief Adds the reaction `reactants -> products` of stochastic rate constant `rate`.
+     *
+     * A species can appear on both sides (catalysts). Species indices must be in [0, species_count).
+     *
+     * @return The index of the reaction.
+     */
+    size_t add_reaction(double rate, std::initializer_list<Term> reactants, std::initializer_list<Term> products) {
+        return add_reaction(rate, reactants.begin(), reactants.size(), products.begin(), products.size());
+    }
+
+    /**
+     * @brief Adds the reaction `reactants -> products` of stochastic rate constant `rate`.
+     */
+    size_t add_reaction(double rate, const std::vector<Term>& reactants, const std::vector<Term>& products) {
+        return add_reaction(rate, reactants.data(), reactants.size(), products.data(), products.size());
+    }
+
+    /**
+     * @brief Adds the reaction `reactants -> products` of stochastic rate constant `rate`.
+     */
+    size_t add_reaction(double rate, const Term* reactants, size_t reactant_count,
+                        const Term* products, size_t product_count)
+    {
+        const uint32_t r = static_cast<uint32_t>(m_constants.size());
+
+        // Merge the terms per species: the reactants, and the net change of the populations
+        std::vector<int64_t> consumed(m_species_count, 0), change(m_species_count, 0);
+        for (size_t k = 0; k < reactant_count; ++k) {
+            consumed[reactants[k].species] += reactants[k].count;
+            change[reactants[k].species] -= reactants[k].count;
+        }
+        for (size_t k = 0; k < product_count; ++k) {
+            change[products[k].species] += products[k].count;
+        }
+
+        // Dividing by the factorials turns falling factorials into numbers of combinations
+        double constant = rate;
+        for (size_t s = 0; s < m_species_count; ++s) {
+            if (consumed[s] == 0) continue;
+            for (int64_t c = 2; c <= consumed[s]; ++c) {
+                constant /= static_cast<double>(c);
+            }
+            m_reactant_species.push_back(static_cast<uint32_t>(s));
+            m_reactant_counts.push_back(static_cast<uint32_t>(consumed[s]));
+            m_readers[s].push_back(r);
+        }
+        for (size_t s = 0; s < m_species_count; ++s) {
+            if (change[s] == 0) continue;
+            m_change_species.push_back(static_cast<uint32_t>(s));
+            m_change_deltas.push_back(change[s]);
+            m_writers[s].push_back(r);
+        }
+        m_reactant_offsets.push_back(m_reactant_species.size());
+        m_change_offsets.push_back(m_change_species.size());
+        m_constants.push_back(constant);
+
+        // The new reaction depends on the earlier reactions that change its reactants, and
+        // the reactions reading the species it changes depend on it
+        m_dependents.emplace_back();
+        for (size_t k = m_change_offsets[r]; k < m_change_offsets[r + 1]; ++k) {
+            for (uint32_t q : m_readers[m_change_species[k]]) {
+                add_dependent(r, q);
+            }
+        }
+        for (size_t k = m_reactant_offsets[r]; k < m_reactant_offsets[r + 1]; ++k) {
+            for (uint32_t q : m_writers[m_reactant_species[k]]) {
+                add_dependent(q, r);
+            }
+        }
+
+        return r;
+    }
+
+    /**
+     * @brief Returns the propensity of reaction `r` in the state `state` (one population per species).
+     */
+    double propensity(size_t r, const int64_t* state) const noexcept {
+        double a = m_constants[r];
+        for (size_t k = m_reactant_offsets[r]; k < m_reactant_offsets[r + 1]; ++k) {
+            const int64_t x = state[m_reactant_species[k]];
+            const uint32_t n = m_reactant_counts[k];
+            if (x < static_cast<int64_t>(n)) return 0.0;
+            for (uint32_t c = 0; c < n; ++c) {
+                a *= static_cast<double>(x - c);
+            }
+        }
+        return a;
+    }
+
+    /**
+     * @brief Fires reaction `r` `times` times in the state `state`.
+     */
+    void apply(size_t r, int64_t* state, int64_t times = 1) const noexcept {
+        for (size_t k = m_change_offsets[r]; k < m_change_offsets[r + 1]; ++k) {
+            state[m_change_species[k]] += m_change_deltas[k] * times;
+        }
+    }
+
+    /**
+     * @brief Returns the reactions whose propensity changes when reaction `r` fires.
+     */
+    const std::vector<uint32_t>& dependents(size_t r) const noexcept {
+        return m_dependents[r];
+    }
+
+    size_t species_count() const noexcept {
+        return m_species_count;
+    }
+
+    size_t reaction_count() const noexcept {
+        return m_constants.size();
+    }
+
+private:
+    void add_dependent(uint32_t r, uint32_t q) {
+        std::vector<uint32_t>& list = m_dependents[r];
+        if (std::find(list.begin(), list.end(), q) == list.end()) {
+            list.push_back(q);
+        }
+    }
+
+    // Tau-leaping needs the reactants and changes of every reaction
+    friend class TauLeaping;
+
+    size_t m_species_count;
+    std::vector<double> m_constants;                    ///< Rate constants divided by the factorials of the coefficients
+    std::vector<size_t> m_reactant_offsets;             ///< Reactants of reaction r in [offsets[r], offsets[r + 1])
+    std::vector<uint32_t> m_reactant_species;
+    std::vector<uint32_t> m_reactant_counts;
+    std::vector<size_t> m_change_offsets;               ///< Non-zero net changes of reaction r in [offsets[r], offsets[r + 1])
+    std::vector<uint32_t> m_change_species;
+    std::vector<int64_t> m_change_deltas;
+    std::vector<std::vector<uint32_t>> m_dependents;
+    std::vector<std::vector<uint32_t>> m_readers;       ///< Reactions consuming each species
+    std::vector<std::vector<uint32_t>> m_writers;       ///< Reactions changing each species
+};
+
+namespace detail {
+
+/**
+ * @brief Binary min-heap of the firing times of the reactions, which knows the position of each reaction.
+ */
+class IndexedHeap
+{
+public:
+    explicit IndexedHeap(size_t count = 0)
+        : m_keys(count, std::numeric_limits<double>::infinity()), m_heap(count), m_position(count)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            m_heap[i] = static_cast<uint32_t>(i);
+            m_position[i] = static_cast<uint32_t>(i);
+        }
+    }
+
+    size_t top() const noexcept {
+        return m_heap[0];
+    }
+
+    double key(size_t i) const noexcept {
+        return m_keys[i];
+    }
+
+    /**
+     * @brief Changes the key of element `i` and restores the heap order in O(log n).
+     */
+    void update(size_t i, double key) noexcept {
+        const double old = m_keys[i];
+        m_keys[i] = key;
+        if (key < old) sift_up(m_position[i]);
+        else sift_down(m_position[i]);
+    }
+
+private:
+    void sift_up(size_t p) noexcept {
+        const uint32_t item = m_heap[p];
+        while (p > 0) {
+            const size_t parent = (p - 1) / 2;
+            if (!(m_keys[item] < m_keys[m_heap[parent]])) break;
+            place(p, m_heap[parent]);
+            p = parent;
+        }
+        place(p, item);
+    }
+
+    void sift_down(size_t p) noexcept {
+        const uint32_t item = m_heap[p];
+        const size_t n = m_heap.size();
+        for (;;) {
+            size_t child = 2 * p + 1;
+            if (child >= n) break;
+            if (child + 1 < n && m_keys[m_heap[child + 1]] < m_keys[m_heap[child]]) ++child;
+            if (!(m_keys[m_heap[child]] < m_keys[item])) break;
+            place(p, m_heap[child]);
+            p = child;
+        }
+        place(p, item);
+    }
+
+    void place(size_t p, uint32_t item) noexcept {
+        m_heap[p] = item;
+        m_position[item] = static_cast<uint32_t>(p);
+    }
+
+    std::vector<double> m_keys;
+    std::vector<uint32_t> m_heap;
+    std::vector<uint32_t> m_position;
+};
+
+} // namespace detail
+
+/**
+ * @class DirectMethod
+ * @brief Gillespie's direct method: an exponential waiting time, then a reaction drawn in proportion to its propensity.
+ *
+ * The propensities are the leaves of a `SumTree`, so drawing the reaction costs O(log R) and only
+ * the propensities of the reactions that depend on the fired one are recomputed. Each step uses
+ * two random words. The network must outlive the simulator.
+ */
+class DirectMethod
+{
+public:
+    /**
+     * @brief Starts a simulation of `network` from the populations `initial` at time `time`.
+     */
+    DirectMethod(const Network& network, const int64_t* initial, double time = 0.0)
+        : m_network(&network), m_state(initial, initial + network.species_count()),
+          m_tree(network.reaction_count()), m_time(time)
+    {
+        reset(initial, time);
+    }
+
+    /**
+     * @brief Restarts the simulation from the populations `state` at time `time`.
+     */
+    void reset(const int64_t* state, double time) noexcept {
+        if (state != m_state.data()) {
+            std::copy(state, state + m_state.size(), m_state.begin());
+        }
+        m_time = time;
+        for (size_t r = 0; r < m_network->reaction_count(); ++r) {
+            m_tree.set(r, m_network->propensity(r, m_state.data()));
+        }
+    }
+
+    /**
+     * @brief Fires reactions until time `until`, and leaves the simulation at that time.
+     *
+     * Waiting times are memoryless, so stopping at `until` and calling `advance()` again later
+     * gives the same distribution of trajectories as a single call.
+     *
+     * @return The number of reactions fired.
+     */
+    template <typename Engine>
+    size_t advance(Engine& e, double until) noexcept {
+        // Assert that the Engine type is valid (derived from IEngine)
+        static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+        size_t steps = 0;
+        for (;;) {
+            const double total = m_tree.total();
+            if (!(total > 0.0)) break;
+
+            const double wait = exponential(e, total);
+            if (m_time + wait > until) break;
+            m_time += wait;
+
+            const size_t r = m_tree(e);
+            m_network->apply(r, m_state.data());
+            for (uint32_t q : m_network->dependents(r)) {
+                m_tree.set(q, m_network->propensity(q, m_state.data()));
+            }
+            ++steps;
+        }
+        m_time = std::max(m_time, until);
+        return steps;
+    }
+
+    const Network& network() const noexcept {
+        return *m_network;
+    }
+
+    const int64_t* state() const noexcept {
+        return m_state.data();
+    }
+
+    double time() const noexcept {
+        return m_time;
+    }
+
+private:
+    const Network* m_network;
+    std::vector<int64_t> m_state;
+    SumTree<double> m_tree;
+    double m_time;
+};
+
+/**
+ * @class NextReactionMethod
+ * @brief Gibson and Bruck's next reaction method: absolute firing times in an indexed priority queue.
+ *
+ * Each step fires the reaction with the earliest firing time and draws a single exponential
+ * value, for that reaction; the times of the dependent reactions are rescaled by the ratio of
+ * their old and new propensities instead of being drawn again. A step costs O(log R) per
+ * dependent reaction, which pays off for large networks whose reactions have few dependents.
+ * The network must outlive the simulator.
+ */
+class NextReactionMethod
+{
+public:
+    /**
+     * @brief Starts a simulation of `network` from the populations `initial` at time `time`.
+     */
+    NextReactionMethod(const Network& network, const int64_t* initial, double time = 0.0)
+        : m_network(&network), m_state(initial, initial + network.species_count()),
+          m_propensities(network.reaction_count()), m_heap(network.reaction_count()), m_time(time)
+    {
+        reset(initial, time);
+    }
+
+    /**
+     * @brief Restarts the simulation from the populations `state` at time `time`.
+     *
+     * The firing times are drawn by the next call to `advance()`.
+     */
+    void reset(const int64_t* state, double time) noexcept {
+        if (state != m_state.data()) {
+            std::copy(state, state + m_state.size(), m_state.begin());
+        }
+        m_time = time;
+        m_drawn = false;
+    }
+
+    /**
+     * @brief Fires reactions until time `until`, and leaves the simulation at that time.
+     *
+     * The firing times beyond `until` are kept, so consecutive calls continue the same trajectory.
+     *
+     * @return The number of reactions fired.
+     */
+    template <typename Engine>
+    size_t advance(Engine& e, double until) noexcept {
+        // Assert that the Engine type is valid (derived from IEngine)
+        static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+        constexpr double NEVER = std::numeric_limits<double>::infinity();
+
+        const size_t count = m_network->reaction_count();
+        if (count == 0) {
+            m_time = std::max(m_time, until);
+            return 0;
+        }
+
+        if (!m_drawn) {
+            for (size_t r = 0; r < count; ++r) {
+                const double a = m_network->propensity(r, m_state.data());
+                m_propensities[r] = a;
+                m_heap.update(r, a > 0.0 ? m_time + exponential(e, a) : NEVER);
+            }
+            m_drawn = true;
+        }
+
+        size_t steps = 0;
+        for (;;) {
+            const size_t r = m_heap.top();
+            const double t = m_heap.key(r);
+            if (t > until) break;
+            m_time = t;
+
+            m_network->apply(r, m_state.data());
+            for (uint32_t q : m_network->dependents(r)) {
+                if (q == r) continue;
+                const double old_a = m_propensities[q];
+                const double new_a = m_network->propensity(q, m_state.data());
+                m_propensities[q] = new_a;
+
+                double next = NEVER;
+                if (new_a > 0.0) {
+                    // Rescaling the remaining time keeps it exponential of the new rate
+                    next = old_a > 0.0 ? t + (old_a / new_a) * (m_heap.key(q) - t) : t + exponential(e, new_a);
+                }
+                m_heap.update(q, next);
+            }
+
+            const double a = m_network->propensity(r, m_state.data());
+            m_propensities[r] = a;
+            m_heap.update(r, a > 0.0 ? t + exponential(e, a) : NEVER);
+            ++steps;
+        }
+        m_time = std::max(m_time, until);
+        return steps;
+    }
+
+    const Network& network() const noexcept {
+        return *m_network;
+    }
+
+    const int64_t* state() const noexcept {
+        return m_state.data();
+    }
+
+    double time() const noexcept {
+        return m_time;
+    }
+
+private:
+    const Network* m_network;
+    std::vector<int64_t> m_state;
+    std::vector<double> m_propensities;
+    detail::IndexedHeap m_heap;
+    double m_time;
+    bool m_drawn = false;
+};
+
+/**
+ * @class TauLeaping
+ * @brief Poisson tau-leaping: every reaction fires a Poisson number of times over a leap of length tau.
+ *
+ * The leap is the largest one for which the expected relative change of every reactant
+ * population stays below `epsilon` (Cao, Gillespie and Petzold, 2006). When it is shorter than
+ * about 10 exact steps, the simulator takes 100 exact steps of the direct method instead, and a
+ * leap that would make a population negative is halved and drawn again. The network must
+ * outlive the simulator.
+ */
+class TauLeaping
+{
+public:
+    /**
+     * @brief Starts a simulation of `network` from the populations `initial` at time `time`.
+     */
+    TauLeaping(const Network& network, const int64_t* initial, double time = 0.0, double epsilon = 0.03)
+        : m_network(&network), m_state(initial, initial + network.species_count()), m_backup(m_state),
+          m_propensities(network.reaction_count()), m_mean(network.species_count()),
+          m_variance(network.species_count()), m_order(network.species_count(), 0),
+          m_coefficient(network.species_count(), 0), m_time(time), m_epsilon(epsilon)
+    {
+        // Highest order of the reactions consuming each species, and its coefficient in them
+        for (size_t r = 0; r < network.reaction_count(); ++r) {
+            uint32_t order = 0;
+            for (size_t k = network.m_reactant_offsets[r]; k < network.m_reactant_offsets[r + 1]; ++k) {
+                order += network.m_reactant_counts[k];
+            }
+            for (size_t k = network.m_reactant_offsets[r]; k < network.m_reactant_offsets[r + 1]; ++k) {
+                const uint32_t s = network.m_reactant_species[k];
+                const uint32_t n = network.m_reactant_counts[k];
+                if (order > m_order[s] || (order == m_order[s] && n > m_coefficient[s])) {
+                    m_order[s] = order;
+                    m_coefficient[s] = n;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Restarts the simulation from the populations `state` at time `time`.
+     */
+    void reset(const int64_t* state, double time) noexcept {
+        if (state != m_state.data()) {
+            std::copy(state, state + m_state.size(), m_state.begin());
+        }
+        m_time = time;
+    }
+
+    /**
+     * @brief Leaps until time `until`, and leaves the simulation at that time.
+     *
+     * @return The number of steps taken, leaps and exact steps together.
+     */
+    template <typename Engine>
+    size_t advance(Engine& e, double until) noexcept {
+        // Assert that the Engine type is valid (derived from IEngine)
+        static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+        constexpr int EXACT_STEPS = 100;
+
+        const size_t count = m_network->reaction_count();
+        size_t steps = 0;
+
+        while (m_time < until) {
+            double total = 0.0;
+            for (size_t r = 0; r < count; ++r) {
+                m_propensities[r] = m_network->propensity(r, m_state.data());
+                total += m_propensities[r];
+            }
+            if (!(total > 0.0)) break;
+
+            double tau = select_leap();
+            if (tau * total < 10.0) {
+                steps += exact_steps(e, total, until, EXACT_STEPS);
+                continue;
+            }
+
+            tau = std::min(tau, until - m_time);
+            for (;;) {
+                m_backup = m_state;
+                for (size_t r = 0; r < count; ++r) {
+                    const int64_t k = poisson<int64_t>(e, m_propensities[r] * tau);
+                    if (k != 0) m_network->apply(r, m_state.data(), k);
+                }
+                if (std::none_of(m_state.begin(), m_state.end(), [](int64_t x) { return x < 0; })) break;
+                m_state.swap(m_backup);
+                tau *= 0.5;
+            }
+            m_time += tau;
+            ++steps;
+        }
+        m_time = std::max(m_time, until);
+        return steps;
+    }
+
+    const Network& network() const noexcept {
+        return *m_network;
+    }
+
+    const int64_t* state() const noexcept {
+        return m_state.data();
+    }
+
+    double time() const noexcept {
+        return m_time;
+    }
+
+private:
+    /**
+     * @brief Largest leap keeping the mean and standard deviation of each change below epsilon * x / g.
+     */
+    double select_leap() noexcept {
+        const Network& net = *m_network;
+        std::fill(m_mean.begin(), m_mean.end(), 0.0);
+        std::fill(m_variance.begin(), m_variance.end(), 0.0);
+        for (size_t r = 0; r < net.reaction_count(); ++r) {
+            const double a = m_propensities[r];
+            for (size_t k = net.m_change_offsets[r]; k < net.m_change_offsets[r + 1]; ++k) {
+                const double v = static_cast<double>(net.m_change_deltas[k]);
+                m_mean[net.m_change_species[k]] += v * a;
+                m_variance[net.m_change_species[k]] += v * v * a;
+            }
+        }
+
+        double tau = std::numeric_limits<double>::infinity();
+        for (size_t s = 0; s < m_state.size(); ++s) {
+            if (m_order[s] == 0) continue;
+            const double bound = std::max(m_epsilon * static_cast<double>(m_state[s]) / g(s), 1.0);
+            if (m_mean[s] != 0.0) tau = std::min(tau, bound / std::abs(m_mean[s]));
+            if (m_variance[s] != 0.0) tau = std::min(tau, bound * bound / m_variance[s]);
+        }
+        return tau;
+    }
+
+    /**
+     * @brief The factor g of Cao, Gillespie and Petzold for species `s`, from its highest order reaction.
+     */
+    double g(size_t s) const noexcept {
+        const double x1 = std::max(static_cast<double>(m_state[s]) - 1.0, 1.0);
+        const double x2 = std::max(static_cast<double>(m_state[s]) - 2.0, 1.0);
+        switch (m_order[s]) {
+            case 1: return 1.0;
+            case 2: return m_coefficient[s] == 1 ? 2.0 : 2.0 + 1.0 / x1;
+            case 3:
+                if (m_coefficient[s] == 1) return 3.0;
+                if (m_coefficient[s] == 2) return 1.5 * (2.0 + 1.0 / x1);
+                return 3.0 + 1.0 / x1 + 2.0 / x2;
+            default: return static_cast<double>(m_order[s]);
+        }
+    }
+
+    /**
+     * @brief Up to `max_steps` steps of the direct method, with the propensities in `m_propensities`.
+     */
+    template <typename Engine>
+    size_t exact_steps(Engine& e, double total, double until, int max_steps) noexcept {
+        size_t steps = 0;
+        for (int i = 0; i < max_steps && total > 0.0; ++i) {
+            const double wait = exponential(e, total);
+            if (m_time + wait > until) {
+                m_time = until;
+                break;
+            }
+            m_time += wait;
+
+            // Linear scan: the network is small whenever exact steps are needed often
+            double u = bpr::detail::unit_closed_open<double>(e.next()) * total;
+            size_t r = 0;
+            while (r + 1 < m_propensities.size() && (u >= m_propensities[r] || m_propensities[r] == 0.0)) {
+                u -= m_propensities[r++];
+            }
+
+            m_network->apply(r, m_state.data());
+            for (uint32_t q : m_network->dependents(r)) {
+                total -= m_propensities[q];
+                m_propensities[q] = m_network->propensity(q, m_state.data());
+                total += m_propensities[q];
+            }
+            ++steps;
+        }
+        return steps;
+    }
+
+    const Network* m_network;
+    std::vector<int64_t> m_state;
+    std::vector<int64_t> m_backup;
+    std::vector<double> m_propensities;
+    std::vector<double> m_mean;
+    std::vector<double> m_variance;
+    std::vector<uint32_t> m_order;
+    std::vector<uint32_t> m_coefficient;
+    double m_time;
+    double m_epsilon;
+};
+
+/**
+ * @brief Runs `trajectory_count` independent trajectories of a simulator and records their states at the given times.
+ *
+ * Each trajectory is a copy of `simulator`, started from its state and time, and draws from
+ * `stream_seed(seed, trajectory)`, so the results do not depend on the number of threads.
+ * Trajectories are handed to the threads one at a time, because their costs can differ by
+ * orders of magnitude, and each thread reuses one copy of the simulator.
+ *
+ * @tparam Engine The engine of each trajectory.
+ * @tparam Simulator `DirectMethod`, `NextReactionMethod` or `TauLeaping`.
+ *
+ * @param seed The seed of the simulation.
+ * @param simulator The simulator giving the network, the initial state and the start time.
+ * @param trajectory_count The number of trajectories.
+ * @param times The increasing times at which the states are recorded, not before the start time.
+ * @param time_count The number of times.
+ * @param out Receives `trajectory_count * time_count * species_count` populations: the state of
+ *            trajectory `i` at time `times[k]` starts at `out[(i * time_count + k) * species_count]`.
+ * @param thread_count The number of threads (0 for all hardware threads).
+ */
+template <typename Engine = prng::Xoshiro256ss, typename Simulator>
+void run_trajectories(uint64_t seed, const Simulator& simulator, size_t trajectory_count,
+                      const double* times, size_t time_count, int64_t* out, unsigned thread_count = 0)
+{
+    // Assert that the Engine type is valid (derived from IEngine)
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+    const size_t species = simulator.network().species_count();
+    std::vector<Simulator> workers(thread_count_for(trajectory_count, thread_count), simulator);
+
+    parallel_for(trajectory_count, [&](size_t trajectory, unsigned thread) {
+        Engine e(stream_seed(seed, trajectory));
+        Simulator& sim = workers[thread];
+        sim.reset(simulator.state(), simulator.time());
+
+        int64_t* row = out + trajectory * time_count * species;
+        for (size_t k = 0; k < time_count; ++k) {
+            sim.advance(e, times[k]);
+            std::copy(sim.state(), sim.state() + species, row + k * species);
+        }
+    }, thread_count);
+}
+
+} // namespace bpr::ssa
+
+#endif // BPR_SSA_HPP
@@ -0,0 +1,205 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_TABULATION_HPP
+#define BPR_TABULATION_HPP
+
+#include "generator.hpp"
+#include "engine.hpp"
+
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <array>
+
+#if defined(__AVX2__)
+#   include <immintrin.h>
+#endif
+
+namespace bpr {
+
+/**
+ * @brief Variant of tabulation hashing used by `TabulationHash`.
+ */
+enum class Tabulation
+{
+    Simple,     ///< XOR of one random table entry per key byte, 3-independent
+    Twisted     ///< The other bytes also select a "twist" of the last byte, with much stronger concentration bounds
+};
+
+/**
+ * @class TabulationHash
+ * @brief Tabulation hashing of unsigned integer keys, with tables filled by a BPR engine.
+ *
+ * The key is split into its bytes, each byte indexes a table of 256 random 64-bit words and the
+ * selected words are XORed together. Simple tabulation is 3-independent and, as shown by
+ * Patrascu and Thorup, behaves like a truly random function for linear probing, cuckoo hashing
+ * and min-wise sketches. Twisted tabulation additionally XORs one random byte per table into the
+ * last key byte before its lookup, giving Chernoff-style concentration bounds.
+ *
+ * The tables take `8 * TABLE_WORDS` bytes, stored inside the object and aligned on a cache line:
+ * 2 KiB for 8-bit keys, 8 KiB for 32-bit keys and 16 KiB (simple) or 30 KiB (twisted) for 64-bit
+ * keys, so they stay resident in L1 or L2. Each table entry of the twisted variant keeps its hash
+ * and twist words side by side, so one lookup touches one cache line.
+ *
+ * The tables can be filled from any engine at runtime, or given as an array, for example produced
+ * at compile time by `bpr::ct::random_array()`.
+ *
+ * @tparam Key The unsigned integral type of the keys.
+ * @tparam Variant Simple or twisted tabulation.
+ *
+ * @example
+ * ```cpp
+ * bpr::prng::Xoshiro256ss engine(42);
+ * bpr::TabulationHash<uint64_t> hash(engine);
+ * uint64_t h = hash(key);
+ *
+ * // Tables generated at compile time (C++20)
+ * using Hash = bpr::TabulationHash<uint32_t, bpr::Tabulation::Twisted>;
+ * constexpr Hash fixed = Hash::from_table(bpr::ct::random_array<uint64_t, Hash::TABLE_WORDS, 7>());
+ * ```
+ */
+template <typename Key, Tabulation Variant = Tabulation::Simple>
+class TabulationHash
+{
+    static_assert(std::is_integral_v<Key> && std::is_unsigned_v<Key>, "Key must be an unsigned integral type");
+
+public:
+    static constexpr size_t CHARS = sizeof(Key);
+    static constexpr size_t TABLE_WORDS = Variant == Tabulation::Simple ? CHARS * 256 : (CHARS - 1) * 512 + 256;
+
+    /**
+     * @brief Fills the tables with the bulk output of the engine.
+     */
+    template <typename Engine>
+    explicit TabulationHash(Engine& e) noexcept {
+        static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+        fill(e, m_table, TABLE_WORDS);
+    }
+
+    /**
+     * @brief Creates a hash function from the words of its tables.
+     */
+    static constexpr TabulationHash from_table(const std::array<uint64_t, TABLE_WORDS>& words) noexcept {
+        TabulationHash hash;
+        for (size_t i = 0; i < TABLE_WORDS; ++i) {
+            hash.m_table[i] = words[i];
+        }
+        return hash;
+    }
+
+    /**
+     * @brief Hashes one key.
+     */
+    constexpr uint64_t operator()(Key key) const noexcept {
+        const uint64_t k = static_cast<uint64_t>(key);
+        uint64_t h = 0;
+        if constexpr (Variant == Tabulation::Simple) {
+            for (size_t i = 0; i < CHARS; ++i) {
+                h ^= m_table[i * 256 + ((k >> (8 * i)) & 0xFF)];
+            }
+        } else {
+            uint64_t twist = 0;
+            for (size_t i = 0; i + 1 < CHARS; ++i) {
+                const size_t index = 2 * (i * 256 + ((k >> (8 * i)) & 0xFF));
+                h ^= m_table[index];
+                twist ^= m_table[index + 1];
+            }
+            const uint64_t last = ((k >> (8 * (CHARS - 1))) ^ twist) & 0xFF;
+            h ^= m_table[(CHARS - 1) * 512 + last];
+        }
+        return h;
+    }
+
+    /**
+     * @brief Hashes `count` keys into `out`.
+     *
+     * When compiled with AVX2, four keys are hashed at a time with one gather instruction per key
+     * byte (two for the twisted variant), replacing four dependent scalar lookups. Otherwise the
+     * scalar lookups of consecutive keys are independent and overlap in the pipeline.
+     */
+    void hash(const Key* keys, uint64_t* out, size_t count) const noexcept {
+        size_t i = 0;
+#if defined(__AVX2__)
+        for (const size_t end = count & ~size_t(3); i < end; i += 4) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), hash4(load4(keys + i)));
+        }
+#endif
+        for (; i < count; ++i) {
+            out[i] = (*this)(keys[i]);
+        }
+    }
+
+private:
+    constexpr TabulationHash() noexcept = default;
+
+#if defined(__AVX2__)
+    /**
+     * @brief Loads four keys zero-extended to 64-bit lanes.
+     */
+    static __m256i load4(const Key* keys) noexcept {
+        if constexpr (CHARS == 8) {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys));
+        } else if constexpr (CHARS == 4) {
+            return _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys)));
+        } else if constexpr (CHARS == 2) {
+            return _mm256_cvtepu16_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(keys)));
+        } else {
+            int32_t packed;
+            std::memcpy(&packed, keys, sizeof(packed));
+            return _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(packed));
+        }
+    }
+
+    __m256i hash4(__m256i k) const noexcept {
+        const long long* table = reinterpret_cast<const long long*>(m_table);
+        const __m256i byte_mask = _mm256_set1_epi64x(0xFF);
+        __m256i h = _mm256_setzero_si256();
+
+        if constexpr (Variant == Tabulation::Simple) {
+            for (size_t i = 0; i < CHARS; ++i) {
+                const __m256i byte = _mm256_and_si256(_mm256_srli_epi64(k, static_cast<int>(8 * i)), byte_mask);
+                const __m256i index = _mm256_add_epi64(byte, _mm256_set1_epi64x(static_cast<long long>(i * 256)));
+                h = _mm256_xor_si256(h, _mm256_i64gather_epi64(table, index, 8));
+            }
+        } else {
+            __m256i twist = _mm256_setzero_si256();
+            for (size_t i = 0; i + 1 < CHARS; ++i) {
+                const __m256i byte = _mm256_and_si256(_mm256_srli_epi64(k, static_cast<int>(8 * i)), byte_mask);
+                const __m256i index = _mm256_slli_epi64(
+                    _mm256_add_epi64(byte, _mm256_set1_epi64x(static_cast<long long>(i * 256))), 1);
+                h = _mm256_xor_si256(h, _mm256_i64gather_epi64(table, index, 8));
+                twist = _mm256_xor_si256(twist, _mm256_i64gather_epi64(table + 1, index, 8));
+            }
+            const __m256i last = _mm256_and_si256(
+                _mm256_xor_si256(_mm256_srli_epi64(k, static_cast<int>(8 * (CHARS - 1))), twist), byte_mask);
+            h = _mm256_xor_si256(h, _mm256_i64gather_epi64(table + (CHARS - 1) * 512, last, 8));
+        }
+        return h;
+    }
+#endif
+
+private:
+    alignas(64) uint64_t m_table[TABLE_WORDS] = {};
+};
+
+} // namespace bpr
+
+#endif // BPR_TABULATION_HPP
@@ -22,6 +22,8 @@
 
 #include <type_traits>
 #include <cstdint>
+#include <cstddef>
+#include <cstring>
 
 namespace bpr {
 
@@ -111,6 +113,138 @@ constexpr uint64_t splitmix64(uint64_t seed) noexcept
     return z ^ (z >> 31);                       // Final mixing step, returning the result
 }
 
+/**
+ * @brief Computes the full 128-bit product of two 64-bit unsigned integers.
+ * 
+ * The high half of the product is returned and the low half is written to `lo`.
+ * This is the building block of multiply-shift range reduction (Lemire's method), which maps
+ * a 64-bit random word onto `[0, range)` without any division.
+ * 
+ * On compilers providing `__uint128_t` the native wide multiplication is used, otherwise the
+ * product is assembled from four 32-bit partial products.
+ * 
+ * @param a The first factor.
+ * @param b The second factor.
+ * @param lo Receives the low 64 bits of the product.
+ * @return The high 64 bits of the product.
+ */
+constexpr uint64_t mul128(uint64_t a, uint64_t b, uint64_t& lo) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+    const __uint128_t product = static_cast<__uint128_t>(a) * b;
+    lo = static_cast<uint64_t>(product);
+    return static_cast<uint64_t>(product >> 64);
+#else
+    const uint64_t a_lo = a & 0xFFFFFFFF, a_hi = a >> 32;
+    const uint64_t b_lo = b & 0xFFFFFFFF, b_hi = b >> 32;
+    const uint64_t p0 = a_lo * b_lo;
+    const uint64_t p1 = a_lo * b_hi;
+    const uint64_t p2 = a_hi * b_lo;
+    const uint64_t p3 = a_hi * b_hi;
+    // Sum of the middle terms with the carry out of the low word
+    const uint64_t mid = (p0 >> 32) + (p1 & 0xFFFFFFFF) + (p2 & 0xFFFFFFFF);
+    lo = (mid << 32) | (p0 & 0xFFFFFFFF);
+    return p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+#endif
+}
+
+/**
+ * @brief True for the 128-bit integer types of the compiler (`__int128_t` and `__uint128_t`).
+ *
+ * `std::is_integral` only recognizes them in the GNU dialects of C++ (`-std=gnu++17`), so they
+ * are detected explicitly. Always false on compilers without 128-bit integers.
+ */
+template <typename T>
+constexpr bool is_int128_v =
+#if defined(__SIZEOF_INT128__)
+    std::is_same_v<std::remove_cv_t<T>, __int128_t> || std::is_same_v<std::remove_cv_t<T>, __uint128_t>;
+#else
+    false;
+#endif
+
+#if defined(__SIZEOF_INT128__)
+
+/**
+ * @brief Computes the full 256-bit product of two 128-bit unsigned integers.
+ *
+ * The high half of the product is returned and the low half is written to `lo`. This extends
+ * the multiply-shift range reduction of `mul128()` to 128-bit ranges.
+ *
+ * @param a The first factor.
+ * @param b The second factor.
+ * @param lo Receives the low 128 bits of the product.
+ * @return The high 128 bits of the product.
+ */
+constexpr __uint128_t mul256(__uint128_t a, __uint128_t b, __uint128_t& lo) noexcept
+{
+    using u128 = __uint128_t;
+    const uint64_t a_lo = static_cast<uint64_t>(a), a_hi = static_cast<uint64_t>(a >> 64);
+    const uint64_t b_lo = static_cast<uint64_t>(b), b_hi = static_cast<uint64_t>(b >> 64);
+    const u128 p0 = static_cast<u128>(a_lo) * b_lo;
+    const u128 p1 = static_cast<u128>(a_lo) * b_hi;
+    const u128 p2 = static_cast<u128>(a_hi) * b_lo;
+    const u128 p3 = static_cast<u128>(a_hi) * b_hi;
+    // Sum of the middle terms with the carry out of the low word, below 3 * 2^64
+    const u128 mid = (p0 >> 64) + static_cast<uint64_t>(p1) + static_cast<uint64_t>(p2);
+    lo = (mid << 64) | static_cast<uint64_t>(p0);
+    return p3 + (p1 >> 64) + (p2 >> 64) + (mid >> 64);
+}
+
+#endif
+
+/**
+ * @brief Derives the seed of an independent sub-stream from a master seed.
+ * 
+ * Parallel algorithms of this library split their work into tiles (replicates, chunks, blocks...)
+ * and give each tile its own engine seeded with `stream_seed(seed, tile_index)`. Because the
+ * sub-stream only depends on the master seed and the tile index, results are identical whatever
+ * the number of threads used or the order in which the tiles are processed.
+ * 
+ * @param seed The master seed.
+ * @param stream The index of the sub-stream.
+ * @return A 64-bit seed for the requested sub-stream.
+ */
+constexpr uint64_t stream_seed(uint64_t seed, uint64_t stream) noexcept
+{
+    return splitmix64(seed ^ splitmix64(stream));
+}
+
+/**
+ * @brief Returns output number `index` of the SplitMix64 sequence started from `seed`, in O(1).
+ * 
+ * SplitMix64 advances its state by a constant and mixes it, so any position of its sequence can
+ * be computed directly. This makes it a counter-based generator: algorithms that need to
+ * regenerate the same random values on demand (instead of storing them) address them by index.
+ * 
+ * @param seed The seed of the sequence.
+ * @param index The position in the sequence, starting at 0.
+ * @return The same value as the `index + 1`-th call to a SplitMix64 generator seeded with `seed`.
+ */
+constexpr uint64_t splitmix64_at(uint64_t seed, uint64_t index) noexcept
+{
+    return splitmix64(seed + index * 0x9e3779b97f4a7c15);
+}
+
+/**
+ * @brief Overwrites a memory area with zeros, in a way the compiler cannot optimize away.
+ * 
+ * Used to erase keys and generated output that must not survive in memory once consumed.
+ * 
+ * @param data Pointer to the memory area to erase.
+ * @param size The size of the area in bytes.
+ */
+inline void secure_zero(void* data, size_t size) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    // The empty asm statement makes the compiler assume the zeroed memory is read
+    std::memset(data, 0, size);
+    __asm__ __volatile__("" : : "r"(data) : "memory");
+#else
+    volatile unsigned char* p = static_cast<volatile unsigned char*>(data);
+    while (size--) *p++ = 0;
+#endif
+}
+
 } // namespace bpr
 
 #endif // BPR_UTILS_HPP
@@ -0,0 +1,402 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_VIEWS_HPP
+#define BPR_VIEWS_HPP
+
+// Ranges and coroutines need C++20, the header is empty otherwise
+#if __cplusplus >= 202002L
+
+#include "distributions.hpp"
+#include "generator.hpp"
+#include "engine.hpp"
+#include "utils.hpp"
+
+#include <type_traits>
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <ranges>
+
+namespace bpr { namespace views {
+
+namespace detail {
+
+/**
+ * @brief Number of values buffered by the views, the same L1-sized tile as the bulk distributions.
+ */
+inline constexpr size_t VIEW_TILE = ::bpr::detail::DISTRIBUTION_TILE_WORDS;
+
+struct BitsFill
+{
+    template <typename Engine>
+    void operator()(Engine& e, uint64_t* out, size_t count) const noexcept {
+        ::bpr::fill(e, out, count);
+    }
+};
+
+template <typename T>
+struct UniformIntFill
+{
+    T min;
+    uint64_t range;     // Number of values, zero for the full 64-bit range
+
+    template <typename Engine>
+    void operator()(Engine& e, T* out, size_t count) const noexcept {
+        uint64_t words[VIEW_TILE];
+        ::bpr::fill(e, words, count);
+        const uint64_t threshold = range ? (0 - range) % range : 0;
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t offset = words[i];
+            if (range != 0) {
+                // Lemire's reduction, the rare biased words are redrawn with `bounded()`
+                uint64_t lo;
+                offset = mul128(words[i], range, lo);
+                if (lo < threshold) offset = bounded(e, range);
+            }
+            using U = std::make_unsigned_t<T>;
+            out[i] = static_cast<T>(static_cast<U>(min) + static_cast<U>(offset));
+        }
+    }
+};
+
+template <typename T>
+struct UniformRealFill
+{
+    T min;
+    T range;
+
+    template <typename Engine>
+    void operator()(Engine& e, T* out, size_t count) const noexcept {
+        uint64_t words[VIEW_TILE];
+        ::bpr::fill(e, words, count);
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = min + range * ::bpr::detail::unit_closed_open<T>(words[i]);
+        }
+    }
+};
+
+template <typename T>
+struct NormalFill
+{
+    T mean;
+    T stddev;
+
+    template <typename Engine>
+    void operator()(Engine& e, T* out, size_t count) const noexcept {
+        fill_normal(e, out, count, mean, stddev);
+    }
+};
+
+template <typename T>
+struct ExponentialFill
+{
+    T rate;
+
+    template <typename Engine>
+    void operator()(Engine& e, T* out, size_t count) const noexcept {
+        fill_exponential(e, out, count, rate);
+    }
+};
+
+} // namespace detail
+
+/**
+ * @class BufferedView
+ * @brief An infinite input view of random values, generated one tile at a time.
+ *
+ * The view keeps an L1-sized buffer that `Fill` refills through the bulk path of the engine,
+ * so iterating costs a load and an increment per element instead of a virtual `next()` call.
+ * Values come from the engine referenced by the view: two views over the same engine interleave
+ * their draws tile by tile. Like other single-pass views with internal state, the view must stay
+ * in place while it is iterated.
+ *
+ * The views are created by `bits()`, `uniform()`, `normal()` and `exponential()`.
+ */
+template <typename T, typename Engine, typename Fill>
+class BufferedView : public std::ranges::view_interface<BufferedView<T, Engine, Fill>>
+{
+public:
+    class iterator
+    {
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() noexcept = default;
+
+        explicit iterator(BufferedView* view) noexcept
+            : m_view(view)
+        { }
+
+        const T& operator*() const noexcept {
+            return m_view->m_buffer[m_view->m_position];
+        }
+
+        iterator& operator++() noexcept {
+            if (++m_view->m_position == detail::VIEW_TILE) {
+                m_view->refill();
+            }
+            return *this;
+        }
+
+        void operator++(int) noexcept {
+            ++*this;
+        }
+
+        friend bool operator==(const iterator&, std::unreachable_sentinel_t) noexcept {
+            return false;
+        }
+
+    private:
+        BufferedView* m_view = nullptr;
+    };
+
+    BufferedView(Engine& e, Fill fill) noexcept
+        : m_engine(&e), m_fill(std::move(fill))
+    { }
+
+    iterator begin() noexcept {
+        if (m_position == detail::VIEW_TILE) {
+            refill();
+        }
+        return iterator(this);
+    }
+
+    std::unreachable_sentinel_t end() const noexcept {
+        return std::unreachable_sentinel;
+    }
+
+private:
+    void refill() noexcept {
+        m_fill(*m_engine, m_buffer, detail::VIEW_TILE);
+        m_position = 0;
+    }
+
+private:
+    Engine* m_engine;
+    Fill m_fill;
+    T m_buffer[detail::VIEW_TILE];
+    size_t m_position = detail::VIEW_TILE;
+};
+
+/**
+ * @brief Infinite view of raw 64-bit words from the engine.
+ */
+template <typename Engine>
+auto bits(Engine& e) noexcept
+{
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+    return BufferedView<uint64_t, Engine, detail::BitsFill>(e, {});
+}
+
+/**
+ * @brief Infinite view of values uniformly distributed in [min, max] (integers) or [min, max) (floating-point).
+ *
+ * Integers are unbiased (Lemire's method), floating-point values have 53 random bits.
+ *
+ * @example
+ * ```cpp
+ * for (int roll : bpr::views::uniform(engine, 1, 6) | std::views::take(10)) { ... }
+ * ```
+ */
+template <typename T, typename Engine>
+auto uniform(Engine& e, T min, T max) noexcept
+{
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+    static_assert(std::is_integral_v<T> || std::is_floating_point_v<T>, "T must be an integer or a floating point");
+
+    if constexpr (std::is_integral_v<T>) {
+        using U = std::make_unsigned_t<T>;
+        const uint64_t range = static_cast<uint64_t>(static_cast<U>(static_cast<U>(max) - static_cast<U>(min))) + 1;
+        return BufferedView<T, Engine, detail::UniformIntFill<T>>(e, { min, range });
+    } else {
+        return BufferedView<T, Engine, detail::UniformRealFill<T>>(e, { min, max - min });
+    }
+}
+
+/**
+ * @brief Infinite view of normally distributed values, generated with `fill_normal()`.
+ */
+template <typename T = double, typename Engine>
+auto normal(Engine& e, T mean = T(0), T stddev = T(1)) noexcept
+{
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+    static_assert(std::is_floating_point_v<T>, "T must be a floating point");
+    return BufferedView<T, Engine, detail::NormalFill<T>>(e, { mean, stddev });
+}
+
+/**
+ * @brief Infinite view of exponentially distributed values, generated with `fill_exponential()`.
+ */
+template <typename T = double, typename Engine>
+auto exponential(Engine& e, T rate = T(1)) noexcept
+{
+    static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+    static_assert(std::is_floating_point_v<T>, "T must be a floating point");
+    return BufferedView<T, Engine, detail::ExponentialFill<T>>(e, { rate });
+}
+
+/**
+ * @class Generator
+ * @brief A minimal `std::generator`-like coroutine type yielding values of type T.
+ *
+ * Coroutines returning `Generator<T>` can `co_yield` values and are consumed as input ranges.
+ * Combined with `generate()`, this lets random values flow through asynchronous pipelines
+ * written as coroutines, while still being produced in tiles by the views above.
+ */
+template <typename T>
+class Generator : public std::ranges::view_interface<Generator<T>>
+{
+public:
+    struct promise_type
+    {
+        const T* value = nullptr;
+        std::exception_ptr exception;
+
+        Generator get_return_object() noexcept {
+            return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        std::suspend_always final_suspend() const noexcept { return {}; }
+
+        std::suspend_always yield_value(const T& v) noexcept {
+            value = std::addressof(v);
+            return {};
+        }
+
+        void return_void() const noexcept { }
+        void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+        // Generators only yield, awaiting is not supported
+        template <typename U>
+        std::suspend_never await_transform(U&&) = delete;
+    };
+
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    class iterator
+    {
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() noexcept = default;
+
+        explicit iterator(handle_type handle) noexcept
+            : m_handle(handle)
+        { }
+
+        const T& operator*() const noexcept {
+            return *m_handle.promise().value;
+        }
+
+        iterator& operator++() {
+            m_handle.resume();
+            rethrow();
+            return *this;
+        }
+
+        void operator++(int) {
+            ++*this;
+        }
+
+        friend bool operator==(const iterator& it, std::default_sentinel_t) noexcept {
+            return !it.m_handle || it.m_handle.done();
+        }
+
+    private:
+        friend class Generator;
+
+        void rethrow() const {
+            if (m_handle.done() && m_handle.promise().exception) {
+                std::rethrow_exception(m_handle.promise().exception);
+            }
+        }
+
+        handle_type m_handle;
+    };
+
+    Generator(Generator&& other) noexcept
+        : m_handle(std::exchange(other.m_handle, {}))
+    { }
+
+    Generator& operator=(Generator&& other) noexcept {
+        if (this != &other) {
+            if (m_handle) m_handle.destroy();
+            m_handle = std::exchange(other.m_handle, {});
+        }
+        return *this;
+    }
+
+    ~Generator() {
+        if (m_handle) m_handle.destroy();
+    }
+
+    iterator begin() {
+        m_handle.resume();
+        iterator it(m_handle);
+        it.rethrow();
+        return it;
+    }
+
+    std::default_sentinel_t end() const noexcept {
+        return std::default_sentinel;
+    }
+
+private:
+    explicit Generator(handle_type handle) noexcept
+        : m_handle(handle)
+    { }
+
+    handle_type m_handle;
+};
+
+/**
+ * @brief Turns a view (typically one of the random views above) into a coroutine generator.
+ *
+ * The view is moved into the coroutine frame, so the generator owns it and can be passed
+ * around freely, e.g. stored by an asynchronous stage and resumed later.
+ *
+ * @example
+ * ```cpp
+ * bpr::views::Generator<double> noise = bpr::views::generate(bpr::views::normal(engine) | std::views::take(1000));
+ * for (double x : noise) { ... }
+ * ```
+ */
+template <std::ranges::input_range View>
+Generator<std::ranges::range_value_t<View>> generate(View view)
+{
+    for (auto&& value : view) {
+        const std::ranges::range_value_t<View> copy = value;
+        co_yield copy;
+    }
+}
+
+}} // namespace bpr::views
+
+#endif // __cplusplus >= 202002L
+
+#endif // BPR_VIEWS_HPP
@@ -0,0 +1,348 @@
+/**
+ * Copyright (c) 2024 Le Juez Victor
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef BPR_WALK_HPP
+#define BPR_WALK_HPP
+
+#include "generator.hpp"
+#include "sampling.hpp"
+#include "parallel.hpp"
+#include "engine.hpp"
+#include "utils.hpp"
+#include "prng.hpp"
+
+#include <type_traits>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace bpr {
+
+namespace detail {
+
+inline void prefetch(const void* address) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+}
+
+/**
+ * @brief Serves the words of an engine one by one from a tile filled through its bulk path.
+ */
+template <typename Engine>
+class WordBuffer
+{
+public:
+    static constexpr size_t SIZE = 256;
+
+    explicit WordBuffer(uint64_t seed) noexcept
+        : m_engine(seed)
+    { }
+
+    uint64_t next() noexcept {
+        if (m_position == SIZE) {
+            fill(m_engine, m_words, SIZE);
+            m_position = 0;
+        }
+        return m_words[m_position++];
+    }
+
+private:
+    Engine m_engine;
+    uint64_t m_words[SIZE];
+    size_t m_position = SIZE;
+};
+
+} // namespace detail
+
+/**
+ * @class RandomWalker
+ * @brief Random walks on a graph, or trajectories of a Markov chain, stored in CSR form.
+ *
+ * The graph is given by `offsets` (node_count + 1 entries) and `targets`: the neighbors (or the
+ * possible next states) of node `v` are `targets[offsets[v]]` to `targets[offsets[v + 1] - 1]`.
+ * With weights (or transition probabilities, the rows of a sparse transition matrix), each
+ * neighbor list gets its own alias table, built in parallel in O(edges), so a step costs one
+ * random word and at most two memory accesses in the list instead of a scan of the cumulative
+ * weights. Unweighted steps pick a neighbor with Lemire's reduction.
+ *
+ * `walk()` advances blocks of `BATCH` walkers in lockstep. When a walker reaches its next node, the
+ * row offsets of that node are prefetched; in a second pass over the block, the random position
+ * in each neighbor list is drawn and its target and alias entry are prefetched. The memory
+ * latency of one walker is hidden behind the work on the others, which matters on graphs much
+ * larger than the caches, where every step would otherwise be two or three cache misses.
+ *
+ * Second-order (node2vec) walks with return parameter `p` and in-out parameter `q` are sampled by
+ * rejection: a candidate `x` drawn from the first-order table of the current node `v`, coming from
+ * `t`, is accepted with probability `alpha(t, x) / max(alpha)`, where alpha is `1 / p` if `x == t`,
+ * 1 if `x` is a neighbor of `t` and `1 / q` otherwise. No per-edge second-order table is needed.
+ * Neighbor tests use a binary search when the neighbor lists are sorted, a linear scan otherwise.
+ *
+ * The walker keeps pointers to `offsets` and `targets`, which must outlive it; the alias tables
+ * (8 bytes per edge with 32-bit indices) are owned.
+ *
+ * @tparam Index The unsigned integer type of node ids.
+ *
+ * @example
+ * ```cpp
+ * bpr::RandomWalker<uint32_t> walker(offsets.data(), targets.data(), node_count, weights.data());
+ * std::vector<uint32_t> walks(starts.size() * 80);
+ * walker.walk(seed, starts.data(), starts.size(), 80, walks.data());
+ * ```
+ */
+template <typename Index = uint32_t>
+class RandomWalker
+{
+public:
+    static_assert(std::is_unsigned_v<Index>, "Index must be an unsigned integer");
+
+    static constexpr size_t BATCH = 64;                 // Walkers advanced in lockstep, and per random stream
+    static constexpr Index END = static_cast<Index>(~Index(0));     // Fills the rest of a walk stuck on a node without neighbors
+
+    /**
+     * @brief Prepares walks on an unweighted graph.
+     */
+    RandomWalker(const uint64_t* offsets, const Index* targets, size_t node_count) noexcept
+        : m_offsets(offsets), m_targets(targets), m_node_count(node_count)
+    {
+        m_sorted = check_sorted();
+    }
+
+    /**
+     * @brief Prepares walks on a weighted graph, building the alias table of every node.
+     *
+     * @param weights One non-negative weight per edge, aligned with `targets`. A node whose weights are all zero is left uniform.
+     * @param thread_count The number of threads to use, or zero to use every hardware thread.
+     */
+    template <typename Weight>
+    RandomWalker(const uint64_t* offsets, const Index* targets, size_t node_count,
+                 const Weight* weights, unsigned thread_count = 0)
+        : RandomWalker(offsets, targets, node_count)
+    {
+        m_alias.resize(offsets[node_count]);
+
+        constexpr size_t NODES_PER_TASK = 4096;
+        const size_t tasks = (node_count + NODES_PER_TASK - 1) / NODES_PER_TASK;
+        parallel_for(tasks, [&](size_t task, unsigned) {
+            std::vector<double> scaled;
+            std::vector<Index> small, large;
+            const size_t last = std::min(node_count, (task + 1) * NODES_PER_TASK);
+            for (size_t v = task * NODES_PER_TASK; v < last; ++v) {
+                const uint64_t begin = offsets[v];
+                detail::build_alias(weights + begin, offsets[v + 1] - begin, m_alias.data() + begin, scaled, small, large);
+            }
+        }, thread_count);
+    }
+
+    size_t node_count() const noexcept { return m_node_count; }
+    bool weighted() const noexcept { return !m_alias.empty(); }
+
+    /**
+     * @brief Draws the successor of `node`, or returns END if it has no neighbor.
+     */
+    template <typename Engine>
+    Index next(Engine& e, Index node) const noexcept {
+        const uint64_t begin = m_offsets[node];
+        const uint64_t degree = m_offsets[node + 1] - begin;
+        return degree ? m_targets[begin + pick(begin, degree, e.next())] : END;
+    }
+
+    /**
+     * @brief Generates `walk_count` walks of `walk_length` nodes (the start node included).
+     *
+     * Walk `i` starts at `starts[i]` and is written to `out[i * walk_length]` to
+     * `out[(i + 1) * walk_length - 1]`. Blocks of BATCH walks are distributed over the threads,
+     * block `b` drawing from an engine seeded with `stream_seed(seed, b)`, so the walks do not
+     * depend on the number of threads.
+     *
+     * @param p The node2vec return parameter. With `p == q == 1` (the default), walks are first-order.
+     * @param q The node2vec in-out parameter.
+     */
+    template <typename Engine = prng::Xoshiro256ss>
+    void walk(uint64_t seed, const Index* starts, size_t walk_count, size_t walk_length, Index* out,
+              double p = 1.0, double q = 1.0, unsigned thread_count = 0) const
+    {
+        // Assert that the Engine type is valid (derived from IEngine)
+        static_assert(EngineTraits<Engine>::is_valid_engine, "EngineType must be derived from IEngine");
+
+        if (walk_length == 0) return;
+        const size_t blocks = (walk_count + BATCH - 1) / BATCH;
+        parallel_for(blocks, [&](size_t block, unsigned) {
+            const size_t first = block * BATCH;
+            const size_t n = std::min(BATCH, walk_count - first);
+            detail::WordBuffer<Engine> words(stream_seed(seed, block));
+            if (p == 1.0 && q == 1.0) {
+                walk_block(words, starts + first, n, walk_length, out + first * walk_length);
+            } else {
+                walk_block_node2vec(words, starts + first, n, walk_length, out + first * walk_length, p, q);
+            }
+        }, thread_count);
+    }
+
+private:
+    /**
+     * @brief Position, in the neighbor list starting at `begin`, of the neighbor selected by `word`.
+     */
+    size_t pick(uint64_t begin, uint64_t degree, uint64_t word) const noexcept {
+        if (m_alias.empty()) {
+            uint64_t lo;
+            return static_cast<size_t>(mul128(word, degree, lo));
+        }
+        return detail::alias_sample(m_alias.data() + begin, degree, word);
+    }
+
+    template <typename Engine>
+    void walk_block(detail::WordBuffer<Engine>& words, const Index* starts, size_t n,
+                    size_t length, Index* out) const noexcept
+    {
+        Index current[BATCH];
+        uint64_t word[BATCH];
+
+        for (size_t w = 0; w < n; ++w) {
+            current[w] = starts[w];
+            out[w * length] = starts[w];
+        }
+
+        for (size_t step = 1; step < length; ++step) {
+            // Draw the position of every walker in its neighbor list and prefetch what the step reads
+            for (size_t w = 0; w < n; ++w) {
+                word[w] = words.next();
+                if (current[w] == END) continue;
+                const uint64_t begin = m_offsets[current[w]];
+                const uint64_t degree = m_offsets[current[w] + 1] - begin;
+                uint64_t lo;
+                const uint64_t column = mul128(word[w], degree, lo);
+                detail::prefetch(m_targets + begin + column);
+                if (!m_alias.empty()) detail::prefetch(m_alias.data() + begin + column);
+            }
+
+            // Take the step, and prefetch the row offsets of the nodes reached
+            for (size_t w = 0; w < n; ++w) {
+                const Index node = current[w];
+                Index next = END;
+                if (node != END) {
+                    const uint64_t begin = m_offsets[node];
+                    const uint64_t degree = m_offsets[node + 1] - begin;
+                    if (degree) next = m_targets[begin + pick(begin, degree, word[w])];
+                }
+                if (next != END) detail::prefetch(m_offsets + next);
+                current[w] = next;
+                out[w * length + step] = next;
+            }
+        }
+    }
+
+    template <typename Engine>
+    void walk_block_node2vec(detail::WordBuffer<Engine>& words, const Index* starts, size_t n,
+                             size_t length, Index* out, double p, double q) const noexcept
+    {
+        // Acceptance thresholds of the three cases, scaled to 2^32
+        const double inv_p = 1.0 / p, inv_q = 1.0 / q;
+        const double max_alpha = std::max({ inv_p, 1.0, inv_q });
+        const uint64_t accept_return = to_threshold(inv_p / max_alpha);
+        const uint64_t accept_near = to_threshold(1.0 / max_alpha);
+        const uint64_t accept_far = to_threshold(inv_q / max_alpha);
+
+        Index current[BATCH];
+        Index previous[BATCH];
+        uint64_t word[BATCH];
+
+        for (size_t w = 0; w < n; ++w) {
+            current[w] = starts[w];
+            previous[w] = END;
+            out[w * length] = starts[w];
+        }
+
+        for (size_t step = 1; step < length; ++step) {
+            // Draw the first candidate of every walker, prefetch it and the neighbor list it is tested against
+            for (size_t w = 0; w < n; ++w) {
+                word[w] = words.next();
+                if (current[w] == END) continue;
+                const uint64_t begin = m_offsets[current[w]];
+                const uint64_t degree = m_offsets[current[w] + 1] - begin;
+                uint64_t lo;
+                const uint64_t column = mul128(word[w], degree, lo);
+                detail::prefetch(m_targets + begin + column);
+                if (!m_alias.empty()) detail::prefetch(m_alias.data() + begin + column);
+                if (previous[w] != END) detail::prefetch(m_targets + m_offsets[previous[w]]);
+            }
+
+            for (size_t w = 0; w < n; ++w) {
+                const Index node = current[w];
+                Index next = END;
+                if (node != END) {
+                    const uint64_t begin = m_offsets[node];
+                    const uint64_t degree = m_offsets[node + 1] - begin;
+                    if (degree && previous[w] == END) {
+                        // The first step has no previous node
+                        next = m_targets[begin + pick(begin, degree, word[w])];
+                    } else if (degree) {
+                        const Index t = previous[w];
+                        uint64_t candidate = word[w];
+                        for (;;) {
+                            const Index x = m_targets[begin + pick(begin, degree, candidate)];
+                            const uint64_t threshold = x == t ? accept_return : (has_edge(t, x) ? accept_near : accept_far);
+                            if ((words.next() >> 32) < threshold) {
+                                next = x;
+                                break;
+                            }
+                            candidate = words.next();
+                        }
+                    }
+                }
+                if (next != END) detail::prefetch(m_offsets + next);
+                previous[w] = node;
+                current[w] = next;
+                out[w * length + step] = next;
+            }
+        }
+    }
+
+    static uint64_t to_threshold(double probability) noexcept {
+        return static_cast<uint64_t>(std::min(1.0, probability) * 4294967296.0);
+    }
+
+    bool has_edge(Index from, Index to) const noexcept {
+        const Index* first = m_targets + m_offsets[from];
+        const Index* last = m_targets + m_offsets[from + 1];
+        return m_sorted ? std::binary_search(first, last, to) : std::find(first, last, to) != last;
+    }
+
+    bool check_sorted() const noexcept {
+        for (size_t v = 0; v < m_node_count; ++v) {
+            if (!std::is_sorted(m_targets + m_offsets[v], m_targets + m_offsets[v + 1])) return false;
+        }
+        return true;
+    }
+
+private:
+    const uint64_t* m_offsets;
+    const Index* m_targets;
+    size_t m_node_count;
+    bool m_sorted = true;
+    std::vector<detail::AliasEntry<Index>> m_alias;
+};
+
+} // namespace bpr
+
+#endif // BPR_WALK_HPP
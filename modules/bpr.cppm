@@ -0,0 +1,209 @@
+// C++20 module interface of the library: `import bpr;` instead of `#include <BPR/BPR.hpp>`.
+//
+// The module is built from the headers, which stay the reference, and exports the public names
+// of `BPR.hpp`; `detail` namespaces and macros are not exported (`randd.hpp`, Linux only, is not
+// part of `BPR.hpp`). The names are exported with using-declarations, like the `std` module,
+// which needs GCC 14, Clang 16, MSVC 17.5 or later. Module support differs between build
+// systems; by hand:
+//
+// Build: g++ -std=c++20 -fmodules-ts -O2 -Iinclude -c modules/bpr.cppm -o bpr.o
+//        clang++ -std=c++20 -O2 -Iinclude --precompile -x c++-module modules/bpr.cppm -o bpr.pcm
+
+module;
+
+#include <BPR/BPR.hpp>
+
+export module bpr;
+
+export namespace bpr {
+
+// Engines and generation (engine.hpp, generator.hpp, sequence.hpp, utils.hpp)
+using bpr::IEngine;
+using bpr::EngineTraits;
+using bpr::is_seed_source_v;
+using bpr::rand;
+using bpr::bounded;
+using bpr::fill;
+using bpr::sequence;
+using bpr::always_false;
+using bpr::compile_time;
+using bpr::rotl;
+using bpr::splitmix64;
+using bpr::splitmix64_at;
+using bpr::stream_seed;
+using bpr::mul128;
+using bpr::is_int128_v;
+using bpr::secure_zero;
+#if defined(__SIZEOF_INT128__)
+using bpr::bounded128;
+using bpr::mul256;
+#endif
+
+// Distributions and sampling (distributions.hpp, sampling.hpp, permutation.hpp, tabulation.hpp)
+using bpr::normal;
+using bpr::fill_normal;
+using bpr::exponential;
+using bpr::fill_exponential;
+using bpr::poisson;
+using bpr::Zipf;
+using bpr::AliasTable;
+using bpr::SumTree;
+using bpr::FeistelPermutation;
+using bpr::UniqueStream;
+using bpr::unique_stream;
+using bpr::Tabulation;
+using bpr::TabulationHash;
+
+// Wide integers and primes (bigint.hpp)
+#if defined(__SIZEOF_INT128__)
+using bpr::random_bits;
+using bpr::uniform_mod;
+using bpr::is_probable_prime;
+using bpr::random_prime;
+#endif
+
+// Simulation and statistics (arrivals.hpp, bootstrap.hpp, brownian.hpp, resampling.hpp, walk.hpp)
+using bpr::PoissonProcess;
+using bpr::ThinnedPoissonProcess;
+using bpr::HawkesProcess;
+using bpr::arrival_times;
+using bpr::BootstrapMethod;
+using bpr::bootstrap;
+using bpr::PathLayout;
+using bpr::brownian_paths;
+using bpr::BrownianBridge;
+using bpr::systematic_resample;
+using bpr::stratified_resample;
+using bpr::residual_resample;
+using bpr::metropolis_resample;
+using bpr::RandomWalker;
+
+// Numerics and signals (noise.hpp, projection.hpp, rounding.hpp)
+using bpr::int24;
+using bpr::WhiteNoise;
+using bpr::PinkNoise;
+using bpr::BrownNoise;
+using bpr::tpdf_dither;
+using bpr::ProjectionKind;
+using bpr::RandomProjection;
+using bpr::bfloat16;
+using bpr::to_bfloat16;
+using bpr::to_float;
+using bpr::stochastic_round_bf16;
+using bpr::stochastic_round_fp16;
+using bpr::stochastic_round_fp8_e4m3;
+using bpr::stochastic_round_fp8_e5m2;
+using bpr::stochastic_quantize_int8;
+using bpr::parallel_stochastic_round;
+
+// Entropy, files and threads (entropy.hpp, fill_file.hpp, parallel.hpp)
+using bpr::HardwareEntropy;
+using bpr::ReseedPolicy;
+using bpr::Reseeding;
+using bpr::FillEngine;
+using bpr::FillFileOptions;
+using bpr::fill_file;
+using bpr::thread_count_for;
+using bpr::parallel_for;
+
+} // namespace bpr
+
+export namespace bpr::prng {
+using bpr::prng::Xoroshiro128p;
+using bpr::prng::Xoroshiro128pp;
+using bpr::prng::Xoroshiro128ss;
+using bpr::prng::Xoshiro256p;
+using bpr::prng::Xoshiro256pp;
+using bpr::prng::Xoshiro256ss;
+using bpr::prng::Xoshiro256ssX8;
+using bpr::prng::PCG32;
+} // namespace bpr::prng
+
+export namespace bpr::csprng {
+using bpr::csprng::ChaCha20;
+using bpr::csprng::BufferedChaCha20;
+using bpr::csprng::AESCTR;
+} // namespace bpr::csprng
+
+export namespace bpr::simd {
+using bpr::simd::Backend;
+using bpr::simd::name;
+using bpr::simd::supported;
+using bpr::simd::best_backend;
+using bpr::simd::backend;
+using bpr::simd::set_backend;
+using bpr::simd::chacha20_blocks;
+using bpr::simd::xoshiro256ss_x8;
+} // namespace bpr::simd
+
+export namespace bpr::repro {
+using bpr::repro::to_uniform;
+using bpr::repro::to_uniform_int;
+using bpr::repro::to_normal;
+using bpr::repro::to_exponential;
+using bpr::repro::uniform;
+using bpr::repro::uniform_int;
+using bpr::repro::normal;
+using bpr::repro::exponential;
+using bpr::repro::fill_uniform;
+using bpr::repro::fill_uniform_int;
+using bpr::repro::fill_normal;
+using bpr::repro::fill_exponential;
+} // namespace bpr::repro
+
+export namespace bpr::init {
+using bpr::init::uniform;
+using bpr::init::normal;
+using bpr::init::truncated_normal;
+using bpr::init::xavier_uniform;
+using bpr::init::xavier_normal;
+using bpr::init::he_uniform;
+using bpr::init::he_normal;
+using bpr::init::orthogonal;
+} // namespace bpr::init
+
+export namespace bpr::graph {
+using bpr::graph::Edge;
+using bpr::graph::ErdosRenyi;
+using bpr::graph::ChungLu;
+using bpr::graph::RMAT;
+using bpr::graph::BarabasiAlbert;
+using bpr::graph::generate_edges;
+using bpr::graph::write_edges;
+} // namespace bpr::graph
+
+export namespace bpr::ssa {
+using bpr::ssa::Term;
+using bpr::ssa::Network;
+using bpr::ssa::DirectMethod;
+using bpr::ssa::NextReactionMethod;
+using bpr::ssa::TauLeaping;
+using bpr::ssa::run_trajectories;
+} // namespace bpr::ssa
+
+export namespace bpr::datagen {
+using bpr::datagen::ColumnType;
+using bpr::datagen::ColumnKind;
+using bpr::datagen::Column;
+using bpr::datagen::Schema;
+using bpr::datagen::ColumnData;
+using bpr::datagen::Chunk;
+using bpr::datagen::Format;
+using bpr::datagen::Generator;
+} // namespace bpr::datagen
+
+export namespace bpr::views {
+using bpr::views::BufferedView;
+using bpr::views::Generator;
+using bpr::views::bits;
+using bpr::views::uniform;
+using bpr::views::normal;
+using bpr::views::exponential;
+using bpr::views::generate;
+} // namespace bpr::views
+
+export namespace bpr::ct {
+using bpr::ct::random_array;
+using bpr::ct::shuffle;
+using bpr::ct::permutation;
+} // namespace bpr::ct
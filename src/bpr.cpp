@@ -0,0 +1,15 @@
+// Out-of-line definitions of the library, for builds that define `BPR_SEPARATE_COMPILATION`.
+//
+// By default every function of BPR is inline and this file is not needed. Defining
+// `BPR_SEPARATE_COMPILATION` in every translation unit of a program keeps the heaviest
+// definitions (the SIMD kernels and `<immintrin.h>`) out of the headers; this file must then be
+// compiled once, with the same definition, and linked into the program:
+//
+// Build: c++ -std=c++17 -O2 -DBPR_SEPARATE_COMPILATION -Iinclude -c src/bpr.cpp -o bpr.o
+
+#if !defined(BPR_SEPARATE_COMPILATION)
+#   error "src/bpr.cpp is only needed, and must only be compiled, with BPR_SEPARATE_COMPILATION"
+#endif
+
+#define BPR_IMPLEMENTATION
+#include <BPR/simd.hpp>
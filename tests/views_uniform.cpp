@@ -0,0 +1,90 @@
+// Checks that `bpr::views::uniform` draws unbiased integers from ranges close to 2^64, where
+// Lemire's reduction rejects the largest share of words.
+//
+//   views_uniform [--draws N]
+//
+// Each range is a multiple of a small modulus k, from 0.625 * 2^64 to 2^64 - 2^32; the values are
+// reduced modulo k and every residue must appear with frequency 1/k, within 5 standard deviations.
+// Exits with status 1 if any check fails.
+//
+// Build: c++ -std=c++20 -O2 -Iinclude tests/views_uniform.cpp -o views_uniform
+
+#include <BPR/views.hpp>
+#include <BPR/prng.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <vector>
+#include <cmath>
+
+namespace {
+
+struct Case
+{
+    uint64_t max;       // Values are drawn in [0, max]
+    uint64_t modulus;   // Divides max + 1, so every residue is equally likely
+};
+
+/**
+ * Returns the largest deviation of a residue frequency from 1 / modulus, in standard deviations.
+ */
+double residue_deviation(const Case& c, uint64_t draws, uint64_t seed)
+{
+    bpr::prng::Xoshiro256ss engine(seed);
+    std::vector<uint64_t> counts(c.modulus);
+
+    uint64_t n = 0;
+    for (uint64_t value : bpr::views::uniform(engine, uint64_t(0), c.max)) {
+        ++counts[value % c.modulus];
+        if (++n == draws) break;
+    }
+
+    const double p = 1.0 / static_cast<double>(c.modulus);
+    const double sigma = std::sqrt(static_cast<double>(draws) * p * (1.0 - p));
+    double worst = 0.0;
+    for (uint64_t count : counts) {
+        worst = std::fmax(worst, std::fabs(static_cast<double>(count) - static_cast<double>(draws) * p) / sigma);
+    }
+    return worst;
+}
+
+int usage()
+{
+    std::fprintf(stderr, "usage: views_uniform [--draws N]\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    uint64_t draws = 3000000;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--draws") == 0 && i + 1 < argc) {
+            draws = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            return usage();
+        }
+    }
+    if (draws == 0) return usage();
+
+    const Case cases[] = {
+        { 3 * (uint64_t(1) << 62) - 1, 3 },                 // 0.75 * 2^64
+        { 5 * (uint64_t(1) << 61) - 1, 5 },                 // 0.625 * 2^64
+        { UINT64_MAX - (uint64_t(1) << 32), 3 },            // 2^64 - 2^32 = 2^32 * (2^32 - 1), a multiple of 3
+        { 7 * (uint64_t(1) << 61) - 1, 7 },                 // 0.875 * 2^64
+    };
+
+    bool ok = true;
+    uint64_t seed = 1;
+    for (const Case& c : cases) {
+        const double deviation = residue_deviation(c, draws, seed++);
+        const bool pass = deviation < 5.0;
+        std::printf("range %#018llx + 1 mod %llu: worst residue %5.2f sigma %s\n",
+                    static_cast<unsigned long long>(c.max), static_cast<unsigned long long>(c.modulus),
+                    deviation, pass ? "ok" : "BIASED");
+        ok = ok && pass;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,720 @@
+// Measures the throughput and tail latency of the ways an engine can be shared between threads,
+// from 1 thread to every hardware thread, to choose a sharing model from numbers.
+//
+//   bpr_contention [--engine xoshiro|chacha20|all] [--model NAME|all] [--threads N,N,...]
+//                  [--ms N] [--pin none|compact|scatter] [--producers N] [--seed N] [--csv]
+//
+// Sharing models:
+//   mutex          one engine behind a std::mutex
+//   thread_local   a thread_local engine per thread
+//   packed         per-thread engines side by side in one array, sharing cache lines (false sharing)
+//   padded         per-thread engines in one array, each on its own cache lines, allocated by the
+//                  main thread (on its NUMA node)
+//   padded-local   per-thread engines on their own cache lines, allocated and first touched by
+//                  their thread (on its NUMA node)
+//   per-cpu        one engine per CPU behind a spinlock, selected with sched_getcpu()
+//   counter        a shared atomic counter numbers the draws of a counter-based generator:
+//                  splitmix64_at() for xoshiro, the ChaCha20 block of that index for chacha20
+//   ring           background producer threads fill a shared ring of blocks with next(), which
+//                  the threads consume
+//
+// Every word of every model comes from next() (one ChaCha20 block per word, as ChaCha20::next()
+// does), including the words the ring producers write, so the models do the same work per draw
+// and differ only in how they share it. Threads time batches of 128 draws; latencies are
+// reported in ns per draw over those batches, so a lock handoff or a ring stall shows in the
+// tail while the clock overhead stays small. With --pin compact, thread t runs on the t-th
+// allowed CPU; with scatter, threads alternate between NUMA nodes. Placement and per-cpu shards need Linux; elsewhere threads are not pinned and
+// per-cpu shards are selected by thread index.
+//
+// Build: c++ -std=c++17 -O2 -pthread -Iinclude tools/bpr_contention.cpp -o bpr_contention
+
+#include "histogram.hpp"
+
+#include <BPR/generator.hpp>
+#include <BPR/chacha20.hpp>
+#include <BPR/prng.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <cstdio>
+#include <array>
+#include <mutex>
+
+#if defined(__linux__)
+#   include <pthread.h>
+#   include <sched.h>
+#endif
+
+namespace {
+
+using bpr_tools::Histogram;
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t BATCH = 128;           // Draws per latency sample
+constexpr size_t RING_BLOCK = 512;      // Words per block of the prefill ring
+constexpr size_t CACHE_LINE = 128;      // Two lines, against the adjacent-line prefetcher
+
+int usage()
+{
+    std::cerr << "usage: bpr_contention [--engine xoshiro|chacha20|all] [--model NAME|all] [--threads N,N,...]\n"
+                 "                      [--ms N] [--pin none|compact|scatter] [--producers N] [--seed N] [--csv]\n"
+                 "models: mutex thread_local packed padded padded-local per-cpu counter ring\n";
+    return 2;
+}
+
+enum class Pin { None, Compact, Scatter };
+
+struct Options
+{
+    uint64_t seed = 0x5eed;
+    std::chrono::milliseconds duration{ 200 };
+    Pin pin = Pin::Compact;
+    unsigned producers = 1;
+    bool csv = false;
+};
+
+// ----------------------------------------------------------------------------------------------
+// Topology and thread placement
+
+/**
+ * CPUs the process may run on, in the order used to pin threads.
+ */
+struct Topology
+{
+    std::vector<unsigned> compact;      // Allowed CPUs in increasing order
+    std::vector<unsigned> scatter;      // Allowed CPUs alternating between NUMA nodes
+    size_t nodes = 1;
+};
+
+std::vector<unsigned> parse_cpu_list(const std::string& text)
+{
+    // Linux cpulist format, e.g. "0-15,32-47"
+    std::vector<unsigned> cpus;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        char* end = nullptr;
+        const unsigned first = static_cast<unsigned>(std::strtoul(text.c_str() + pos, &end, 10));
+        unsigned last = first;
+        if (*end == '-') last = static_cast<unsigned>(std::strtoul(end + 1, &end, 10));
+        for (unsigned cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        pos = static_cast<size_t>(end - text.c_str());
+        if (pos >= text.size() || text[pos] != ',') break;
+        ++pos;
+    }
+    return cpus;
+}
+
+Topology detect_topology()
+{
+    Topology topology;
+#if defined(__linux__)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+        for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed)) topology.compact.push_back(cpu);
+        }
+    }
+
+    // Node ids can be sparse (node0 and node2), so every id is tried
+    std::vector<std::vector<unsigned>> nodes;
+    size_t widest = 0;
+    for (unsigned node = 0; node < 1024; ++node) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!file) continue;
+        std::string list;
+        std::getline(file, list);
+        std::vector<unsigned> cpus;
+        for (unsigned cpu : parse_cpu_list(list)) {
+            if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+        }
+        widest = std::max(widest, cpus.size());
+        if (!cpus.empty()) nodes.push_back(std::move(cpus));
+    }
+    if (!nodes.empty()) {
+        topology.nodes = nodes.size();
+        for (size_t i = 0; i < widest; ++i) {
+            for (const auto& cpus : nodes) {
+                if (i < cpus.size()) topology.scatter.push_back(cpus[i]);
+            }
+        }
+    }
+#endif
+    if (topology.compact.empty()) {
+        for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu) {
+            topology.compact.push_back(cpu);
+        }
+    }
+    // The nodes may not cover every allowed CPU (offline or hidden nodes): keep the compact order
+    if (topology.scatter.size() != topology.compact.size()) {
+        topology.scatter = topology.compact;
+    }
+    return topology;
+}
+
+void pin_thread(unsigned index, Pin pin, const Topology& topology)
+{
+#if defined(__linux__)
+    if (pin == Pin::None) return;
+    const auto& cpus = pin == Pin::Compact ? topology.compact : topology.scatter;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpus[index % cpus.size()], &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)index; (void)pin; (void)topology;
+#endif
+}
+
+unsigned current_cpu(unsigned thread_index)
+{
+#if defined(__linux__)
+    (void)thread_index;
+    const int cpu = sched_getcpu();
+    return cpu < 0 ? 0 : static_cast<unsigned>(cpu);
+#else
+    return thread_index;
+#endif
+}
+
+// ----------------------------------------------------------------------------------------------
+// Engines
+
+/**
+ * Creates the engine of stream `stream`; streams are independent for both engines.
+ */
+template <typename Engine>
+Engine make_engine(uint64_t seed, uint64_t stream);
+
+template <>
+bpr::prng::Xoshiro256ss make_engine(uint64_t seed, uint64_t stream)
+{
+    return bpr::prng::Xoshiro256ss(bpr::stream_seed(seed, stream));
+}
+
+template <>
+bpr::csprng::ChaCha20 make_engine(uint64_t seed, uint64_t stream)
+{
+    std::array<uint32_t, 8> key;
+    for (size_t i = 0; i < key.size(); ++i) {
+        key[i] = static_cast<uint32_t>(bpr::splitmix64_at(bpr::stream_seed(seed, stream), i));
+    }
+    return bpr::csprng::ChaCha20(key, { 0, 0 });
+}
+
+/**
+ * Draws a word without virtual dispatch, as code holding the concrete engine type does; the
+ * models would otherwise differ by whether the compiler sees the dynamic type of the engine.
+ */
+template <typename Engine>
+inline uint64_t draw_word(Engine& engine)
+{
+    return engine.Engine::next();
+}
+
+/**
+ * Word `index` of the counter-based generator that stands for the engine in the counter model.
+ */
+inline uint64_t counter_word(bpr::prng::Xoshiro256ss&, uint64_t seed, uint64_t index)
+{
+    return bpr::splitmix64_at(seed, index);
+}
+
+inline uint64_t counter_word(bpr::csprng::ChaCha20& engine, uint64_t, uint64_t index)
+{
+    engine.seek(index);
+    return draw_word(engine);
+}
+
+// ----------------------------------------------------------------------------------------------
+// Sharing models
+//
+// A model is set up once per run with `start(threads)`, gives every thread a handle with
+// `local(thread_index)`, whose `draw()` returns a word, and is torn down with `stop()` once the
+// threads have joined.
+
+template <typename Engine>
+struct alignas(CACHE_LINE) Padded
+{
+    explicit Padded(Engine e) : engine(std::move(e)) { }
+    Engine engine;
+};
+
+template <typename Engine>
+class MutexModel
+{
+public:
+    explicit MutexModel(const Options& options) : m_engine(make_engine<Engine>(options.seed, 0)) { }
+
+    void start(unsigned) { }
+    void stop() { }
+
+    struct Local
+    {
+        MutexModel* model;
+        uint64_t draw() {
+            std::lock_guard<std::mutex> lock(model->m_mutex);
+            return draw_word(model->m_engine);
+        }
+    };
+    Local local(unsigned) { return { this }; }
+
+private:
+    std::mutex m_mutex;
+    Engine m_engine;
+};
+
+template <typename Engine>
+class ThreadLocalModel
+{
+public:
+    explicit ThreadLocalModel(const Options& options) : m_seed(options.seed) { }
+
+    void start(unsigned) { }
+    void stop() { }
+
+    struct Local
+    {
+        Engine* engine;
+        uint64_t draw() { return draw_word(*engine); }
+    };
+    Local local(unsigned thread_index) {
+        // Each run starts new threads, so the engine is constructed in the worker thread's storage
+        static thread_local std::unique_ptr<Engine> engine;
+        engine = std::make_unique<Engine>(make_engine<Engine>(m_seed, thread_index));
+        return { engine.get() };
+    }
+
+private:
+    uint64_t m_seed;
+};
+
+template <typename Engine>
+class PackedModel
+{
+public:
+    explicit PackedModel(const Options& options) : m_seed(options.seed) { }
+
+    void start(unsigned threads) {
+        m_engines.clear();
+        m_engines.reserve(threads);
+        for (unsigned t = 0; t < threads; ++t) m_engines.push_back(make_engine<Engine>(m_seed, t));
+    }
+    void stop() { }
+
+    struct Local
+    {
+        Engine* engine;
+        uint64_t draw() { return draw_word(*engine); }
+    };
+    Local local(unsigned thread_index) { return { &m_engines[thread_index] }; }
+
+private:
+    uint64_t m_seed;
+    std::vector<Engine> m_engines;
+};
+
+template <typename Engine>
+class PaddedModel
+{
+public:
+    explicit PaddedModel(const Options& options) : m_seed(options.seed) { }
+
+    void start(unsigned threads) {
+        m_engines.clear();
+        m_engines.reserve(threads);
+        for (unsigned t = 0; t < threads; ++t) m_engines.emplace_back(make_engine<Engine>(m_seed, t));
+    }
+    void stop() { }
+
+    struct Local
+    {
+        Engine* engine;
+        uint64_t draw() { return draw_word(*engine); }
+    };
+    Local local(unsigned thread_index) { return { &m_engines[thread_index].engine }; }
+
+private:
+    uint64_t m_seed;
+    std::vector<Padded<Engine>> m_engines;
+};
+
+template <typename Engine>
+class PaddedLocalModel
+{
+public:
+    explicit PaddedLocalModel(const Options& options) : m_seed(options.seed) { }
+
+    void start(unsigned) { }
+    void stop() { }
+
+    struct Local
+    {
+        std::unique_ptr<Padded<Engine>> padded;
+        uint64_t draw() { return draw_word(padded->engine); }
+    };
+    Local local(unsigned thread_index) {
+        // Allocated and written by the pinned worker, so first-touch places it on its node
+        return { std::make_unique<Padded<Engine>>(make_engine<Engine>(m_seed, thread_index)) };
+    }
+
+private:
+    uint64_t m_seed;
+};
+
+template <typename Engine>
+class PerCpuModel
+{
+public:
+    explicit PerCpuModel(const Options& options) : m_seed(options.seed) { }
+
+    void start(unsigned threads) {
+        // One shard per CPU number, so that any CPU the threads migrate to has one
+        const unsigned shards = std::max(threads, std::max(1u, std::thread::hardware_concurrency()));
+        m_shards.clear();
+        for (unsigned s = 0; s < shards; ++s) {
+            m_shards.push_back(std::make_unique<Shard>(make_engine<Engine>(m_seed, s)));
+        }
+    }
+    void stop() { }
+
+    struct Local
+    {
+        PerCpuModel* model;
+        unsigned thread_index;
+        uint64_t draw() {
+            auto& shards = model->m_shards;
+            Shard& shard = *shards[current_cpu(thread_index) % shards.size()];
+            // The thread may have been preempted or migrated since reading its CPU
+            while (shard.lock.test_and_set(std::memory_order_acquire)) std::this_thread::yield();
+            const uint64_t word = draw_word(shard.engine);
+            shard.lock.clear(std::memory_order_release);
+            return word;
+        }
+    };
+    Local local(unsigned thread_index) { return { this, thread_index }; }
+
+private:
+    struct alignas(CACHE_LINE) Shard
+    {
+        explicit Shard(Engine e) : engine(std::move(e)) { }
+        std::atomic_flag lock = ATOMIC_FLAG_INIT;
+        Engine engine;
+    };
+
+    uint64_t m_seed;
+    std::vector<std::unique_ptr<Shard>> m_shards;
+};
+
+template <typename Engine>
+class CounterModel
+{
+public:
+    explicit CounterModel(const Options& options) : m_seed(options.seed) { }
+
+    void start(unsigned) { m_next.store(0, std::memory_order_relaxed); }
+    void stop() { }
+
+    struct Local
+    {
+        CounterModel* model;
+        Engine engine;      // Key of the ChaCha20 stream, unused for xoshiro
+        uint64_t draw() {
+            const uint64_t index = model->m_next.fetch_add(1, std::memory_order_relaxed);
+            return counter_word(engine, model->m_seed, index);
+        }
+    };
+    Local local(unsigned) { return { this, make_engine<Engine>(m_seed, 0) }; }
+
+private:
+    uint64_t m_seed;
+    alignas(CACHE_LINE) std::atomic<uint64_t> m_next{ 0 };
+};
+
+/**
+ * A bounded multi-producer multi-consumer ring of blocks, in the manner of Vyukov's queue: the
+ * sequence number of a slot tells whether it waits for a producer or a consumer of a given lap.
+ */
+template <typename Engine>
+class RingModel
+{
+public:
+    explicit RingModel(const Options& options) : m_seed(options.seed), m_producers(options.producers) { }
+
+    struct alignas(CACHE_LINE) Slot
+    {
+        std::atomic<uint64_t> sequence{ 0 };
+        uint64_t words[RING_BLOCK];
+    };
+
+    void start(unsigned threads) {
+        const size_t capacity = 4 * std::max<size_t>(threads, m_producers);
+        m_slots = std::vector<Slot>(capacity);
+        for (size_t i = 0; i < capacity; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        m_enqueue.store(0, std::memory_order_relaxed);
+        m_dequeue.store(0, std::memory_order_relaxed);
+        m_done.store(false, std::memory_order_relaxed);
+
+        for (unsigned p = 0; p < m_producers; ++p) {
+            m_threads.emplace_back([this, p] { produce(p); });
+        }
+    }
+
+    void stop() {
+        // Called once the consumers have joined, so every claimed block has been consumed
+        m_done.store(true, std::memory_order_relaxed);
+        for (auto& thread : m_threads) thread.join();
+        m_threads.clear();
+    }
+
+    struct Local
+    {
+        RingModel* model;
+        Slot* slot = nullptr;
+        uint64_t ticket = 0;
+        size_t used = RING_BLOCK;
+
+        uint64_t draw() {
+            if (used == RING_BLOCK) next_block();
+            return slot->words[used++];
+        }
+
+        void next_block() {
+            auto& slots = model->m_slots;
+            if (slot) slot->sequence.store(ticket + slots.size(), std::memory_order_release);
+            ticket = model->m_dequeue.fetch_add(1, std::memory_order_relaxed);
+            slot = &slots[ticket % slots.size()];
+            while (slot->sequence.load(std::memory_order_acquire) != ticket + 1) {
+                std::this_thread::yield();
+            }
+            used = 0;
+        }
+
+        ~Local() {
+            if (slot) slot->sequence.store(ticket + model->m_slots.size(), std::memory_order_release);
+        }
+        Local(RingModel* m) : model(m) { }
+        Local(Local&& other) noexcept : model(other.model), slot(other.slot), ticket(other.ticket), used(other.used) {
+            other.slot = nullptr;
+        }
+    };
+    Local local(unsigned) { return Local(this); }
+
+private:
+    void produce(unsigned producer) {
+        Engine engine = make_engine<Engine>(m_seed, (uint64_t(1) << 32) + producer);
+        for (;;) {
+            const uint64_t ticket = m_enqueue.fetch_add(1, std::memory_order_relaxed);
+            Slot& slot = m_slots[ticket % m_slots.size()];
+            while (slot.sequence.load(std::memory_order_acquire) != ticket) {
+                if (m_done.load(std::memory_order_relaxed)) return;
+                std::this_thread::yield();
+            }
+            // next() rather than fill(), which gets 8 words from each ChaCha20 block: the other
+            // models compute a block per word
+            for (size_t i = 0; i < RING_BLOCK; ++i) {
+                slot.words[i] = draw_word(engine);
+            }
+            slot.sequence.store(ticket + 1, std::memory_order_release);
+        }
+    }
+
+    uint64_t m_seed;
+    unsigned m_producers;
+    std::vector<Slot> m_slots;
+    alignas(CACHE_LINE) std::atomic<uint64_t> m_enqueue{ 0 };
+    alignas(CACHE_LINE) std::atomic<uint64_t> m_dequeue{ 0 };
+    alignas(CACHE_LINE) std::atomic<bool> m_done{ false };
+    std::vector<std::thread> m_threads;
+};
+
+// ----------------------------------------------------------------------------------------------
+// Runs
+
+struct Result
+{
+    double seconds = 0.0;
+    uint64_t draws = 0;
+    Histogram latency;      // ns per batch of BATCH draws
+};
+
+std::atomic<uint64_t> g_sink{ 0 };
+
+template <typename Model>
+Result run(Model& model, unsigned threads, const Options& options, const Topology& topology)
+{
+    model.start(threads);
+
+    std::vector<std::unique_ptr<Result>> results;
+    for (unsigned t = 0; t < threads; ++t) results.push_back(std::make_unique<Result>());
+
+    std::atomic<unsigned> ready{ 0 };
+    std::atomic<bool> go{ false }, stop{ false };
+    std::vector<std::thread> pool;
+
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            pin_thread(t, options.pin, topology);
+            auto local = model.local(t);
+            Result& result = *results[t];
+            uint64_t sink = 0;
+
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+
+            while (!stop.load(std::memory_order_relaxed)) {
+                const auto start = Clock::now();
+                for (size_t k = 0; k < BATCH; ++k) {
+                    sink ^= local.draw();
+                }
+                const auto end = Clock::now();
+                result.latency.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+                result.draws += BATCH;
+            }
+            g_sink.fetch_xor(sink, std::memory_order_relaxed);
+        });
+    }
+
+    while (ready.load() < threads) std::this_thread::yield();
+    const auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(options.duration);
+    stop.store(true, std::memory_order_relaxed);
+    for (auto& thread : pool) thread.join();
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    model.stop();
+
+    Result total;
+    total.seconds = seconds;
+    for (const auto& result : results) {
+        total.draws += result->draws;
+        total.latency.merge(result->latency);
+    }
+    return total;
+}
+
+void report(const char* engine, const char* model, unsigned threads, const Result& result, const Options& options)
+{
+    const double mwords = result.draws / result.seconds * 1e-6;
+    auto per_draw = [&](double q) { return result.latency.quantile(q) / double(BATCH); };
+
+    if (options.csv) {
+        std::printf("%s,%s,%u,%.2f,%.2f,%.2f,%.2f,%.2f\n", engine, model, threads, mwords,
+                    per_draw(0.5), per_draw(0.99), per_draw(0.999), result.latency.max() / double(BATCH));
+    } else {
+        std::printf("%-9s %-13s %7u %11.1f %11.1f %8.2f %8.2f %8.2f %9.1f\n", engine, model, threads, mwords,
+                    mwords / threads, per_draw(0.5), per_draw(0.99), per_draw(0.999), result.latency.max() / double(BATCH));
+    }
+    std::fflush(stdout);
+}
+
+template <template <typename> class Model, typename Engine>
+void sweep(const char* engine_name, const char* model_name, const std::vector<unsigned>& thread_counts,
+           const Options& options, const Topology& topology)
+{
+    for (unsigned threads : thread_counts) {
+        Model<Engine> model(options);
+        report(engine_name, model_name, threads, run(model, threads, options, topology), options);
+    }
+}
+
+template <typename Engine>
+void sweep_models(const char* engine_name, const std::string& model, const std::vector<unsigned>& thread_counts,
+                  const Options& options, const Topology& topology)
+{
+    const bool all = model == "all";
+    if (all || model == "mutex") sweep<MutexModel, Engine>(engine_name, "mutex", thread_counts, options, topology);
+    if (all || model == "thread_local") sweep<ThreadLocalModel, Engine>(engine_name, "thread_local", thread_counts, options, topology);
+    if (all || model == "packed") sweep<PackedModel, Engine>(engine_name, "packed", thread_counts, options, topology);
+    if (all || model == "padded") sweep<PaddedModel, Engine>(engine_name, "padded", thread_counts, options, topology);
+    if (all || model == "padded-local") sweep<PaddedLocalModel, Engine>(engine_name, "padded-local", thread_counts, options, topology);
+    if (all || model == "per-cpu") sweep<PerCpuModel, Engine>(engine_name, "per-cpu", thread_counts, options, topology);
+    if (all || model == "counter") sweep<CounterModel, Engine>(engine_name, "counter", thread_counts, options, topology);
+    if (all || model == "ring") sweep<RingModel, Engine>(engine_name, "ring", thread_counts, options, topology);
+}
+
+std::vector<unsigned> default_thread_counts(unsigned max_threads)
+{
+    // Powers of two, then every hardware thread
+    std::vector<unsigned> counts;
+    for (unsigned n = 1; n < max_threads; n *= 2) counts.push_back(n);
+    counts.push_back(max_threads);
+    return counts;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    std::string engine = "all", model = "all";
+    std::vector<unsigned> thread_counts;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--csv") {
+            options.csv = true;
+        } else if (arg == "--engine" && has_value) {
+            engine = argv[++i];
+            if (engine != "xoshiro" && engine != "chacha20" && engine != "all") return usage();
+        } else if (arg == "--model" && has_value) {
+            model = argv[++i];
+        } else if (arg == "--threads" && has_value) {
+            for (unsigned n : parse_cpu_list(argv[++i])) {
+                if (n > 0) thread_counts.push_back(n);
+            }
+            if (thread_counts.empty()) return usage();
+        } else if (arg == "--ms" && has_value) {
+            options.duration = std::chrono::milliseconds(std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--pin" && has_value) {
+            const std::string pin = argv[++i];
+            if (pin == "none") options.pin = Pin::None;
+            else if (pin == "compact") options.pin = Pin::Compact;
+            else if (pin == "scatter") options.pin = Pin::Scatter;
+            else return usage();
+        } else if (arg == "--producers" && has_value) {
+            options.producers = std::max(1u, static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10)));
+        } else if (arg == "--seed" && has_value) {
+            options.seed = std::strtoull(argv[++i], nullptr, 0);
+        } else {
+            return usage();
+        }
+    }
+
+    const char* models[] = { "all", "mutex", "thread_local", "packed", "padded", "padded-local", "per-cpu", "counter", "ring" };
+    if (std::find(std::begin(models), std::end(models), model) == std::end(models)) return usage();
+
+    const Topology topology = detect_topology();
+    if (thread_counts.empty()) {
+        thread_counts = default_thread_counts(static_cast<unsigned>(topology.compact.size()));
+    }
+
+    if (options.csv) {
+        std::printf("engine,model,threads,mwords_per_s,p50_ns,p99_ns,p999_ns,max_ns\n");
+    } else {
+        std::printf("%zu CPUs, %zu NUMA nodes, %lld ms per run; latencies in ns per draw over batches of %zu\n",
+                    topology.compact.size(), topology.nodes, static_cast<long long>(options.duration.count()), BATCH);
+        std::printf("%-9s %-13s %7s %11s %11s %8s %8s %8s %9s\n", "engine", "model", "threads", "Mwords/s",
+                    "per thread", "p50", "p99", "p99.9", "max");
+    }
+
+    if (engine == "xoshiro" || engine == "all") {
+        sweep_models<bpr::prng::Xoshiro256ss>("xoshiro", model, thread_counts, options, topology);
+    }
+    if (engine == "chacha20" || engine == "all") {
+        sweep_models<bpr::csprng::ChaCha20>("chacha20", model, thread_counts, options, topology);
+    }
+    return 0;
+}
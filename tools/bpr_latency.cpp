@@ -0,0 +1,519 @@
+// Measures the latency of individual draws, to choose engines by their tail rather than by their
+// average cost per word.
+//
+//   bpr_latency [--engine NAME|all] [--mode scalar|buffered|prefetched|all] [--draws N[K|M|G]]
+//               [--buffer N] [--clock tsc|mono] [--spike-ns N] [--reseed-bytes N[K|M|G]]
+//               [--cpu N] [--seed N] [--csv]
+//
+// Engines: xoshiro256ss, pcg32, xoshiro256ss-x8, chacha20, buffered-chacha20 and
+// reseeding-chacha20 (a BufferedChaCha20 reseeded by Reseeding from the getrandom() syscall).
+// Modes:
+//   scalar       one next() per draw, including the refills and checks the engine does itself
+//   buffered     draws from a buffer of --buffer words, refilled inline with fill() when empty
+//   prefetched   two buffers, one refilled with fill() by a helper thread while the other is read
+//
+// Every draw is timestamped with the TSC (x86-64 GCC/Clang) or clock_gettime(CLOCK_MONOTONIC),
+// each timestamp ending one interval and starting the next. The smallest interval measured
+// without any draw is subtracted as the timer overhead. Intervals are recorded in log-linear
+// histograms (tools/histogram.hpp) and reported as p50/p90/p99/p99.9/p99.99/max in ns.
+//
+// A draw slower than the spike threshold (--spike-ns, by default 8 times the median of a warm-up
+// run, at least 100 ns) is a spike. The report gives the spike rate, the most frequent number of
+// draws between consecutive spikes with its share of all gaps (a share near 100% is a periodic
+// refill or check, a low share is noise such as interrupts), and the median time between spikes.
+//
+// Build: c++ -std=c++17 -O2 -pthread -Iinclude tools/bpr_latency.cpp -o bpr_latency
+
+#include "histogram.hpp"
+
+#include <BPR/multilane.hpp>
+#include <BPR/generator.hpp>
+#include <BPR/chacha20.hpp>
+#include <BPR/entropy.hpp>
+#include <BPR/prng.hpp>
+
+#include <unordered_map>
+#include <algorithm>
+#include <iostream>
+#include <cstdlib>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <cstdio>
+#include <array>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#   include <x86intrin.h>
+#   define BPR_HAS_TSC 1
+#else
+#   define BPR_HAS_TSC 0
+#endif
+
+#if defined(__linux__)
+#   include <sys/random.h>
+#   include <pthread.h>
+#   include <sched.h>
+#   include <cerrno>
+#endif
+
+namespace {
+
+using bpr_tools::Histogram;
+
+constexpr size_t MAX_SPIKES = size_t(1) << 20;    // Spikes kept for the periodicity analysis
+constexpr uint64_t WARMUP_DRAWS = 1 << 16;
+
+uint64_t parse_size(const char* text)
+{
+    char* end = nullptr;
+    uint64_t value = std::strtoull(text, &end, 10);
+    switch (*end) {
+        case 'G': case 'g': value <<= 10; [[fallthrough]];
+        case 'M': case 'm': value <<= 10; [[fallthrough]];
+        case 'K': case 'k': value <<= 10; break;
+        default: break;
+    }
+    return value;
+}
+
+int usage()
+{
+    std::cerr << "usage: bpr_latency [--engine NAME|all] [--mode scalar|buffered|prefetched|all] [--draws N[K|M|G]]\n"
+                 "                   [--buffer N] [--clock tsc|mono] [--spike-ns N] [--reseed-bytes N[K|M|G]]\n"
+                 "                   [--cpu N] [--seed N] [--csv]\n"
+                 "engines: xoshiro256ss pcg32 xoshiro256ss-x8 chacha20 buffered-chacha20 reseeding-chacha20\n";
+    return 2;
+}
+
+struct Options
+{
+    uint64_t seed = 0x5eed;
+    uint64_t draws = 10'000'000;
+    size_t buffer = 256;
+    bool tsc = BPR_HAS_TSC;
+    double spike_ns = 0.0;              // Zero for automatic
+    uint64_t reseed_bytes = 1 << 20;
+    bool csv = false;
+};
+
+// ----------------------------------------------------------------------------------------------
+// Timer
+
+/**
+ * Reads the TSC or the monotonic clock, in ticks, and converts ticks to nanoseconds.
+ */
+class Timer
+{
+public:
+    explicit Timer(bool tsc) : m_tsc(tsc && BPR_HAS_TSC) {
+        if (m_tsc) {
+            // Calibrate the TSC against the monotonic clock
+            const auto start = std::chrono::steady_clock::now();
+            const uint64_t ticks = now();
+            while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(100)) { }
+            const uint64_t elapsed = now() - ticks;
+            m_ns_per_tick = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / elapsed;
+        }
+
+        // Smallest interval between two consecutive reads
+        m_overhead = UINT64_MAX;
+        uint64_t last = now();
+        for (int i = 0; i < 100000; ++i) {
+            const uint64_t t = now();
+            m_overhead = std::min(m_overhead, t - last);
+            last = t;
+        }
+    }
+
+    uint64_t now() const noexcept {
+#if BPR_HAS_TSC
+        if (m_tsc) return __rdtsc();
+#endif
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    const char* name() const noexcept { return m_tsc ? "tsc" : "mono"; }
+    double ns(uint64_t ticks) const noexcept { return ticks * m_ns_per_tick; }
+    uint64_t ticks(double ns) const noexcept { return static_cast<uint64_t>(ns / m_ns_per_tick); }
+    uint64_t overhead() const noexcept { return m_overhead; }
+
+private:
+    bool m_tsc;
+    double m_ns_per_tick = 1.0;
+    uint64_t m_overhead = 0;
+};
+
+// ----------------------------------------------------------------------------------------------
+// Engines and modes
+
+/**
+ * Entropy source of `Reseeding` that makes a getrandom() system call, like a kernel-seeded DRBG.
+ */
+class SyscallEntropy
+{
+public:
+    bool try_read(uint64_t* out, size_t count, unsigned) noexcept {
+#if defined(__linux__)
+        char* data = reinterpret_cast<char*>(out);
+        size_t bytes = count * sizeof(uint64_t);
+        while (bytes > 0) {
+            const ssize_t n = getrandom(data, bytes, 0);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            data += n;
+            bytes -= static_cast<size_t>(n);
+        }
+        return true;
+#else
+        try {
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = (static_cast<uint64_t>(m_device()) << 32) | m_device();
+            }
+            return true;
+        } catch (...) {
+            return false;
+        }
+#endif
+    }
+
+private:
+#if !defined(__linux__)
+    std::random_device m_device;
+#endif
+};
+
+std::array<uint32_t, 8> make_key(uint64_t seed)
+{
+    std::array<uint32_t, 8> key;
+    for (size_t i = 0; i < key.size(); ++i) {
+        key[i] = static_cast<uint32_t>(bpr::splitmix64_at(seed, i));
+    }
+    return key;
+}
+
+/**
+ * Draws a word without virtual dispatch, as code holding the concrete engine type does.
+ */
+template <typename Engine>
+inline uint64_t draw_word(Engine& engine)
+{
+    return engine.Engine::next();
+}
+
+/**
+ * Draws from a buffer refilled inline by the bulk path when empty.
+ */
+template <typename Engine>
+class Buffered
+{
+public:
+    Buffered(Engine& engine, size_t size) : m_engine(engine), m_buffer(size), m_used(size) { }
+
+    uint64_t next() {
+        if (m_used == m_buffer.size()) {
+            bpr::fill(m_engine, m_buffer.data(), m_buffer.size());
+            m_used = 0;
+        }
+        return m_buffer[m_used++];
+    }
+
+private:
+    Engine& m_engine;
+    std::vector<uint64_t> m_buffer;
+    size_t m_used;
+};
+
+/**
+ * Draws from one of two buffers while a helper thread refills the other one.
+ */
+template <typename Engine>
+class Prefetched
+{
+public:
+    Prefetched(Engine& engine, size_t size) : m_engine(engine) {
+        for (auto& slot : m_slots) {
+            slot.words.resize(size);
+            slot.full.store(false, std::memory_order_relaxed);
+        }
+        m_helper = std::thread([this] { refill(); });
+    }
+
+    ~Prefetched() {
+        m_stop.store(true, std::memory_order_relaxed);
+        m_helper.join();
+    }
+
+    uint64_t next() {
+        if (!m_slot || m_used == m_slot->words.size()) {
+            if (m_slot) {
+                m_slot->full.store(false, std::memory_order_release);
+                m_current ^= 1;
+            }
+            m_slot = &m_slots[m_current];
+            // Spin first, the helper is normally ahead; yield if it shares this CPU
+            for (unsigned spins = 0; !m_slot->full.load(std::memory_order_acquire); ++spins) {
+                if (spins > 1024) std::this_thread::yield();
+            }
+            m_used = 0;
+        }
+        return m_slot->words[m_used++];
+    }
+
+private:
+    struct alignas(128) Slot
+    {
+        std::vector<uint64_t> words;
+        std::atomic<bool> full{ false };
+    };
+
+    void refill() {
+        for (size_t i = 0; ; i ^= 1) {
+            Slot& slot = m_slots[i];
+            while (slot.full.load(std::memory_order_acquire)) {
+                if (m_stop.load(std::memory_order_relaxed)) return;
+                std::this_thread::yield();
+            }
+            bpr::fill(m_engine, slot.words.data(), slot.words.size());
+            slot.full.store(true, std::memory_order_release);
+        }
+    }
+
+    Engine& m_engine;
+    Slot m_slots[2];
+    Slot* m_slot = nullptr;
+    size_t m_current = 0;
+    size_t m_used = 0;
+    std::atomic<bool> m_stop{ false };
+    std::thread m_helper;
+};
+
+// ----------------------------------------------------------------------------------------------
+// Measurement
+
+struct Report
+{
+    Histogram latency;                  // Ticks per draw, overhead subtracted
+    std::vector<uint64_t> spike_draws;  // Index of the draws above the threshold
+    std::vector<uint64_t> spike_ticks;  // and their timestamps
+    uint64_t spikes = 0;
+    uint64_t threshold = 0;
+};
+
+uint64_t g_sink = 0;
+
+/**
+ * Times `draws` calls to `draw()`; spikes are the draws of at least `threshold` ticks.
+ */
+template <typename Draw>
+Report measure(Draw& draw, uint64_t draws, uint64_t threshold, const Timer& timer)
+{
+    Report report;
+    report.threshold = threshold;
+    report.spike_draws.reserve(MAX_SPIKES);
+    report.spike_ticks.reserve(MAX_SPIKES);
+    const uint64_t overhead = timer.overhead();
+    uint64_t sink = 0;
+
+    uint64_t last = timer.now();
+    for (uint64_t i = 0; i < draws; ++i) {
+        sink ^= draw();
+        const uint64_t t = timer.now();
+        const uint64_t elapsed = t - last > overhead ? t - last - overhead : 0;
+        last = t;
+
+        report.latency.record(elapsed);
+        if (elapsed >= threshold) {
+            ++report.spikes;
+            if (report.spike_draws.size() < MAX_SPIKES) {
+                report.spike_draws.push_back(i);
+                report.spike_ticks.push_back(t);
+            }
+        }
+    }
+    g_sink ^= sink;
+    return report;
+}
+
+/**
+ * The most frequent gap between consecutive spikes, in draws, and the fraction of gaps equal to it.
+ */
+std::pair<uint64_t, double> dominant_period(const std::vector<uint64_t>& spike_draws)
+{
+    if (spike_draws.size() < 3) return { 0, 0.0 };
+    std::unordered_map<uint64_t, uint64_t> gaps;
+    for (size_t i = 1; i < spike_draws.size(); ++i) {
+        ++gaps[spike_draws[i] - spike_draws[i - 1]];
+    }
+    const auto best = std::max_element(gaps.begin(), gaps.end(),
+        [](const auto& a, const auto& b) { return a.second < b.second || (a.second == b.second && a.first > b.first); });
+    return { best->first, double(best->second) / double(spike_draws.size() - 1) };
+}
+
+double median_gap_ns(const std::vector<uint64_t>& spike_ticks, const Timer& timer)
+{
+    if (spike_ticks.size() < 2) return 0.0;
+    std::vector<uint64_t> gaps;
+    gaps.reserve(spike_ticks.size() - 1);
+    for (size_t i = 1; i < spike_ticks.size(); ++i) {
+        gaps.push_back(spike_ticks[i] - spike_ticks[i - 1]);
+    }
+    std::nth_element(gaps.begin(), gaps.begin() + gaps.size() / 2, gaps.end());
+    return timer.ns(gaps[gaps.size() / 2]);
+}
+
+void print_header(const Options& options, const Timer& timer)
+{
+    if (options.csv) {
+        std::printf("engine,mode,draws,p50_ns,p90_ns,p99_ns,p999_ns,p9999_ns,max_ns,spike_ns,spikes_per_million,period_draws,period_share,spike_gap_us\n");
+        return;
+    }
+    std::printf("clock %s, %.3f ns per tick, %.1f ns overhead subtracted; latencies in ns\n",
+                timer.name(), timer.ns(1), timer.ns(timer.overhead()));
+    std::printf("%-19s %-10s %7s %7s %7s %8s %8s %9s %8s %9s %8s %6s %9s\n", "engine", "mode", "p50", "p90", "p99",
+                "p99.9", "p99.99", "max", "spike>", "spikes/M", "period", "share", "gap us");
+}
+
+void print_report(const char* engine, const char* mode, uint64_t draws, const Report& report,
+                  const Options& options, const Timer& timer)
+{
+    const auto [period, share] = dominant_period(report.spike_draws);
+    const double gap_us = median_gap_ns(report.spike_ticks, timer) * 1e-3;
+    const double per_million = report.spikes * 1e6 / double(draws);
+    auto q = [&](double p) { return timer.ns(report.latency.quantile(p)); };
+
+    if (options.csv) {
+        std::printf("%s,%s,%llu,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.2f,%llu,%.3f,%.2f\n", engine, mode,
+                    static_cast<unsigned long long>(draws), q(0.5), q(0.9), q(0.99), q(0.999), q(0.9999),
+                    timer.ns(report.latency.max()), timer.ns(report.threshold), per_million,
+                    static_cast<unsigned long long>(period), share, gap_us);
+    } else {
+        std::printf("%-19s %-10s %7.1f %7.1f %7.1f %8.1f %8.1f %9.0f %8.0f %9.1f %8llu %5.0f%% %9.2f\n", engine, mode,
+                    q(0.5), q(0.9), q(0.99), q(0.999), q(0.9999), timer.ns(report.latency.max()),
+                    timer.ns(report.threshold), per_million, static_cast<unsigned long long>(period), share * 100, gap_us);
+    }
+    std::fflush(stdout);
+}
+
+/**
+ * Measures one engine in one mode: a warm-up run sets the spike threshold, then the measured run.
+ */
+template <typename Draw>
+void run(const char* engine, const char* mode, Draw& draw, const Options& options, const Timer& timer)
+{
+    uint64_t threshold = timer.ticks(options.spike_ns);
+    const Report warmup = measure(draw, WARMUP_DRAWS, UINT64_MAX, timer);
+    if (options.spike_ns <= 0.0) {
+        threshold = std::max(8 * warmup.latency.quantile(0.5), timer.ticks(100.0));
+    }
+    print_report(engine, mode, options.draws, measure(draw, options.draws, threshold, timer), options, timer);
+}
+
+template <typename Factory>
+void run_engine(const char* engine, Factory&& make, const std::string& mode, const Options& options, const Timer& timer)
+{
+    if (mode == "scalar" || mode == "all") {
+        auto e = make();
+        auto draw = [&] { return draw_word(e); };
+        run(engine, "scalar", draw, options, timer);
+    }
+    if (mode == "buffered" || mode == "all") {
+        auto e = make();
+        Buffered<decltype(e)> buffered(e, options.buffer);
+        auto draw = [&] { return buffered.next(); };
+        run(engine, "buffered", draw, options, timer);
+    }
+    if (mode == "prefetched" || mode == "all") {
+        auto e = make();
+        Prefetched<decltype(e)> prefetched(e, options.buffer);
+        auto draw = [&] { return prefetched.next(); };
+        run(engine, "prefetched", draw, options, timer);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    std::string engine = "all", mode = "all", clock = "tsc";
+    int cpu = -1;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--csv") {
+            options.csv = true;
+        } else if (arg == "--engine" && has_value) {
+            engine = argv[++i];
+        } else if (arg == "--mode" && has_value) {
+            mode = argv[++i];
+            if (mode != "scalar" && mode != "buffered" && mode != "prefetched" && mode != "all") return usage();
+        } else if (arg == "--draws" && has_value) {
+            options.draws = parse_size(argv[++i]);
+        } else if (arg == "--buffer" && has_value) {
+            options.buffer = std::max<size_t>(1, static_cast<size_t>(parse_size(argv[++i])));
+        } else if (arg == "--clock" && has_value) {
+            clock = argv[++i];
+            if (clock != "tsc" && clock != "mono") return usage();
+            options.tsc = clock == "tsc";
+        } else if (arg == "--spike-ns" && has_value) {
+            options.spike_ns = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--reseed-bytes" && has_value) {
+            options.reseed_bytes = parse_size(argv[++i]);
+        } else if (arg == "--cpu" && has_value) {
+            cpu = std::atoi(argv[++i]);
+        } else if (arg == "--seed" && has_value) {
+            options.seed = std::strtoull(argv[++i], nullptr, 0);
+        } else {
+            return usage();
+        }
+    }
+
+    const char* engines[] = { "all", "xoshiro256ss", "pcg32", "xoshiro256ss-x8", "chacha20", "buffered-chacha20", "reseeding-chacha20" };
+    if (std::find(std::begin(engines), std::end(engines), engine) == std::end(engines)) return usage();
+
+#if defined(__linux__)
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+#else
+    (void)cpu;
+#endif
+
+    const Timer timer(options.tsc);
+    print_header(options, timer);
+
+    const uint64_t seed = options.seed;
+    const bool all = engine == "all";
+    if (all || engine == "xoshiro256ss") {
+        run_engine("xoshiro256ss", [&] { return bpr::prng::Xoshiro256ss(seed); }, mode, options, timer);
+    }
+    if (all || engine == "pcg32") {
+        run_engine("pcg32", [&] { return bpr::prng::PCG32(seed); }, mode, options, timer);
+    }
+    if (all || engine == "xoshiro256ss-x8") {
+        run_engine("xoshiro256ss-x8", [&] { return bpr::prng::Xoshiro256ssX8(seed); }, mode, options, timer);
+    }
+    if (all || engine == "chacha20") {
+        run_engine("chacha20", [&] { return bpr::csprng::ChaCha20(make_key(seed), { 0, 0 }); }, mode, options, timer);
+    }
+    if (all || engine == "buffered-chacha20") {
+        run_engine("buffered-chacha20", [&] { return bpr::csprng::BufferedChaCha20(make_key(seed)); }, mode, options, timer);
+    }
+    if (all || engine == "reseeding-chacha20") {
+        const bpr::ReseedPolicy policy{ options.reseed_bytes, std::chrono::seconds(1) };
+        run_engine("reseeding-chacha20", [&] {
+            return bpr::Reseeding<bpr::csprng::BufferedChaCha20, SyscallEntropy>(policy, make_key(seed));
+        }, mode, options, timer);
+    }
+    return 0;
+}
@@ -0,0 +1,69 @@
+// Local random-bytes service: serves each connected process from its own shared-memory ring.
+//
+//   bpr_randd [--socket <path>] [--ring-size N[K|M]]
+//
+// Clients use bpr::randd::Client from <BPR/randd.hpp>. Linux only.
+//
+// Build: c++ -std=c++17 -O2 -pthread -Iinclude tools/bpr_randd.cpp -o bpr_randd
+
+#include <BPR/randd.hpp>
+
+#include <iostream>
+#include <csignal>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+bpr::randd::Server* g_server = nullptr;
+
+void on_signal(int)
+{
+    if (g_server) g_server->stop();
+}
+
+size_t parse_size(const char* text)
+{
+    char* end = nullptr;
+    size_t value = std::strtoull(text, &end, 10);
+    if (*end == 'M' || *end == 'm') value <<= 20;
+    else if (*end == 'K' || *end == 'k') value <<= 10;
+    return value;
+}
+
+int usage()
+{
+    std::cerr << "usage: bpr_randd [--socket <path>] [--ring-size N[K|M]]\n";
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string socket_path = bpr::randd::default_socket_path();
+    size_t ring_size = 1 << 20;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if (arg == "--ring-size" && i + 1 < argc) {
+            ring_size = parse_size(argv[++i]);
+        } else {
+            return usage();
+        }
+    }
+
+    try {
+        bpr::randd::Server server(socket_path, ring_size);
+        g_server = &server;
+        std::signal(SIGINT, on_signal);
+        std::signal(SIGTERM, on_signal);
+        server.run();
+        g_server = nullptr;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,261 @@
+// Checks that every SIMD backend supported by this host reproduces the scalar reference streams
+// bit for bit, and prints a digest of the streams to compare between hosts.
+//
+//   bpr_verify [--words N[K|M|G]] [--seed N]
+//
+// Each stream is generated through `fill()` in chunks of varying sizes, interleaved with calls to
+// `next()`, and compared with `Xoshiro256ss::next()` and `ChaCha20::next512()`. The digests
+// depend only on the seed and the number of words: hosts that print the same digests generate
+// the same streams. It also checks that TPDF dither to 24 bits is unbiased near full scale.
+// Exits with status 1 if any check fails.
+//
+// Build: c++ -std=c++17 -O2 -Iinclude tools/bpr_verify.cpp -o bpr_verify
+
+#include <BPR/reproducible.hpp>
+#include <BPR/multilane.hpp>
+#include <BPR/chacha20.hpp>
+#include <BPR/noise.hpp>
+#include <BPR/prng.hpp>
+#include <BPR/simd.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <array>
+
+namespace {
+
+constexpr size_t CHUNK = 1 << 16;
+
+uint64_t parse_size(const char* text)
+{
+    char* end = nullptr;
+    uint64_t value = std::strtoull(text, &end, 10);
+    switch (*end) {
+        case 'G': case 'g': value <<= 10; [[fallthrough]];
+        case 'M': case 'm': value <<= 10; [[fallthrough]];
+        case 'K': case 'k': value <<= 10; break;
+        default: break;
+    }
+    return value;
+}
+
+int usage()
+{
+    std::cerr << "usage: bpr_verify [--words N[K|M|G]] [--seed N]\n";
+    return 2;
+}
+
+/**
+ * Result of one stream on one backend.
+ */
+struct Check
+{
+    bool ok = true;
+    uint64_t mismatch = 0;      // Index of the first differing word
+    uint64_t digest = 0;
+    double seconds = 0.0;       // Time spent in the engine under test
+};
+
+uint64_t mix(uint64_t digest, uint64_t word)
+{
+    return bpr::splitmix64(digest ^ word);
+}
+
+/**
+ * Generates `words` words with `fill(engine, ...)`, in chunks whose sizes are drawn from
+ * `sizes`, and compares them with `reference(out, n)`. `granularity` rounds the chunk sizes
+ * (ChaCha20 discards the rest of a partial block).
+ */
+template <typename Engine, typename Reference>
+Check run(Engine& engine, Reference&& reference, uint64_t words, uint64_t seed, size_t granularity)
+{
+    std::vector<uint64_t> out(CHUNK), expected(CHUNK);
+    bpr::prng::Xoshiro256ss sizes(seed);
+    Check check;
+
+    for (uint64_t done = 0; done < words && check.ok; ) {
+        size_t n = static_cast<size_t>(bpr::bounded(sizes, CHUNK) + 1);
+        n = std::max(granularity, n / granularity * granularity);
+        n = static_cast<size_t>(std::min<uint64_t>(n, words - done));
+
+        const auto start = std::chrono::steady_clock::now();
+        bpr::fill(engine, out.data(), n);
+        check.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        reference(expected.data(), n);
+        for (size_t k = 0; k < n; ++k) {
+            check.digest = mix(check.digest, out[k]);
+            if (out[k] != expected[k] && check.ok) {
+                check.ok = false;
+                check.mismatch = done + k;
+            }
+        }
+        done += n;
+    }
+    return check;
+}
+
+Check check_xoshiro(uint64_t seed, uint64_t words)
+{
+    bpr::prng::Xoshiro256ssX8 engine(seed);
+    std::vector<bpr::prng::Xoshiro256ss> lanes;
+    for (size_t l = 0; l < bpr::prng::Xoshiro256ssX8::LANES; ++l) {
+        lanes.emplace_back(bpr::stream_seed(seed, l));
+    }
+
+    // Position of the next word in the round-robin over the lanes
+    size_t lane = 0;
+    return run(engine, [&](uint64_t* expected, size_t n) {
+        for (size_t k = 0; k < n; ++k) {
+            expected[k] = lanes[lane].next();
+            lane = (lane + 1) % lanes.size();
+        }
+    }, words, seed, 1);
+}
+
+Check check_chacha20(uint64_t seed, uint64_t words)
+{
+    std::array<uint32_t, 8> key;
+    for (size_t i = 0; i < key.size(); ++i) {
+        key[i] = static_cast<uint32_t>(bpr::splitmix64_at(seed, i));
+    }
+    const std::array<uint32_t, 2> nonce = { static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32) };
+
+    bpr::csprng::ChaCha20 engine(key, nonce), reference(key, nonce);
+    return run(engine, [&](uint64_t* expected, size_t n) {
+        for (size_t k = 0; k < n; k += 8) {
+            const std::array<uint32_t, 16> block = reference.next512();
+            for (size_t j = 0; j < 8; ++j) {
+                expected[k + j] = static_cast<uint64_t>(block[2 * j]) | (static_cast<uint64_t>(block[2 * j + 1]) << 32);
+            }
+        }
+    }, words, seed, 8);
+}
+
+Check check_normal(uint64_t seed, uint64_t words)
+{
+    // Bulk reproducible normals over the multi-lane stream, against the scalar mapping of each word
+    bpr::prng::Xoshiro256ssX8 engine(seed), reference(seed);
+    std::vector<double> values(CHUNK);
+    std::vector<uint64_t> raw(CHUNK);
+    Check check;
+
+    for (uint64_t done = 0; done < words && check.ok; done += CHUNK) {
+        const size_t n = static_cast<size_t>(std::min<uint64_t>(CHUNK, words - done));
+        const auto start = std::chrono::steady_clock::now();
+        bpr::repro::fill_normal(engine, values.data(), n);
+        check.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        bpr::fill(reference, raw.data(), n);
+        for (size_t k = 0; k < n; ++k) {
+            uint64_t bits, expected;
+            const double z = bpr::repro::to_normal(raw[k]);
+            std::memcpy(&bits, &values[k], sizeof(bits));
+            std::memcpy(&expected, &z, sizeof(expected));
+            check.digest = mix(check.digest, bits);
+            if (bits != expected && check.ok) {
+                check.ok = false;
+                check.mismatch = done + k;
+            }
+        }
+    }
+    return check;
+}
+
+/**
+ * Dithers a constant signal to 24 bits and returns the mean error, in LSB, of the output
+ * against the exact scaled input. TPDF dither makes it zero whatever the level; rounding in
+ * float near full scale (where half an LSB is one ulp) biases it by up to half an LSB.
+ */
+double dither_bias(double level, uint64_t seed)
+{
+    constexpr size_t COUNT = 1 << 20;
+    const std::vector<float> in(COUNT, static_cast<float>(level / 8388607.0));
+    std::vector<bpr::int24> out(COUNT);
+    bpr::prng::Xoshiro256ss engine(seed);
+    bpr::tpdf_dither(engine, in.data(), out.data(), COUNT);
+
+    double sum = 0.0;
+    for (const bpr::int24& sample : out) {
+        const uint32_t bits = sample.bytes[0] | (sample.bytes[1] << 8) | (static_cast<uint32_t>(sample.bytes[2]) << 16);
+        sum += static_cast<int32_t>(bits << 8) >> 8;
+    }
+    return sum / COUNT - static_cast<double>(in[0]) * 8388607.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    uint64_t words = uint64_t(1) << 30;
+    uint64_t seed = 0x5eed;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--words" && has_value) {
+            words = parse_size(argv[++i]);
+        } else if (arg == "--seed" && has_value) {
+            seed = std::strtoull(argv[++i], nullptr, 0);
+        } else {
+            return usage();
+        }
+    }
+
+    using bpr::simd::Backend;
+    struct Stream
+    {
+        const char* name;
+        Check (*check)(uint64_t, uint64_t);
+        uint64_t digest;
+        bool first;
+    };
+    Stream streams[] = {
+        { "xoshiro256ss-x8", check_xoshiro, 0, true },
+        { "chacha20", check_chacha20, 0, true },
+        { "repro-normal", check_normal, 0, true },
+    };
+
+    std::cout << "seed " << seed << ", " << words << " words per stream, best backend "
+              << bpr::simd::name(bpr::simd::best_backend()) << '\n';
+
+    bool ok = true;
+    for (Backend backend : { Backend::Generic, Backend::SSE2, Backend::AVX2, Backend::AVX512 }) {
+        if (!bpr::simd::set_backend(backend)) {
+            std::printf("%-8s unsupported\n", bpr::simd::name(backend));
+            continue;
+        }
+        for (Stream& stream : streams) {
+            const Check check = stream.check(seed, words);
+            const bool same_digest = stream.first || check.digest == stream.digest;
+            std::printf("%-8s %-16s %s  %8.1f Mwords/s\n", bpr::simd::name(backend), stream.name,
+                        check.ok && same_digest ? "ok" : "MISMATCH", words / check.seconds * 1e-6);
+            if (!check.ok) {
+                std::printf("         first differing word: %llu\n", static_cast<unsigned long long>(check.mismatch));
+            }
+            ok = ok && check.ok && same_digest;
+            stream.digest = check.digest;
+            stream.first = false;
+        }
+    }
+
+    for (const Stream& stream : streams) {
+        std::printf("digest %-16s %016llx\n", stream.name, static_cast<unsigned long long>(stream.digest));
+    }
+
+    // The standard error of the mean over 2^20 samples is below 0.001 LSB
+    for (double level : { 6000000.28, 8000000.05, 8388000.5, -8388000.5, 1000.3 }) {
+        const double bias = dither_bias(level, seed);
+        const bool unbiased = std::abs(bias) < 0.01;
+        std::printf("tpdf-dither int24 at %11.2f LSB: mean error %+.4f LSB %s\n", level, bias, unbiased ? "ok" : "BIASED");
+        ok = ok && unbiased;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+// Log-linear latency histogram shared by the benchmark tools, in the manner of HdrHistogram.
+//
+// Values below 64 are counted exactly; above, each power of two is split into 32 buckets, so a
+// recorded value is known within 1/32 (about 3%) whatever its magnitude. Recording is a few
+// instructions and the histogram has a fixed size, so one can be kept per thread and merged.
+
+#ifndef BPR_TOOLS_HISTOGRAM_HPP
+#define BPR_TOOLS_HISTOGRAM_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace bpr_tools {
+
+class Histogram
+{
+public:
+    static constexpr int SUB_BITS = 5;
+    static constexpr uint64_t SUB_COUNT = uint64_t(1) << SUB_BITS;
+    static constexpr size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_COUNT;
+
+    void record(uint64_t value, uint64_t count = 1) noexcept {
+        m_counts[index(value)] += count;
+        m_total += count;
+        if (value > m_max) m_max = value;
+    }
+
+    void merge(const Histogram& other) noexcept {
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            m_counts[i] += other.m_counts[i];
+        }
+        m_total += other.m_total;
+        if (other.m_max > m_max) m_max = other.m_max;
+    }
+
+    uint64_t total() const noexcept { return m_total; }
+    uint64_t max() const noexcept { return m_max; }
+
+    /**
+     * Returns the smallest recorded value `v` such that a fraction `q` of the values is at most
+     * `v`, rounded up to the end of its bucket. Returns 0 if the histogram is empty.
+     */
+    uint64_t quantile(double q) const noexcept {
+        if (m_total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(m_total));
+        if (rank < 1) rank = 1;
+        if (rank > m_total) rank = m_total;
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            seen += m_counts[i];
+            if (seen >= rank) {
+                const uint64_t upper = i + 1 < BUCKETS ? lower_bound(i + 1) - 1 : UINT64_MAX;
+                return upper < m_max ? upper : m_max;
+            }
+        }
+        return m_max;
+    }
+
+    /**
+     * Returns the number of recorded values that are at least `value` (within a bucket).
+     */
+    uint64_t count_above(uint64_t value) const noexcept {
+        uint64_t count = 0;
+        for (size_t i = index(value); i < BUCKETS; ++i) {
+            count += m_counts[i];
+        }
+        return count;
+    }
+
+    static size_t index(uint64_t value) noexcept {
+        if (value < 2 * SUB_COUNT) return static_cast<size_t>(value);
+        const int shift = msb(value) - SUB_BITS;
+        return static_cast<size_t>((shift + 1) * SUB_COUNT + ((value >> shift) - SUB_COUNT));
+    }
+
+    static uint64_t lower_bound(size_t index) noexcept {
+        if (index < 2 * SUB_COUNT) return index;
+        const size_t shift = index / SUB_COUNT - 1;
+        return (index % SUB_COUNT + SUB_COUNT) << shift;
+    }
+
+private:
+    static int msb(uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(value);
+#else
+        int bit = 0;
+        while (value >>= 1) ++bit;
+        return bit;
+#endif
+    }
+
+private:
+    std::array<uint64_t, BUCKETS> m_counts{};
+    uint64_t m_total = 0;
+    uint64_t m_max = 0;
+};
+
+} // namespace bpr_tools
+
+#endif // BPR_TOOLS_HISTOGRAM_HPP